@@ -33,6 +33,7 @@
 #include "wx/string.h"
 
 // forward declarations
+class ActionWorker;
 class Tracer;
 class wxWindow;
 
@@ -148,6 +149,80 @@ public:
   virtual bool
   Prepare();
 
+  /**
+   * Computational part of the preparation, e.g. scanning
+   * the working copy for the files a dialog in @ref Prepare
+   * offers. Start it from @ref Prepare with
+   * @ref StartPrepareInBackground.
+   *
+   * This runs in the thread of the worker while @ref Prepare
+   * shows the dialog, so don't touch any window in here.
+   * Send the results to @ref GetPrepareReceiver using
+   * @ref ActionEvent with TOKEN_PREPARE_PROGRESS instead.
+   * Stop early if @ref IsPrepareCancelled.
+   *
+   * If any error occurs, an exception will be thrown.
+   */
+  virtual void
+  PrepareInBackground();
+
+  /**
+   * Starts @ref PrepareInBackground. When it is done,
+   * @a receiver gets TOKEN_PREPARE_DONE. The string of
+   * this event contains the error message, if any.
+   *
+   * @ref WaitPrepareInBackground has to be called before
+   * @a receiver is destroyed.
+   *
+   * @param receiver window that receives the results
+   */
+  void
+  StartPrepareInBackground(wxWindow * receiver);
+
+  /**
+   * Waits until @ref PrepareInBackground is done and
+   * delivers the remaining events to the receiver.
+   * Does nothing if it wasn't started.
+   *
+   * Pending events are handled while waiting, so
+   * prompts of the running svn calls still work.
+   * After cancelling, prompts fail without asking.
+   *
+   * @param cancel stop the work, the results aren't
+   *               needed anymore
+   */
+  void
+  WaitPrepareInBackground(bool cancel);
+
+  /**
+   * Runs @ref PrepareInBackground and notifies the
+   * receiver. Called by the worker.
+   */
+  void
+  RunPrepareInBackground();
+
+  /**
+   * @return the window that receives the results of
+   *         @ref PrepareInBackground
+   */
+  wxWindow *
+  GetPrepareReceiver();
+
+  /**
+   * @return true if @ref PrepareInBackground should stop
+   */
+  bool
+  IsPrepareCancelled() const;
+
+  /**
+   * sets the worker that runs this action, see
+   * @ref StartPrepareInBackground
+   *
+   * @param worker
+   */
+  void
+  SetWorker(ActionWorker * worker);
+
 
   /**
    * perform action. if any error occurs, an exception
@@ -248,6 +323,23 @@ public:
     const svn::Path & path,
     const svn::Revision & revision = svn::Revision::HEAD);
 
+  /**
+   * retrieves the BASE revision of the working copy
+   * file @a path without contacting the repository.
+   *
+   * If possible the pristine text-base of the working
+   * copy is used directly. Translated copies (keywords,
+   * eol-style) are cached per checksum, so repeated calls
+   * for an unchanged BASE won't copy the file again.
+   *
+   * For URLs or files without text-base this falls back to
+   * @ref GetPathAsTempFile
+   *
+   * @return filename of the read-only BASE file
+   */
+  svn::Path
+  GetBaseFile(const svn::Path & path);
+
 private:
   struct Data;
   // this structure contains implementation specific data
@@ -0,0 +1,239 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _ACTION_STATISTICS_H_INCLUDED_
+#define _ACTION_STATISTICS_H_INCLUDED_
+
+// stl
+#include "svncpp/vector_wrapper.hpp"
+
+// wxWidgets
+#include "wx/datetime.h"
+#include "wx/longlong.h"
+#include "wx/string.h"
+
+// svncpp
+#include "svncpp/context.hpp"
+
+/**
+ * Timing and resource usage of a single action.
+ */
+struct ActionStatistics
+{
+  /** name of the action */
+  wxString name;
+
+  /** when the action was started */
+  wxDateTime start;
+
+  /** did the action succeed? */
+  bool success;
+
+  /** total time from Prepare to the end of Perform */
+  long wallMs;
+
+  /**
+   * time spent in the GUI thread. This includes the
+   * dialogs shown while the action is prepared.
+   */
+  long guiMs;
+
+  /** time spent in the worker thread */
+  long workerMs;
+
+  /** calls, bytes and notifications counted by the context */
+  svn::ContextStatistics context;
+
+  /** number of pools created while the action ran */
+  size_t poolsCreated;
+
+  /** peak resident memory of the process in kB, 0 if unknown */
+  long peakMemoryKb;
+
+  ActionStatistics();
+
+  /**
+   * @return a one line summary suitable for the log window
+   */
+  wxString
+  Format() const;
+};
+
+typedef std::vector<ActionStatistics> ActionStatisticsList;
+
+/**
+ * A period in which the GUI thread did not process
+ * any events, see @a StallWatchdog
+ */
+struct StallStatistics
+{
+  /** when the GUI thread stopped responding */
+  wxDateTime start;
+
+  /** how long it did not respond */
+  long durationMs;
+
+  /** the event handlers and actions that were running */
+  wxString location;
+
+  StallStatistics();
+
+  /**
+   * @return a one line summary suitable for the log window
+   */
+  wxString
+  Format() const;
+};
+
+typedef std::vector<StallStatistics> StallStatisticsList;
+
+/**
+ * Measures one action. The workers call @a Start before
+ * @a Action::Prepare, add the time spent in each thread and
+ * call @a Finish when the action is done. The result is
+ * added to @a TheActionStatistics.
+ */
+class ActionMeasurement
+{
+public:
+  ActionMeasurement();
+
+  /**
+   * starts measuring a new action and resets the
+   * statistics of @a context
+   *
+   * @param name name of the action
+   * @param context context the action uses, may be 0
+   */
+  void
+  Start(const wxString & name, svn::Context * context);
+
+  /**
+   * starts timing a phase of the action
+   */
+  void
+  BeginPhase();
+
+  /**
+   * stops timing the phase started with @a BeginPhase
+   *
+   * @param gui was the phase run in the GUI thread?
+   */
+  void
+  EndPhase(bool gui);
+
+  /**
+   * finishes the measurement and records it
+   *
+   * @param success did the action succeed?
+   * @return the recorded statistics
+   */
+  ActionStatistics
+  Finish(bool success);
+
+private:
+  ActionStatistics m_statistics;
+  svn::Context * m_context;
+  wxLongLong m_start;
+  wxLongLong m_phaseStart;
+  size_t m_pools;
+};
+
+/**
+ * Keeps the statistics of the most recent actions and
+ * GUI stalls. All the methods may be called from any thread.
+ */
+class ActionStatisticsLog
+{
+public:
+  ActionStatisticsLog();
+
+  virtual ~ActionStatisticsLog();
+
+  /**
+   * adds the statistics of a finished action. If there
+   * are too many entries the oldest one is dropped.
+   */
+  void
+  Add(const ActionStatistics & statistics);
+
+  /**
+   * @return a copy of the recorded statistics, oldest first
+   */
+  ActionStatisticsList
+  Get() const;
+
+  /**
+   * adds a GUI stall. If there are too many
+   * the oldest one is dropped.
+   */
+  void
+  AddStall(const StallStatistics & stall);
+
+  /**
+   * @return a copy of the recorded stalls, oldest first
+   */
+  StallStatisticsList
+  GetStalls() const;
+
+  /**
+   * removes all the recorded statistics and stalls
+   */
+  void
+  Clear();
+
+  /**
+   * Writes the recorded statistics and stalls to @a fileName.
+   * Files ending with ".csv" are written as comma separated values
+   * (the stalls in a table of their own after an empty line), all
+   * others as JSON.
+   *
+   * @retval true file written
+   */
+  bool
+  Export(const wxString & fileName) const;
+
+private:
+  struct Data;
+  Data * m;
+
+  /** disallow copy constructor */
+  ActionStatisticsLog(const ActionStatisticsLog &);
+
+  /** disallow assignment operator */
+  ActionStatisticsLog & operator = (const ActionStatisticsLog &);
+};
+
+/**
+ * This is the singleton instance of the statistics log
+ */
+extern ActionStatisticsLog TheActionStatistics;
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
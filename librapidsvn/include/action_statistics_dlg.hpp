@@ -0,0 +1,57 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _ACTION_STATISTICS_DLG_H_INCLUDED_
+#define _ACTION_STATISTICS_DLG_H_INCLUDED_
+
+#include "rapidsvn_generated.h"
+
+/**
+ * Shows the timing and resource statistics of the
+ * recent actions and lets the user export them.
+ */
+class ActionStatisticsDlg:public ActionStatisticsDlgBase
+{
+public:
+  ActionStatisticsDlg(wxWindow * parent);
+
+protected:
+  virtual void
+  OnExport(wxCommandEvent & event);
+
+  virtual void
+  OnClear(wxCommandEvent & event);
+
+private:
+  void
+  FillList();
+};
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
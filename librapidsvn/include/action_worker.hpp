@@ -115,6 +115,18 @@ public:
   virtual bool
   Perform(Action * action) = 0;
 
+  /**
+   * Runs @ref Action::RunPrepareInBackground for the
+   * action that is being prepared. A threaded worker
+   * does this in its thread and returns immediately.
+   *
+   * @see Action::StartPrepareInBackground
+   *
+   * @param action Action that is being prepared
+   */
+  virtual void
+  PrepareInBackground(Action * action) = 0;
+
   /**
    * Sets the context to use for actions
    *
@@ -64,6 +64,13 @@ public:
   virtual bool
   Prepare();
 
+  /**
+   * runs the annotation, the lines are
+   * sent to the dialog
+   */
+  virtual void
+  PrepareInBackground();
+
   static bool
   CheckStatusSel(const svn::StatusSel & statusSel);
 
@@ -35,6 +35,19 @@ public:
   void AddAnnotateLine(int revision, const wxString & author,
                        const wxString & line);
   void AutoSizeColumn();
+
+  /**
+   * The annotation is still running in the background,
+   * see @ref Action::PrepareInBackground. The lines arrive
+   * with TOKEN_PREPARE_PROGRESS as a svn::AnnotatedFile,
+   * followed by TOKEN_PREPARE_DONE.
+   */
+  void SetWaiting(bool waiting);
+
+private:
+  wxString m_caption;
+
+  void OnActionEvent(wxCommandEvent & event);
 };
 
 #endif
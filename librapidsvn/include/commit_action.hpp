@@ -47,6 +47,13 @@ public:
   virtual bool
   Prepare();
 
+  /**
+   * searches the selected working copy paths for
+   * files to commit
+   */
+  virtual void
+  PrepareInBackground();
+
   static bool
   CheckStatusSel(const svn::StatusSel & statusSel);
 
@@ -37,9 +37,15 @@ public:
    * constructor
    *
    * @param parent parent window
+   * @param filenames files to offer for commit
+   * @param scanning more files will be added by a scan in the
+   *                 background, see @ref Action::PrepareInBackground.
+   *                 It sends TOKEN_PREPARE_PROGRESS with a
+   *                 svn::PathVector and TOKEN_PREPARE_DONE to the dialog
    */
   CommitDlg(wxWindow* parent, 
-            const svn::PathVector & filenames=svn::EmptyPathVector);
+            const svn::PathVector & filenames=svn::EmptyPathVector,
+            bool scanning=false);
 
   /**
    * destructor
@@ -78,6 +84,7 @@ private:
   bool m_recursive;
   bool m_keepLocks;
   bool m_usesFilenames;
+  bool m_scanning;
   wxString m_message;
   svn::PathVector m_selectedFilenames;
 
@@ -89,6 +96,10 @@ private:
 
   void CheckFilesButtons(void);
 
+  void AddFiles(const svn::PathVector & filenames);
+
+  void OnActionEvent(wxCommandEvent &);
+
 protected: // inherited from CommitDlgBase
   virtual void OnComboHistory(wxCommandEvent &);
 
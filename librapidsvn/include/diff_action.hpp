@@ -41,8 +41,10 @@ public:
    * Constructor
    *
    * @param parent parent window
+   * @param useViewer show the unified diff in the built-in
+   *                  viewer instead of running the diff tool
    */
-  DiffAction(wxWindow * parent);
+  DiffAction(wxWindow * parent, bool useViewer = false);
 
   /**
    * Constructor, that takes read configured @a DiffData,
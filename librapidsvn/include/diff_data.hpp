@@ -56,12 +56,18 @@ public:
   svn::Revision revision1;
   svn::Revision revision2;
 
+  /**
+   * show the unified diff in the built-in viewer
+   * instead of running the diff tool for every file
+   */
+  bool useViewer;
+
   /** Constructor */
   DiffData(svn_opt_revision_kind kind = svn::Revision::BASE)
       : compareType(WITH_BASE),
       useUrl1(false), url1(wxEmptyString),
       useUrl2(false), url2(wxEmptyString),
-      revision1(kind)
+      revision1(kind), useViewer(false)
   {
     if (kind != svn::Revision::BASE)
       compareType = WITH_DIFFERENT_REVISION;
@@ -0,0 +1,103 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _DIFF_VIEWER_H_INCLUDED_
+#define _DIFF_VIEWER_H_INCLUDED_
+
+// wxWidgets
+#include "wx/frame.h"
+
+// forward declarations
+namespace svn
+{
+  class OutputSink;
+}
+class wxTimerEvent;
+
+/**
+ * Window that displays unified diff output.
+ *
+ * The diff is fed through the sink returned by
+ * @a CreateSink while it is being produced, usually
+ * from the worker thread. File and hunk boundaries
+ * are indexed as the data arrives and only the lines
+ * that are visible get rendered, so even diffs of
+ * thousands of files can be browsed without starting
+ * an external diff tool for each of them. The output
+ * is spooled to a temporary file, only the index is
+ * kept in memory.
+ */
+class DiffViewer : public wxFrame
+{
+public:
+  /**
+   * constructor
+   *
+   * @param parent parent window
+   * @param title window title
+   */
+  DiffViewer(wxWindow * parent, const wxString & title);
+
+  /**
+   * destructor
+   */
+  virtual ~DiffViewer();
+
+  /**
+   * creates a sink that feeds this viewer. The sink can
+   * be used from any thread and may outlive the window:
+   * once the window is closed the sink doesn't accept
+   * any more data. Deleting the sink marks the end of the
+   * diff output.
+   *
+   * The caller owns the returned sink.
+   */
+  svn::OutputSink *
+  CreateSink();
+
+private:
+  struct Data;
+  Data * m;
+
+  void
+  OnTimer(wxTimerEvent & event);
+
+  void
+  OnFileSelected(wxCommandEvent & event);
+
+  void
+  OnPrevHunk(wxCommandEvent & event);
+
+  void
+  OnNextHunk(wxCommandEvent & event);
+
+  DECLARE_EVENT_TABLE()
+};
+
+#endif
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
@@ -24,6 +24,9 @@
 #ifndef _FILE_LIST_CONROL_H_INCLUDED_
 #define _FILE_LIST_CONROL_H_INCLUDED_
 
+// stl
+#include "svncpp/vector_wrapper.hpp"
+
 // wxWidgets
 #include "wx/listctrl.h"
 #include "wx/dynarray.h"
@@ -240,6 +243,43 @@ public:
   void RefreshFileList();
   void RefreshFileList(const wxString & path);
 
+  /**
+   * Displays the entries for @a path with the current
+   * filter and column settings. The entries of the last
+   * refresh are reused if they are still valid, otherwise
+   * the list is refreshed.
+   */
+  void FilterFileList(const wxString & path);
+
+  /**
+   * Shows @a entries for @a path right away, marked as
+   * stale until @ref Revalidated is called with the
+   * current entries
+   */
+  void ShowStale(const wxString & path,
+                 const std::vector<svn::Status> & entries);
+
+  /**
+   * Replaces the stale entries with @a entries, keeping
+   * selection and scroll position. Does nothing if the
+   * list isnt stale anymore (e.g. it has been refreshed
+   * in the meantime)
+   */
+  void Revalidated(const std::vector<svn::Status> & entries);
+
+  /**
+   * @retval true the list shows entries from the last session
+   */
+  bool IsStale() const;
+
+  /**
+   * Writes the entries of the last refresh to @a fileName,
+   * see @ref WriteStatusSnapshot. Only local entries
+   * without update information are written, otherwise
+   * an existing snapshot is removed.
+   */
+  bool WriteSnapshot(const wxString & fileName) const;
+
   const IndexArray
   GetSelectedItems() const;
 
@@ -271,6 +311,8 @@ private:
 
   void SetColumnImages();
   void ApplySortChanges();
+  void ShowFileList();
+  void SetStale(bool stale);
 
   // message handlers
   void OnKeyDown(wxKeyEvent & event);
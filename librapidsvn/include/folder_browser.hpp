@@ -224,6 +224,15 @@ public:
   void
   ReadConfig(wxConfigBase * cfg);
 
+  /**
+   * selects the bookmark and folder that were selected
+   * when @ref WriteConfig was called last
+   *
+   * @retval true the bookmark could be selected
+   */
+  bool
+  RestoreSelection();
+
   /**
    * Expand the selected leaf of the tree.
    * Has no effect if the selection has no
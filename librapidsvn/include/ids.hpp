@@ -60,6 +60,8 @@ enum
   ID_Flat,
   ID_Stop,
   ID_Open,
+  ID_ActionStatistics,
+  ID_Trace,
 
   ID_TestNewWxString,
   ID_TestListener,
@@ -85,6 +87,7 @@ enum
   ID_Diff,
   ID_DiffBase,
   ID_DiffHead,
+  ID_DiffViewer,
   ID_Explore,
   ID_Export,
   ID_Import,
@@ -193,6 +196,11 @@ enum
   TOKEN_ANNOTATE,
   TOKEN_LOG,
   TOKEN_DRAG_N_DROP,
+  TOKEN_STATUS_REVALIDATED,
+  TOKEN_PROGRESS,
+  TOKEN_PREPARE_PROGRESS,
+  TOKEN_PREPARE_DONE,
+  TOKEN_RUN_COMMAND,
 
   LISTENER_MIN,
   SIG_GET_LOG_MSG,
@@ -120,6 +120,12 @@ public:
                 svn_wc_notify_state_t prop_state,
                 svn_revnum_t revision);
 
+  /**
+   * @see svn::ContextListener
+   */
+  virtual void
+  contextProgress(apr_off_t transferred, apr_off_t remaining);
+
   /**
    * @see svn::ContextListener
    */
@@ -175,6 +181,20 @@ public:
   bool
   isCancelled() const;
 
+  /**
+   * starts counting the bytes and files transferred
+   * by a new action
+   */
+  void
+  ResetProgress();
+
+  /**
+   * @return the totals and average rates of the last
+   *         action, empty if it didn't transfer anything
+   */
+  wxString
+  GetProgressSummary() const;
+
   /**
    * handles @a event that is passed from the parent frame
    * to this class.
@@ -76,6 +76,16 @@ public:
   void
   SetActivePane(ActivePane value);
 
+  /**
+   * Brings the window to front and selects @a path in the
+   * folder browser. If there is no bookmark for @a path yet,
+   * it will be added. A file opens the folder it lives in.
+   *
+   * @param path absolute path or URL, empty to only raise the window
+   */
+  void
+  OpenPath(const wxString & path);
+
 private:
   /** disallow default constructor */
   MainFrame();
@@ -120,6 +130,8 @@ private:
 
   // Extras menu
   void OnCleanup(wxCommandEvent & event);
+  void OnActionStatistics(wxCommandEvent & event);
+  void OnTrace(wxCommandEvent & event);
 
   // Help menu
   void OnHelpContents(wxCommandEvent & event);
@@ -131,8 +143,6 @@ private:
   void OnTestNewWxString(wxCommandEvent & event);
   void OnTestListener(wxCommandEvent & event);
   void OnTestCheckout(wxCommandEvent & event);
-  void PrintTimeMeasurements(apr_time_t start, apr_time_t end,
-                             const wxString & name);
   void OnTestCertDlg(wxCommandEvent & event);
   void OnTestDestinationDlg(wxCommandEvent & event);
   void OnTestDndDlg(wxCommandEvent & event);
@@ -178,11 +188,28 @@ private:
    */
   void RefreshFileList();
 
+  /**
+   * Apply changed view settings (filter, columns) to the
+   * filelist. The working copy is crawled only if the
+   * entries of the last refresh cannot be reused
+   */
+  void FilterFileList();
+
+  void UpdateFileList(bool filterOnly);
+
   /**
    * Update the contents of the folder browser
    */
   void RefreshFolderBrowser();
 
+  /**
+   * Build the folder browser, select the folder of the last
+   * session and show its entries from the snapshot, while
+   * they are brought up to date in the background. The file
+   * list is crawled right away only if there is no snapshot
+   */
+  void RestoreLastSession();
+
   // Auxiliary functions
   void UpdateCurrentPath();
   void UpdateMenuSorting();
@@ -120,6 +120,18 @@ public:
   */
   bool resetFlatModeOnStart;
 
+  /**
+   * report the user interface as stalled if it doesn't
+   * respond for this many milliseconds, 0 for never
+   */
+  long stallThreshold;
+
+  /**
+   * when started again, hand the path over to the
+   * running program instead of opening a new window
+   */
+  bool singleInstance;
+
 private:
   void Read();
   void Write() const;
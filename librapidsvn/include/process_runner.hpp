@@ -0,0 +1,130 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _PROCESS_RUNNER_H_INCLUDED_
+#define _PROCESS_RUNNER_H_INCLUDED_
+
+// wxWidgets
+#include "wx/string.h"
+
+// forward declarations
+class Tracer;
+class wxWindow;
+
+/**
+ * Data for TOKEN_RUN_COMMAND: a command line whose output
+ * is shown in the log, see @ref ProcessRunner::COMMAND
+ */
+struct ProcessData
+{
+  wxString command;
+
+  /**
+   * if not 0, this action event is posted with
+   * @a doneMessage when the command succeeded
+   */
+  int doneToken;
+  wxString doneMessage;
+
+  ProcessData(const wxString & command_)
+    : command(command_), doneToken(0)
+  {
+  }
+};
+
+/**
+ * Runs external programs without blocking the user interface.
+ *
+ * The output of commands is written to the log while they run,
+ * the exit status is reported when they are finished. Only a
+ * limited number of diff and merge tools run at the same time,
+ * the others wait until one of them is closed.
+ */
+class ProcessRunner
+{
+public:
+  enum Kind
+  {
+    /** a program the user works with, e.g. an editor */
+    TOOL,
+    /** a diff or merge tool, see @ref MAX_DIFF_TOOLS */
+    DIFF_TOOL,
+    /** a command line whose output goes to the log */
+    COMMAND
+  };
+
+  /** the maximum number of diff tools running at the same time */
+  static const size_t MAX_DIFF_TOOLS;
+
+  /**
+   * constructor
+   *
+   * @param parent receives the events of @ref ProcessData
+   * @param tracer the log
+   */
+  ProcessRunner(wxWindow * parent, Tracer * tracer);
+
+  /**
+   * destructor. Programs that are still running
+   * keep running, but aren't reported anymore
+   */
+  virtual ~ProcessRunner();
+
+  /**
+   * starts @a command or queues it
+   *
+   * @param kind what kind of program this is
+   * @param command the command line
+   */
+  void
+  Run(Kind kind, const wxString & command);
+
+  /**
+   * starts the command in @a data, see @ref COMMAND
+   */
+  void
+  Run(const ProcessData & data);
+
+  /**
+   * @return number of programs that are running or waiting
+   */
+  size_t
+  GetCount() const;
+
+private:
+  struct Data;
+  Data * m;
+
+  /** disallow copy */
+  ProcessRunner(const ProcessRunner &);
+  ProcessRunner & operator = (const ProcessRunner &);
+};
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
@@ -30,10 +30,13 @@
 #include <wx/html/helpctrl.h> // html help support
 
 class wxTipProvider;
+class SingleInstance;
 
 class RapidSvnApp:public wxApp
 {
 public:
+  RapidSvnApp();
+
   void OptionallyRegisterTempFile(const wxString & filename);
   void OptionallyPurgeTempFiles();
 
@@ -56,11 +59,32 @@ protected:
   virtual bool OnInit();
   virtual int OnExit();
 
+#if wxUSE_EXCEPTIONS
+  /**
+   * Every event handler is called from here. While
+   * a trace is recorded each call is a span in there;
+   * the stall watchdog learns what is running.
+   */
+  virtual void HandleEvent(wxEvtHandler * handler,
+                           wxEventFunction func,
+                           wxEvent & event) const;
+#endif
+
 private:
   wxLocale m_locale;
 
   wxArrayString m_TempFiles;
 
+  /** hands paths over to a running process, see @ref SingleInstance */
+  SingleInstance * m_singleInstance;
+
+  /**
+   * @return the path or URL given on the command line, made
+   *         absolute, or an empty string
+   */
+  wxString
+  GetPathArgument() const;
+
 #if wxUSE_WXHTML_HELP
   wxHtmlHelpController* m_helpController;
 
@@ -73,6 +73,34 @@ class AboutDlgBase : public wxDialog
 	
 };
 
+///////////////////////////////////////////////////////////////////////////////
+/// Class ActionStatisticsDlgBase
+///////////////////////////////////////////////////////////////////////////////
+class ActionStatisticsDlgBase : public wxDialog 
+{
+	private:
+	
+	protected:
+		wxBoxSizer* m_mainSizer;
+		wxListCtrl* m_list;
+		wxBoxSizer* m_buttonSizer;
+		wxButton* m_buttonExport;
+		wxButton* m_buttonClear;
+		
+		wxButton* m_buttonOK;
+		
+		// Virtual event handlers, overide them in your derived class
+		virtual void OnExport( wxCommandEvent& event ) { event.Skip(); }
+		virtual void OnClear( wxCommandEvent& event ) { event.Skip(); }
+		
+	
+	public:
+		
+		ActionStatisticsDlgBase( wxWindow* parent, wxWindowID id = wxID_ANY, const wxString& title = _("Action Statistics"), const wxPoint& pos = wxDefaultPosition, const wxSize& size = wxSize( 700,400 ), long style = wxDEFAULT_DIALOG_STYLE|wxRESIZE_BORDER );
+		~ActionStatisticsDlgBase();
+	
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Class AnnotateDlgBase
 ///////////////////////////////////////////////////////////////////////////////
@@ -745,6 +773,7 @@ class PreferencesDlgBase : public wxDialog
 		wxCheckBox* m_checkPurgeTempFiles;
 		wxCheckBox* m_checkUseLastCommitMessage;
 		wxCheckBox* m_checkResetFlatMode;
+		wxCheckBox* m_checkSingleInstance;
 		wxPanel* m_panelPrograms;
 		wxNotebook* m_notebook2;
 		wxPanel* m_panelEditor;
@@ -0,0 +1,92 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _SHARED_IMAGE_LIST_H_INCLUDED_
+#define _SHARED_IMAGE_LIST_H_INCLUDED_
+
+// forward declarations
+class wxImageList;
+
+/**
+ * A process-wide image list that is shared by all the controls
+ * displaying the same set of icons (e.g. every @ref FileListCtrl).
+ *
+ * The embedded PNG images are decoded only once, when @ref Get
+ * is called for the first time. The list is owned by this class and
+ * deleted when wxWidgets shuts down, so controls have to use
+ * SetImageList and never AssignImageList with it.
+ *
+ * Instances are meant to be static objects; only the GUI thread
+ * may call @ref Get.
+ */
+class SharedImageList
+{
+public:
+  /**
+   * Function that adds the images to a newly created list
+   */
+  typedef void (*FillFunc)(wxImageList & list);
+
+  /**
+   * constructor. Doesn't create the list yet
+   *
+   * @param fill function called on first use to fill the list
+   * @param width width of the images
+   * @param height height of the images
+   */
+  SharedImageList(FillFunc fill, int width = 16, int height = 16);
+
+  /**
+   * returns the list, creates and fills it on first use
+   */
+  wxImageList *
+  Get();
+
+  /**
+   * deletes all the lists created so far. Called on shutdown.
+   */
+  static void
+  DeleteAll();
+
+private:
+  FillFunc m_fill;
+  int m_width;
+  int m_height;
+  wxImageList * m_list;
+
+  /** next list that has been created, see @ref DeleteAll */
+  SharedImageList * m_next;
+
+  /** disallow copy */
+  SharedImageList(const SharedImageList &);
+  SharedImageList & operator = (const SharedImageList &);
+};
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
@@ -0,0 +1,83 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _SINGLE_INSTANCE_H_INCLUDED_
+#define _SINGLE_INSTANCE_H_INCLUDED_
+
+// wxWidgets
+#include "wx/string.h"
+
+/**
+ * Makes sure only one RapidSVN process runs for the user.
+ *
+ * A new invocation checks for a running process before doing any
+ * expensive initialization and hands the path from its command line
+ * over to it, using a local socket (DDE on Windows). The running
+ * process then opens the path in its @ref MainFrame.
+ *
+ * If the running process cannot be reached, the new invocation
+ * simply starts on its own.
+ */
+class SingleInstance
+{
+public:
+  SingleInstance();
+
+  virtual ~SingleInstance();
+
+  /**
+   * tries to pass @a path to a running process
+   *
+   * @param path absolute path or URL to open. An empty string
+   *             just brings the running process to front
+   * @retval true the running process took over, exit now
+   * @retval false this is the only process
+   */
+  bool
+  Forward(const wxString & path);
+
+  /**
+   * start accepting paths from new invocations. The paths are
+   * opened in the top window of the application, so call this
+   * after the @ref MainFrame has been created.
+   */
+  void
+  Listen();
+
+private:
+  struct Data;
+  Data * m;
+
+  /** disallow copy */
+  SingleInstance(const SingleInstance &);
+  SingleInstance & operator = (const SingleInstance &);
+};
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
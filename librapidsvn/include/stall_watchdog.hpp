@@ -0,0 +1,116 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _STALL_WATCHDOG_H_INCLUDED_
+#define _STALL_WATCHDOG_H_INCLUDED_
+
+// wxWidgets
+#include "wx/string.h"
+
+// forward declarations
+class wxEvent;
+class wxEvtHandler;
+class wxWindow;
+
+/**
+ * Watches the GUI thread from a thread of its own. Every
+ * now and then it posts an event to the GUI thread; if the
+ * event isn't processed within the threshold, the GUI
+ * thread is stalled. Once it responds again, the stall is
+ * reported in the log window and added to
+ * @a TheActionStatistics, together with the event handlers
+ * and actions that were running when the stall was noticed.
+ */
+class StallWatchdog
+{
+public:
+  StallWatchdog();
+
+  virtual ~StallWatchdog();
+
+  /**
+   * starts watching the GUI thread. Has to be called
+   * from the GUI thread.
+   *
+   * @param parent window the stalls are reported to
+   * @param thresholdMs the GUI thread is stalled if it
+   *                    doesn't respond within this time.
+   *                    0 doesn't start the watchdog.
+   */
+  void
+  Start(wxWindow * parent, long thresholdMs);
+
+  /**
+   * stops watching
+   */
+  void
+  Stop();
+
+  /**
+   * Names what the GUI thread is doing for the lifetime
+   * of the object, e.g. preparing an action. The name
+   * shows up in the stall reports. Use it in the GUI
+   * thread only.
+   */
+  class Scope
+  {
+  public:
+    Scope(const wxString & name);
+
+    /**
+     * Used by RapidSvnApp around every event handler.
+     * Only the class of @a handler and the type and id
+     * of @a event are kept.
+     */
+    Scope(wxEvtHandler * handler, const wxEvent & event);
+
+    ~Scope();
+
+  private:
+    bool m_entered;
+  };
+
+private:
+  struct Data;
+  Data * m;
+
+  /** disallow copy constructor */
+  StallWatchdog(const StallWatchdog &);
+
+  /** disallow assignment operator */
+  StallWatchdog & operator = (const StallWatchdog &);
+};
+
+/**
+ * This is the singleton instance of the watchdog
+ */
+extern StallWatchdog TheStallWatchdog;
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
@@ -0,0 +1,130 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+#ifndef _STATUS_SNAPSHOT_H_
+#define _STATUS_SNAPSHOT_H_
+
+// wxWidgets
+#include "wx/string.h"
+
+// svncpp
+#include "svncpp/client.hpp"
+
+// forward declarations
+class wxWindow;
+
+/**
+ * @return the name of the file the file list of the
+ *         last session is kept in
+ */
+wxString
+GetStatusSnapshotFileName();
+
+/**
+ * Writes the status @a entries listed for @a path to
+ * @a fileName, so they can be shown right away on the
+ * next start
+ *
+ * @retval true snapshot written
+ */
+bool
+WriteStatusSnapshot(const wxString & fileName,
+                    const wxString & path, bool flat,
+                    const svn::StatusEntries & entries);
+
+/**
+ * Reads a snapshot written by @ref WriteStatusSnapshot.
+ * Only the information needed to display the entries
+ * is restored: there are no repository locks and no
+ * out-of-date information.
+ *
+ * @retval false there is no valid snapshot
+ */
+bool
+ReadStatusSnapshot(const wxString & fileName,
+                   wxString & path, bool & flat,
+                   svn::StatusEntries & entries);
+
+/**
+ * The result of a background status crawl. It is passed
+ * with @a TOKEN_STATUS_REVALIDATED and owned by the receiver.
+ */
+struct RevalidatedStatus
+{
+  wxString path;
+  bool flat;
+  svn::StatusEntries entries;
+
+  /** empty if the crawl succeeded */
+  wxString error;
+};
+
+/**
+ * Crawls the status of a local path in a thread of its
+ * own, with a context of its own, and posts the result
+ * to the parent window.
+ *
+ * Since there is nobody to answer prompts, this
+ * is meant for local status without update only.
+ */
+class StatusRevalidator
+{
+public:
+  /**
+   * constructor. The crawl starts right away.
+   *
+   * @param parent window receiving @a TOKEN_STATUS_REVALIDATED
+   * @param path local path to crawl
+   * @param flat crawl the subdirectories as well
+   */
+  StatusRevalidator(wxWindow * parent, const wxString & path, bool flat);
+
+  /**
+   * destructor. Cancels the crawl and waits for it
+   */
+  virtual ~StatusRevalidator();
+
+  /**
+   * @return true if the crawl is still running
+   */
+  bool
+  IsRunning() const;
+
+private:
+  struct Data;
+  Data * m;
+
+  /**
+   * disallow copy constructor and assignment operator
+   */
+  StatusRevalidator(const StatusRevalidator &);
+  StatusRevalidator &
+  operator = (const StatusRevalidator &);
+};
+
+#endif
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
@@ -73,6 +73,12 @@ public:
   virtual bool
   Perform(Action * action);
 
+  /**
+   * @see ActionWorker
+   */
+  virtual void
+  PrepareInBackground(Action * action);
+
   /**
    * @see ActionWorker
    */
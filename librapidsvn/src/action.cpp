@@ -22,17 +22,32 @@
  * ====================================================================
  */
 
+// stl
+#include <algorithm>
+#include <map>
+#include <vector>
+
 // wxWidgets
 #include "wx/wx.h"
+#include "wx/filename.h"
+#include "wx/thread.h"
 #include "wx/utils.h"
 
 // svncpp
 #include "svncpp/client.hpp"
+#include "svncpp/context.hpp"
+#include "svncpp/exception.hpp"
 #include "svncpp/status_selection.hpp"
+#include "svncpp/trace.hpp"
+#include "svncpp/wc.hpp"
 
 // app
 #include "action.hpp"
+#include "action_event.hpp"
+#include "action_worker.hpp"
 #include "config.hpp"
+#include "ids.hpp"
+#include "listener.hpp"
 #include "tracer.hpp"
 #include "rapidsvn_app.hpp"
 #include "utils.hpp"
@@ -52,6 +67,12 @@ SafeYield() {};
 #endif
 
 
+/**
+ * interval (in milliseconds) in which the main thread
+ * handles events while waiting for PrepareInBackground
+ */
+static const int PREPARE_POLL_INTERVAL = 20;
+
 struct Action::Data
 {
 public:
@@ -95,12 +116,81 @@ public:
 
   svn::StatusSel statusSel;
 
+  /** the worker that runs the action */
+  ActionWorker * worker;
+
+  /** receives the results of PrepareInBackground */
+  wxWindow * prepareReceiver;
+
+  /** protects @a preparing and @a prepareCancelled */
+  wxMutex prepareMutex;
+
+  /** signalled when PrepareInBackground is done */
+  wxCondition prepareDone;
+
+  /** true while PrepareInBackground runs */
+  bool preparing;
+
+  bool prepareCancelled;
+
   Data(wxWindow * parnt, const wxString & nam, unsigned int flgs)
       :  parent(parnt), name(nam), flags(flgs),
-      tracer(0), ownTracer(false)
+      tracer(0), ownTracer(false), context(0), worker(0), prepareReceiver(0),
+      prepareDone(prepareMutex), preparing(false), prepareCancelled(false)
   {
   }
 
+  /**
+   * waits until PrepareInBackground is done. With @a cancel
+   * the running svn calls are cancelled, prompts fail right
+   * away then.
+   *
+   * In the main thread the posted events are handled while
+   * waiting: the prompts of the svn calls are answered by
+   * the main frame, the worker would wait for them forever
+   * otherwise.
+   */
+  void
+  WaitWhilePreparing(bool cancel)
+  {
+    Listener * listener = 0;
+    {
+      wxMutexLocker lock(prepareMutex);
+      if (!preparing)
+        return;
+
+      if (cancel)
+      {
+        prepareCancelled = true;
+
+        // stop running svn calls as well
+        if (context != 0)
+          listener = dynamic_cast<Listener *>(context->getListener());
+        if (listener != 0)
+          listener->cancel(true);
+      }
+    }
+
+    bool mainThread = wxThread::IsMain();
+    for (;;)
+    {
+      {
+        wxMutexLocker lock(prepareMutex);
+        if (preparing)
+          prepareDone.WaitTimeout(PREPARE_POLL_INTERVAL);
+
+        if (!preparing)
+          break;
+      }
+
+      if (mainThread && (wxTheApp != 0))
+        wxTheApp->ProcessPendingEvents();
+    }
+
+    if (listener != 0)
+      listener->cancel(false);
+  }
+
   virtual ~Data()
   {
     if (tracer && ownTracer)
@@ -123,6 +213,9 @@ Action::Action(wxWindow * parent, const wxString & name, unsigned int flgs)
 
 Action::~Action()
 {
+  // never delete the action while the worker thread uses it
+  m->WaitWhilePreparing(true);
+
   delete m;
 }
 
@@ -223,6 +316,90 @@ Action::Prepare()
   return true;
 }
 
+void
+Action::PrepareInBackground()
+{
+}
+
+void
+Action::StartPrepareInBackground(wxWindow * receiver)
+{
+  m->prepareReceiver = receiver;
+  {
+    wxMutexLocker lock(m->prepareMutex);
+    m->prepareCancelled = false;
+    m->preparing = true;
+  }
+
+  if (m->worker)
+    m->worker->PrepareInBackground(this);
+  else
+    RunPrepareInBackground();
+}
+
+void
+Action::WaitPrepareInBackground(bool cancel)
+{
+  if (m->prepareReceiver == 0)
+    return;
+
+  m->WaitWhilePreparing(cancel);
+
+  // the receiver owns the data of the events
+  // that are still pending, deliver them
+  m->prepareReceiver->ProcessPendingEvents();
+  m->prepareReceiver = 0;
+}
+
+void
+Action::RunPrepareInBackground()
+{
+  wxString error;
+
+  try
+  {
+    svn::TraceSpan span("action", LocalToUtf8(wxT("Prepare in background ") + GetName()));
+    PrepareInBackground();
+  }
+  catch (svn::ClientException & e)
+  {
+    error = Utf8ToLocal(e.message());
+  }
+  catch (...)
+  {
+    error = _("Error while preparing action.");
+  }
+
+  // a cancelled svn call fails, that's no error
+  if (IsPrepareCancelled())
+    error = wxEmptyString;
+
+  ActionEvent::Post(m->prepareReceiver, TOKEN_PREPARE_DONE, error);
+
+  wxMutexLocker lock(m->prepareMutex);
+  m->preparing = false;
+  m->prepareDone.Broadcast();
+}
+
+wxWindow *
+Action::GetPrepareReceiver()
+{
+  return m->prepareReceiver;
+}
+
+bool
+Action::IsPrepareCancelled() const
+{
+  wxMutexLocker lock(m->prepareMutex);
+  return m->prepareCancelled;
+}
+
+void
+Action::SetWorker(ActionWorker * worker)
+{
+  m->worker = worker;
+}
+
 const svn::Path
 Action::GetTarget() const
 {
@@ -283,6 +460,131 @@ Action::GetPathAsTempFile(const svn::Path & path,
   return dstPath;
 }
 
+/**
+ * a translated copy of a text-base
+ */
+struct PristineCopy
+{
+  svn::Path file;
+
+  /** value of g_pristineUseCount when it was used last */
+  size_t lastUse;
+};
+
+/**
+ * translated copies of text-bases, key is
+ * "<path>:<checksum>:<translation key>" so changes of
+ * svn:eol-style or svn:keywords invalidate the copy
+ */
+typedef std::map<std::string, PristineCopy> PristineCache;
+static PristineCache g_pristineCache;
+static size_t g_pristineUseCount = 0;
+static wxMutex g_pristineCacheMutex;
+
+/** the maximum number of copies in g_pristineCache */
+static const size_t MAX_PRISTINE_COPIES = 256;
+
+/**
+ * drops the least recently used quarter of g_pristineCache
+ * and removes their files. The caller holds g_pristineCacheMutex
+ */
+static void
+EvictPristineCopies()
+{
+  std::vector<size_t> uses;
+  uses.reserve(g_pristineCache.size());
+
+  PristineCache::iterator it;
+  for (it = g_pristineCache.begin(); it != g_pristineCache.end(); it++)
+    uses.push_back(it->second.lastUse);
+
+  std::vector<size_t>::iterator limit = uses.begin() + uses.size() / 4;
+  std::nth_element(uses.begin(), limit, uses.end());
+
+  it = g_pristineCache.begin();
+  while (it != g_pristineCache.end())
+  {
+    if (it->second.lastUse <= *limit)
+    {
+      ::wxRemoveFile(Utf8ToLocal(it->second.file.c_str()));
+      g_pristineCache.erase(it++);
+    }
+    else
+      it++;
+  }
+}
+
+svn::Path
+Action::GetBaseFile(const svn::Path & path)
+{
+  if (path.isUrl())
+    return GetPathAsTempFile(path, svn::Revision::BASE);
+
+  std::string key;
+  try
+  {
+    std::string checksum(svn::Wc::getPristineChecksum(path));
+    if (checksum.empty())
+      return GetPathAsTempFile(path, svn::Revision::BASE);
+
+    key = path.path() + ":" + checksum + ":" +
+          svn::Wc::getTranslationKey(path);
+  }
+  catch (svn::ClientException &)
+  {
+    return GetPathAsTempFile(path, svn::Revision::BASE);
+  }
+
+  {
+    wxMutexLocker lock(g_pristineCacheMutex);
+    PristineCache::iterator it = g_pristineCache.find(key);
+
+    if (it != g_pristineCache.end())
+    {
+      if (wxFileName::FileExists(Utf8ToLocal(it->second.file.c_str())))
+      {
+        it->second.lastUse = ++g_pristineUseCount;
+        return it->second.file;
+      }
+
+      g_pristineCache.erase(it);
+    }
+  }
+
+  wxString msg, wxpath(Utf8ToLocal(path.c_str()));
+  msg.Printf(_("Get file %s rev. %s"),
+             wxpath.c_str(), _("BASE"));
+  Trace(msg);
+
+  svn::Path dstPath;
+  bool isCopy = false;
+  try
+  {
+    isCopy = svn::Wc::getPristineFile(dstPath, path);
+  }
+  catch (svn::ClientException &)
+  {
+    return GetPathAsTempFile(path, svn::Revision::BASE);
+  }
+
+  if (isCopy)
+  {
+    ::wxGetApp().OptionallyRegisterTempFile(
+      Utf8ToLocal(dstPath.c_str()));
+
+    wxMutexLocker lock(g_pristineCacheMutex);
+    if ((g_pristineCache.find(key) == g_pristineCache.end()) &&
+        (g_pristineCache.size() >= MAX_PRISTINE_COPIES))
+      EvictPristineCopies();
+
+    PristineCopy & copy = g_pristineCache[key];
+    copy.file = dstPath;
+    copy.lastUse = ++g_pristineUseCount;
+  }
+
+  return dstPath;
+}
+
 const svn::StatusSel &
 Action::GetStatusSel(void) const
 {
@@ -172,6 +172,7 @@ ActionFactory::CheckIdForStatusSel(int id, const svn::StatusSel & statusSel)
   case ID_Diff:
   case ID_DiffBase:
   case ID_DiffHead:
+  case ID_DiffViewer:
     result = DiffAction::CheckStatusSel(statusSel);
     break;
 
@@ -317,6 +318,10 @@ ActionFactory::CreateAction(wxWindow * parent, int id)
       break;
     }
 
+    case ID_DiffViewer:
+      action = new DiffAction(parent, true);
+      break;
+
     case ID_Unlock:
       action = new UnlockAction(parent);
       break;
@@ -0,0 +1,351 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// wxWidgets
+#include "wx/wx.h"
+#include "wx/ffile.h"
+#include "wx/thread.h"
+
+// svncpp
+#include "svncpp/pool.hpp"
+
+// app
+#include "action_statistics.hpp"
+
+/**
+ * number of actions the statistics are kept for
+ */
+static const size_t MAX_ENTRIES = 500;
+
+ActionStatisticsLog TheActionStatistics;
+
+static wxString
+FormatCalls(const svn::ContextStatistics & statistics,
+            const wxChar * separator, bool quote)
+{
+  wxString str;
+  std::map<std::string, size_t>::const_iterator it;
+
+  for (it = statistics.calls.begin(); it != statistics.calls.end(); ++it)
+  {
+    if (!str.IsEmpty())
+      str += separator;
+
+    wxString name(it->first.c_str(), wxConvUTF8);
+    if (quote)
+      str += wxString::Format(wxT("\"%s\": %lu"), name.c_str(),
+                              (unsigned long)it->second);
+    else
+      str += wxString::Format(wxT("%s=%lu"), name.c_str(),
+                              (unsigned long)it->second);
+  }
+
+  return str;
+}
+
+static wxString
+EscapeJson(const wxString & value)
+{
+  wxString str;
+
+  for (size_t i = 0; i < value.Length(); i++)
+  {
+    wxChar c = value[i];
+    if ((c == wxT('"')) || (c == wxT('\\')))
+      str += wxT('\\');
+
+    if (c < wxT(' '))
+      str += wxString::Format(wxT("\\u%04x"), (int)c);
+    else
+      str += c;
+  }
+
+  return str;
+}
+
+static wxString
+EscapeCsv(const wxString & value)
+{
+  wxString str(value);
+  str.Replace(wxT("\""), wxT("\"\""));
+
+  return wxT("\"") + str + wxT("\"");
+}
+
+ActionStatistics::ActionStatistics()
+  : success(false), wallMs(0), guiMs(0), workerMs(0),
+    poolsCreated(0), peakMemoryKb(0)
+{
+}
+
+StallStatistics::StallStatistics()
+  : durationMs(0)
+{
+}
+
+wxString
+StallStatistics::Format() const
+{
+  wxString str;
+  str.Printf(_("The user interface did not respond for %ld ms: %s"),
+             durationMs, location.c_str());
+
+  return str;
+}
+
+wxString
+ActionStatistics::Format() const
+{
+  wxString str;
+  str.Printf(_("%s: %ld ms (GUI %ld ms, worker %ld ms), %s bytes, %lu notifications, %lu pools"),
+             name.c_str(), wallMs, guiMs, workerMs,
+             wxLongLong(context.bytesTransferred).ToString().c_str(),
+             (unsigned long)context.notifications,
+             (unsigned long)poolsCreated);
+
+  wxString calls(FormatCalls(context, wxT(", "), false));
+  if (!calls.IsEmpty())
+    str += wxT(" [") + calls + wxT("]");
+
+  return str;
+}
+
+ActionMeasurement::ActionMeasurement()
+  : m_context(0), m_pools(0)
+{
+}
+
+void
+ActionMeasurement::Start(const wxString & name, svn::Context * context)
+{
+  m_statistics = ActionStatistics();
+  m_statistics.name = name;
+  m_statistics.start = wxDateTime::Now();
+
+  m_context = context;
+  if (m_context != 0)
+    m_context->resetStatistics();
+
+  m_pools = svn::Pool::createdCount();
+  m_start = wxGetLocalTimeMillis();
+  m_phaseStart = m_start;
+}
+
+void
+ActionMeasurement::BeginPhase()
+{
+  m_phaseStart = wxGetLocalTimeMillis();
+}
+
+void
+ActionMeasurement::EndPhase(bool gui)
+{
+  long duration = (wxGetLocalTimeMillis() - m_phaseStart).ToLong();
+
+  if (gui)
+    m_statistics.guiMs += duration;
+  else
+    m_statistics.workerMs += duration;
+}
+
+ActionStatistics
+ActionMeasurement::Finish(bool success)
+{
+  m_statistics.success = success;
+  m_statistics.wallMs = (wxGetLocalTimeMillis() - m_start).ToLong();
+
+  if (m_context != 0)
+    m_statistics.context = m_context->getStatistics();
+
+  m_statistics.poolsCreated = svn::Pool::createdCount() - m_pools;
+  m_statistics.peakMemoryKb = svn::Pool::peakMemoryKb();
+
+  TheActionStatistics.Add(m_statistics);
+
+  return m_statistics;
+}
+
+struct ActionStatisticsLog::Data
+{
+  mutable wxMutex mutex;
+  ActionStatisticsList entries;
+  StallStatisticsList stalls;
+};
+
+ActionStatisticsLog::ActionStatisticsLog()
+  : m(new Data)
+{
+}
+
+ActionStatisticsLog::~ActionStatisticsLog()
+{
+  delete m;
+}
+
+void
+ActionStatisticsLog::Add(const ActionStatistics & statistics)
+{
+  wxMutexLocker lock(m->mutex);
+
+  if (m->entries.size() >= MAX_ENTRIES)
+    m->entries.erase(m->entries.begin());
+
+  m->entries.push_back(statistics);
+}
+
+ActionStatisticsList
+ActionStatisticsLog::Get() const
+{
+  wxMutexLocker lock(m->mutex);
+
+  return m->entries;
+}
+
+void
+ActionStatisticsLog::Clear()
+{
+  wxMutexLocker lock(m->mutex);
+
+  m->entries.clear();
+  m->stalls.clear();
+}
+
+void
+ActionStatisticsLog::AddStall(const StallStatistics & stall)
+{
+  wxMutexLocker lock(m->mutex);
+
+  if (m->stalls.size() >= MAX_ENTRIES)
+    m->stalls.erase(m->stalls.begin());
+
+  m->stalls.push_back(stall);
+}
+
+StallStatisticsList
+ActionStatisticsLog::GetStalls() const
+{
+  wxMutexLocker lock(m->mutex);
+
+  return m->stalls;
+}
+
+bool
+ActionStatisticsLog::Export(const wxString & fileName) const
+{
+  ActionStatisticsList entries(Get());
+  StallStatisticsList stalls(GetStalls());
+  bool csv = fileName.Lower().EndsWith(wxT(".csv"));
+  wxString str;
+
+  if (csv)
+    str = wxT("name,start,success,wall_ms,gui_ms,worker_ms,bytes,")
+          wxT("notifications,pools_created,peak_memory_kb,calls\n");
+  else
+    str = wxT("{\n\"actions\": [\n");
+
+  ActionStatisticsList::const_iterator it;
+  for (it = entries.begin(); it != entries.end(); ++it)
+  {
+    wxString start(it->start.FormatISODate() + wxT("T") +
+                   it->start.FormatISOTime());
+    wxString bytes(wxLongLong(it->context.bytesTransferred).ToString());
+
+    if (csv)
+    {
+      str += wxString::Format(wxT("%s,%s,%d,%ld,%ld,%ld,%s,%lu,%lu,%ld,%s\n"),
+                              EscapeCsv(it->name).c_str(), start.c_str(),
+                              it->success ? 1 : 0,
+                              it->wallMs, it->guiMs, it->workerMs,
+                              bytes.c_str(),
+                              (unsigned long)it->context.notifications,
+                              (unsigned long)it->poolsCreated,
+                              it->peakMemoryKb,
+                              EscapeCsv(FormatCalls(it->context, wxT(";"), false)).c_str());
+    }
+    else
+    {
+      if (it != entries.begin())
+        str += wxT(",\n");
+
+      str += wxString::Format(wxT("  {\"name\": \"%s\", \"start\": \"%s\", \"success\": %s, ")
+                              wxT("\"wall_ms\": %ld, \"gui_ms\": %ld, \"worker_ms\": %ld, ")
+                              wxT("\"bytes\": %s, \"notifications\": %lu, ")
+                              wxT("\"pools_created\": %lu, \"peak_memory_kb\": %ld, ")
+                              wxT("\"calls\": {%s}}"),
+                              EscapeJson(it->name).c_str(), start.c_str(),
+                              it->success ? wxT("true") : wxT("false"),
+                              it->wallMs, it->guiMs, it->workerMs,
+                              bytes.c_str(),
+                              (unsigned long)it->context.notifications,
+                              (unsigned long)it->poolsCreated,
+                              it->peakMemoryKb,
+                              FormatCalls(it->context, wxT(", "), true).c_str());
+    }
+  }
+
+  if (csv)
+    str += wxT("\nstall_start,duration_ms,location\n");
+  else
+    str += wxT("\n],\n\"stalls\": [\n");
+
+  StallStatisticsList::const_iterator stall;
+  for (stall = stalls.begin(); stall != stalls.end(); ++stall)
+  {
+    wxString start(stall->start.FormatISODate() + wxT("T") +
+                   stall->start.FormatISOTime());
+
+    if (csv)
+    {
+      str += wxString::Format(wxT("%s,%ld,%s\n"), start.c_str(),
+                              stall->durationMs,
+                              EscapeCsv(stall->location).c_str());
+    }
+    else
+    {
+      if (stall != stalls.begin())
+        str += wxT(",\n");
+
+      str += wxString::Format(wxT("  {\"start\": \"%s\", \"duration_ms\": %ld, ")
+                              wxT("\"location\": \"%s\"}"),
+                              start.c_str(), stall->durationMs,
+                              EscapeJson(stall->location).c_str());
+    }
+  }
+
+  if (!csv)
+    str += wxT("\n]\n}\n");
+
+  wxFFile file(fileName, wxT("w"));
+  if (!file.IsOpened())
+    return false;
+
+  return file.Write(str, wxConvUTF8) && file.Close();
+}
+
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
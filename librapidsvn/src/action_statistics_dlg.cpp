@@ -0,0 +1,133 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// wxWidgets
+#include "wx/filedlg.h"
+#include "wx/msgdlg.h"
+
+// app
+#include "action_statistics.hpp"
+#include "action_statistics_dlg.hpp"
+
+static const wxChar * EXPORT_WILDCARD =
+  _("JSON files (*.json)|*.json|CSV files (*.csv)|*.csv");
+
+ActionStatisticsDlg::ActionStatisticsDlg(wxWindow * parent)
+  : ActionStatisticsDlgBase(parent, -1)
+{
+  m_list->InsertColumn(0, _("Action"));
+  m_list->InsertColumn(1, _("Started"));
+  m_list->InsertColumn(2, _("Result"));
+  m_list->InsertColumn(3, _("Total (ms)"), wxLIST_FORMAT_RIGHT);
+  m_list->InsertColumn(4, _("GUI (ms)"), wxLIST_FORMAT_RIGHT);
+  m_list->InsertColumn(5, _("Worker (ms)"), wxLIST_FORMAT_RIGHT);
+  m_list->InsertColumn(6, _("Bytes"), wxLIST_FORMAT_RIGHT);
+  m_list->InsertColumn(7, _("Notifications"), wxLIST_FORMAT_RIGHT);
+  m_list->InsertColumn(8, _("Pools"), wxLIST_FORMAT_RIGHT);
+  m_list->InsertColumn(9, _("Peak Memory (kB)"), wxLIST_FORMAT_RIGHT);
+  m_list->InsertColumn(10, _("Calls"));
+
+  FillList();
+
+  for (int col = 0; col < 10; col++)
+    m_list->SetColumnWidth(col, wxLIST_AUTOSIZE_USEHEADER);
+  m_list->SetColumnWidth(10, 300);
+
+  CentreOnParent();
+}
+
+void
+ActionStatisticsDlg::FillList()
+{
+  m_list->DeleteAllItems();
+
+  ActionStatisticsList entries(TheActionStatistics.Get());
+
+  // most recent action first
+  ActionStatisticsList::const_reverse_iterator it;
+  for (it = entries.rbegin(); it != entries.rend(); ++it)
+  {
+    long index = m_list->GetItemCount();
+    m_list->InsertItem(index, it->name);
+    m_list->SetItem(index, 1, it->start.FormatTime());
+    m_list->SetItem(index, 2, it->success ? _("Success") : _("Error"));
+    m_list->SetItem(index, 3, wxString::Format(wxT("%ld"), it->wallMs));
+    m_list->SetItem(index, 4, wxString::Format(wxT("%ld"), it->guiMs));
+    m_list->SetItem(index, 5, wxString::Format(wxT("%ld"), it->workerMs));
+    m_list->SetItem(index, 6, wxLongLong(it->context.bytesTransferred).ToString());
+    m_list->SetItem(index, 7, wxString::Format(wxT("%lu"),
+                                               (unsigned long)it->context.notifications));
+    m_list->SetItem(index, 8, wxString::Format(wxT("%lu"),
+                                               (unsigned long)it->poolsCreated));
+    m_list->SetItem(index, 9, wxString::Format(wxT("%ld"), it->peakMemoryKb));
+
+    wxString calls;
+    std::map<std::string, size_t>::const_iterator call;
+    for (call = it->context.calls.begin(); call != it->context.calls.end(); ++call)
+    {
+      if (!calls.IsEmpty())
+        calls += wxT(", ");
+      calls += wxString::Format(wxT("%s=%lu"),
+                                wxString(call->first.c_str(), wxConvUTF8).c_str(),
+                                (unsigned long)call->second);
+    }
+    m_list->SetItem(index, 10, calls);
+  }
+
+  bool empty = entries.empty() && TheActionStatistics.GetStalls().empty();
+  m_buttonExport->Enable(!empty);
+  m_buttonClear->Enable(!empty);
+}
+
+void
+ActionStatisticsDlg::OnExport(wxCommandEvent & WXUNUSED(event))
+{
+  wxFileDialog dlg(this, _("Export action statistics"), wxEmptyString,
+                   wxT("statistics.json"), EXPORT_WILDCARD,
+                   wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+  if (dlg.ShowModal() != wxID_OK)
+    return;
+
+  if (!TheActionStatistics.Export(dlg.GetPath()))
+  {
+    wxString msg;
+    msg.Printf(_("Could not write \"%s\"."), dlg.GetPath().c_str());
+    wxMessageBox(msg, _("Error"), wxOK | wxICON_ERROR, this);
+  }
+}
+
+void
+ActionStatisticsDlg::OnClear(wxCommandEvent & WXUNUSED(event))
+{
+  TheActionStatistics.Clear();
+  FillList();
+}
+
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
@@ -54,15 +54,7 @@ AddAction::Perform()
 {
   svn::Client client(GetContext());
 
-  const svn::PathVector & v = GetTargets().targets();
-  svn::PathVector::const_iterator it;
-
-  for (it = v.begin(); it != v.end(); it++)
-  {
-    const svn::Path & path = *it;
-
-    client.add(path.c_str(), false);
-  }
+  client.add(GetTargets(), false);
 
   return true;
 }
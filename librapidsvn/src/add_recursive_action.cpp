@@ -54,40 +54,30 @@ AddRecursiveAction::Perform()
 {
   svn::Client client(GetContext());
 
-  // with recursion we have to cycle over the selection
-  // and find unversioned subdirectories and add them
+  // a single crawl finds the unversioned items; everything
+  // below them is added along with them
   svn::StatusFilter filter;
   filter.showUnversioned = true;
-  
-  svn::PathVector paths = GetTargets().targets();
 
-  do
+  const svn::PathVector & paths = GetTargets().targets();
+  svn::PathVector::const_iterator it;
+  svn::Targets unversioned;
+
+  for (it = paths.begin(); it != paths.end(); it++)
   {
-    svn::PathVector nextPaths;
-    svn::PathVector::const_iterator it;
-
-    for (it = paths.begin(); it != paths.end(); it++)
-    {
-      const svn::Path & path = *it;
-      
-      svn::StatusEntries entries;
-      client.status (path.c_str(), filter, true, false, entries);
-      
-      svn::StatusEntries::const_iterator itStatus;
-      
-      for (itStatus = entries.begin(); itStatus != entries.end(); itStatus++)
-      {
-        const svn::Status & status = *itStatus;
-        client.add(status.path(), false);
-        nextPaths.push_back(status.path());
-      }
-    }
-
-    // for the next round we copy the newly added files/dirs
-    // and find subdirectories there
-    paths = nextPaths;
+    const svn::Path & path = *it;
+
+    svn::StatusEntries entries;
+    client.status(path.c_str(), filter, true, false, entries);
+
+    svn::StatusEntries::const_iterator itStatus;
+
+    for (itStatus = entries.begin(); itStatus != entries.end(); itStatus++)
+      unversioned.push_back(itStatus->path());
   }
-  while (paths.size() > 0);
+
+  if (unversioned.size() > 0)
+    client.add(unversioned, true);
 
   return true;
 }
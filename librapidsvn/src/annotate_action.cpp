@@ -48,6 +48,9 @@ public:
   AnnotateData data;
   wxWindow * parent;
 
+  /** the file to annotate */
+  svn::Path path;
+
   Data(Action * action_)
       : action(action_)
   {
@@ -100,40 +103,36 @@ AnnotateAction::Prepare()
     return false;
   }
 
-  { // Busy cursor scope
-    wxBusyCursor busyCursor;
-
-    // Now Annotate
-    // If the data's path variable is set, then use that value
-    // Otherwise use the value of GetTarget()
-    // The data's path variable is set on the log dialog
-    svn::AnnotatedFile * annotatedFile = NULL;
-    svn::Path path;
-    if (m->data.path.IsEmpty())
-    {
-      path = GetTarget();
-    }
-    else
-    {
-      path = PathUtf8(m->data.path);
-    }
-    annotatedFile = m->GetAnnotatedFile(path);
-    svn::AnnotatedFile::const_iterator it;
-    for (it=annotatedFile->begin(); it!=annotatedFile->end(); it++)
-    {
-      svn::AnnotateLine line(*it);
-      dlg.AddAnnotateLine(line.revision(), Utf8ToLocal(line.author()),
-                          Utf8ToLocal(line.line()));
-    }
-    dlg.AutoSizeColumn();
-    delete annotatedFile;
+  // If the data's path variable is set, then use that value
+  // Otherwise use the value of GetTarget()
+  // The data's path variable is set on the log dialog
+  if (m->data.path.IsEmpty())
+  {
+    m->path = GetTarget();
   }
+  else
+  {
+    m->path = PathUtf8(m->data.path);
+  }
+
+  // Now Annotate. The dialog is filled when it's done
+  dlg.SetWaiting(true);
+  StartPrepareInBackground(&dlg);
 
   dlg.ShowModal();
+  WaitPrepareInBackground(true);
 
   return true;
 }
 
+void
+AnnotateAction::PrepareInBackground()
+{
+  svn::AnnotatedFile * annotatedFile = m->GetAnnotatedFile(m->path);
+
+  ActionEvent::Post(GetPrepareReceiver(), TOKEN_PREPARE_PROGRESS, annotatedFile);
+}
+
 bool
 AnnotateAction::Perform()
 {
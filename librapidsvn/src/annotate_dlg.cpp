@@ -22,14 +22,22 @@
  * ====================================================================
  */
 
+// wxWidgets
+#include "wx/wx.h"
+
+// svncpp
+#include "svncpp/annotate_line.hpp"
+#include "svncpp/client.hpp"
+
 // app
 #include "annotate_dlg.hpp"
+#include "ids.hpp"
 #include "utils.hpp"
 
 
 AnnotateDlg::AnnotateDlg(wxWindow * parent,
                          const wxString & caption)
-  : AnnotateDlgBase(parent, -1, caption)
+  : AnnotateDlgBase(parent, -1, caption), m_caption(caption)
 {
   m_list->InsertColumn(0, _("Revision"), wxLIST_FORMAT_RIGHT);
   m_list->InsertColumn(1, _("Author"), wxLIST_FORMAT_RIGHT);
@@ -58,6 +66,9 @@ AnnotateDlg::AnnotateDlg(wxWindow * parent,
   CentreOnParent();
 
   Maximize();
+
+  Connect(ACTION_EVENT, wxEVT_COMMAND_MENU_SELECTED,
+          wxCommandEventHandler(AnnotateDlg::OnActionEvent));
 }
 
 void
@@ -86,6 +97,55 @@ AnnotateDlg::AutoSizeColumn()
   m_list->SetColumnWidth(4, wxLIST_AUTOSIZE);
 }
 
+void
+AnnotateDlg::SetWaiting(bool waiting)
+{
+  if (waiting)
+    SetTitle(m_caption + _(" (running...)"));
+  else
+    SetTitle(m_caption);
+}
+
+void
+AnnotateDlg::OnActionEvent(wxCommandEvent & event)
+{
+  switch (event.GetInt())
+  {
+  case TOKEN_PREPARE_PROGRESS:
+  {
+    svn::AnnotatedFile * annotatedFile =
+      static_cast<svn::AnnotatedFile *>(event.GetClientData());
+
+    if (annotatedFile != 0)
+    {
+      svn::AnnotatedFile::const_iterator it;
+      for (it=annotatedFile->begin(); it!=annotatedFile->end(); it++)
+      {
+        const svn::AnnotateLine & line = *it;
+        AddAnnotateLine(line.revision(), Utf8ToLocal(line.author()),
+                        Utf8ToLocal(line.line()));
+      }
+      AutoSizeColumn();
+      delete annotatedFile;
+    }
+  }
+  break;
+
+  case TOKEN_PREPARE_DONE:
+  {
+    SetWaiting(false);
+
+    wxString error(event.GetString());
+    if (!error.IsEmpty() && IsModal())
+    {
+      wxMessageBox(error, _("Error"), wxOK | wxICON_ERROR, this);
+      EndModal(wxID_CANCEL);
+    }
+  }
+  break;
+  }
+}
+
 /* -----------------------------------------------------------------
  * local variables:
  * eval: (load-file "../rapidsvn-dev.el")
@@ -33,6 +33,7 @@
 
 
 // app
+#include "action_event.hpp"
 #include "commit_action.hpp"
 #include "commit_dlg.hpp"
 #include "ids.hpp"
@@ -49,24 +50,59 @@ CommitAction::Prepare()
   if (!Action::Prepare())
     return false;
 
-  svn::Client client (GetContext());
   const svn::StatusSel& statusSel = GetStatusSel();
-  const svn::PathVector & selectedTargets = statusSel.targets();
   svn::PathVector targets;
-  svn::PathVector::const_iterator it;
   bool recursive = false;
 
-  // for local files we wanna filter out the unmodified files
-  if (statusSel.hasUrl())
+  // for local files we wanna filter out the unmodified files.
+  // That's done in the background while the dialog is shown
+  bool scanning = !statusSel.hasUrl();
+
+  if (!scanning)
   {
     // but we can add all remote files immediately
-    targets = selectedTargets;
+    targets = statusSel.targets();
 
     // recursive can be on
     recursive = true;
   }
+
+  CommitDlg dlg(GetParent(), targets, scanning);
+  dlg.SetRecursive(recursive);
+
+  if (scanning)
+    StartPrepareInBackground(&dlg);
+
+  bool ok = dlg.ShowModal() == wxID_OK;
+  WaitPrepareInBackground(!ok);
+
+  if (!ok)
+    return false;
+
+  m_recursive = dlg.GetRecursive();
+  m_message = dlg.GetMessage();
+  m_keepLocks = dlg.GetKeepLocks();
+  m_files = dlg.GetSelectedFilenames();
+
+  // are there any files left over to commit?
+  if (m_files.size() == 0)
+    return false;
+
+  return true;
+}
+
+void
+CommitAction::PrepareInBackground()
+{
+  svn::Client client(GetContext());
+  const svn::PathVector & selectedTargets = GetStatusSel().targets();
+  svn::PathVector::const_iterator it;
+
   for (it = selectedTargets.begin(); it != selectedTargets.end(); it++)
   {
+    if (IsPrepareCancelled())
+      break;
+
     svn::Path path = *it;
 
     svn::StatusFilter filter;
@@ -78,35 +114,19 @@ CommitAction::Prepare()
     svn::StatusEntries entries;
     client.status(path.c_str(), filter, true, false, entries);
 
-    svn::StatusEntries::iterator it;
-    for (it = entries.begin(); it != entries.end(); it++)
+    // we dont need recursive since we add all the
+    // files that are available
+    svn::PathVector * files = new svn::PathVector();
+    svn::StatusEntries::iterator entryIt;
+    for (entryIt = entries.begin(); entryIt != entries.end(); entryIt++)
     {
-      svn::Status& status = *it;
+      svn::Status& status = *entryIt;
 
-      targets.push_back(status.path());
+      files->push_back(status.path());
     }
 
-    // we dont need recursice since we added all the
-    // files that are available
-    recursive = false;
+    ActionEvent::Post(GetPrepareReceiver(), TOKEN_PREPARE_PROGRESS, files);
   }
-
-  CommitDlg dlg(GetParent(), targets);
-  dlg.SetRecursive(recursive);
-
-  if (dlg.ShowModal() != wxID_OK)
-    return false;
-
-  m_recursive = dlg.GetRecursive();
-  m_message = dlg.GetMessage();
-  m_keepLocks = dlg.GetKeepLocks();
-  m_files = dlg.GetSelectedFilenames();
-
-  // are there any files left over to commit?
-  if (m_files.size() == 0)
-    return false;
-
-  return true;
 }
 
 bool
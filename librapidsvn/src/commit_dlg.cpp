@@ -41,9 +41,11 @@
 #include "ids.hpp"
 
 
-CommitDlg::CommitDlg(wxWindow* parent, const svn::PathVector & filenames)
+CommitDlg::CommitDlg(wxWindow* parent, const svn::PathVector & filenames,
+                     bool scanning)
   : CommitDlgBase(parent, -1, _("Commit"), wxDefaultPosition, wxDefaultSize,
-                  wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER)
+                  wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+    m_scanning(scanning)
 {
   m_textMessage->SetMinSize(wxSize(GetCharWidth() * 60, GetCharHeight() * 8));
   m_textMessage->SetSize(GetCharWidth() * 80, GetCharHeight() * 10);
@@ -56,24 +58,22 @@ CommitDlg::CommitDlg(wxWindow* parent, const svn::PathVector & filenames)
   HistoryValidator valHistory(HISTORY_COMMIT_LOG, 0, true);
   m_comboHistory->SetValidator(valHistory);
 
-  m_usesFilenames = filenames.size() > 0;
+  m_usesFilenames = scanning || (filenames.size() > 0);
   if (!m_usesFilenames)
     m_mainSizer->Show(m_filesSizer, false);
   else
   {
     m_checkListFiles->Clear();
-    
-    svn::PathVector::const_iterator it;
-    
-    for(it=filenames.begin(); it!=filenames.end(); it++)
-    {
-      const svn::Path & path = *it;
-      int i = m_checkListFiles->Append(PathToNative(path));
-      
-      m_checkListFiles->Check(i, true);
-    }
+    AddFiles(filenames);
+  }
 
-    CheckFilesButtons();
+  if (m_scanning)
+  {
+    // wait for the complete list of files
+    SetTitle(_("Commit (searching for modified files...)"));
+    m_buttonOK->Enable(false);
+    Connect(ACTION_EVENT, wxEVT_COMMAND_MENU_SELECTED,
+            wxCommandEventHandler(CommitDlg::OnActionEvent));
   }
   
   wxGenericValidator valRecursive(&m_recursive);
@@ -234,8 +234,69 @@ CommitDlg::CheckFilesButtons(void)
   wxArrayInt selection;
   m_checkListFiles->GetSelections(selection);
 
+  // no diff while the scan uses the context
   m_buttonToggle->Enable(selection.size() > 0);
-  m_buttonDiff->Enable(selection.size() == 1);
+  m_buttonDiff->Enable(!m_scanning && (selection.size() == 1));
+}
+
+
+void
+CommitDlg::AddFiles(const svn::PathVector & filenames)
+{
+  svn::PathVector::const_iterator it;
+
+  for(it=filenames.begin(); it!=filenames.end(); it++)
+  {
+    const svn::Path & path = *it;
+    int i = m_checkListFiles->Append(PathToNative(path));
+
+    m_checkListFiles->Check(i, true);
+  }
+
+  CheckFilesButtons();
+}
+
+
+void
+CommitDlg::OnActionEvent(wxCommandEvent & event)
+{
+  switch (event.GetInt())
+  {
+  case TOKEN_PREPARE_PROGRESS:
+  {
+    svn::PathVector * filenames =
+      static_cast<svn::PathVector *>(event.GetClientData());
+
+    if (filenames != 0)
+    {
+      AddFiles(*filenames);
+      delete filenames;
+    }
+  }
+  break;
+
+  case TOKEN_PREPARE_DONE:
+  {
+    m_scanning = false;
+    SetTitle(_("Commit"));
+
+    wxString error(event.GetString());
+    if (!error.IsEmpty())
+    {
+      // still open? otherwise the error doesn't matter anymore
+      if (IsModal())
+      {
+        wxMessageBox(error, _("Error"), wxOK | wxICON_ERROR, this);
+        EndModal(wxID_CANCEL);
+      }
+      return;
+    }
+
+    m_buttonOK->Enable(true);
+    CheckFilesButtons();
+  }
+  break;
+  }
 }
 
 
@@ -31,6 +31,7 @@
 #include "create_repos_action.hpp"
 #include "create_repos_dlg.hpp"
 #include "ids.hpp"
+#include "process_runner.hpp"
 #include "svn_executables.hpp"
 
 CreateRepositoryAction::CreateRepositoryAction(wxWindow * parent)
@@ -97,34 +98,12 @@ CreateRepositoryAction::Prepare()
   wxString filename(dlg.GetFilename());
   cmd += wxString::Format(wxT(" \"%s\""), filename.c_str());
 
-  bool addBookmark = dlg.GetAddBookmark();
+  // svnadmin runs in the background, its output is
+  // written to the log
+  ProcessData * data = new ProcessData(cmd);
 
-  // we can run svnadmin from the main thread as this should
-  // not take too long (< 1 second)
-  Trace(wxString::Format(_("Running command %s:"), cmd.c_str()));
-  wxArrayString output;
-
-  int result = ::wxExecute(cmd, output, output, wxEXEC_SYNC);
-
-  if (result < 0)
-  {
-    Trace(_("Error running svnadmin"));
-    return false;
-  }
-
-  wxArrayString::const_iterator it;
-  for (it=output.begin(); it != output.end(); it++)
-    Trace(*it);
-
-  if (result > 0)
-  {
-    Trace(_("The svnadmin command was not successful."));
-    return false;
-  }
-
-  
-  // now add a bookmark
-  if (addBookmark)
+  // add a bookmark when it's done
+  if (dlg.GetAddBookmark())
   {
     // this works for simple bookmarks like "/foo/bar"
     // or "c:/foo". 
@@ -138,9 +117,11 @@ CreateRepositoryAction::Prepare()
     wxFileName intern(filename);
     repoBookmark += intern.GetFullPath(wxPATH_UNIX);
 
-    ActionEvent::Post(GetParent(), TOKEN_ADD_BOOKMARK, repoBookmark);
+    data->doneToken = TOKEN_ADD_BOOKMARK;
+    data->doneMessage = repoBookmark;
   }
 
+  ActionEvent::Post(GetParent(), TOKEN_RUN_COMMAND, data);
 
   return true;
 }
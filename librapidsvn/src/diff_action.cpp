@@ -31,6 +31,7 @@
 #include "svncpp/entry.hpp"
 #include "svncpp/exception.hpp"
 #include "svncpp/info.hpp"
+#include "svncpp/output_sink.hpp"
 #include "svncpp/status.hpp"
 #include "svncpp/targets.hpp"
 #include "svncpp/url.hpp"
@@ -40,6 +41,7 @@
 #include "diff_action.hpp"
 #include "diff_data.hpp"
 #include "diff_dlg.hpp"
+#include "diff_viewer.hpp"
 #include "ids.hpp"
 #include "preferences.hpp"
 #include "utils.hpp"
@@ -54,14 +56,23 @@ public:
   DiffData diffData;
   wxWindow * parent;
 
+  /** feeds the built-in viewer, if used */
+  svn::OutputSink * sink;
+
   Data(Action * action_, wxWindow * parent_)
-      : action(action_), showDialog(true), parent(parent_)
+      : action(action_), showDialog(true), parent(parent_), sink(0)
   {
   }
 
   Data(Action * action_, wxWindow * parent_, DiffData & data)
-      : action(action_), showDialog(false), diffData(data), parent(parent_)
+      : action(action_), showDialog(false), diffData(data), parent(parent_),
+      sink(0)
+  {
+  }
+
+  ~Data()
   {
+    delete sink;
   }
 
   svn::Context *
@@ -133,7 +144,7 @@ public:
     {
     case DiffData::WITH_BASE:
       dstFile1 = path;
-      dstFile2 = action->GetPathAsTempFile(getPath1(path), svn::Revision::BASE);
+      dstFile2 = action->GetBaseFile(getPath1(path));
 
       break;
 
@@ -185,12 +196,61 @@ public:
 
     ActionEvent::Post(parent, TOKEN_CMD_DIFF, cmd);
   }
+
+  /**
+   * performs the diff operation on a path (file or
+   * directory) and streams the unified diff into
+   * the built-in viewer
+   */
+  void
+  diffTargetUnified(const svn::Path & path)
+  {
+    svn::Client client(GetContext());
+    svn::Path tmpPath(svn::Path::getTempDir());
+    tmpPath.addComponent("rapidsvn-diff");
+
+    wxString msg;
+    msg.Printf(_("Diff %s"), Utf8ToLocal(path.c_str()).c_str());
+    Trace(msg);
+
+    switch (diffData.compareType)
+    {
+    case DiffData::WITH_BASE:
+      client.diff(*sink, tmpPath, path,
+                  svn::Revision::BASE, svn::Revision::WORKING,
+                  true, false, false);
+      break;
+
+    case DiffData::WITH_HEAD:
+      client.diff(*sink, tmpPath, getPath1(path), path,
+                  svn::Revision::HEAD, svn::Revision::WORKING,
+                  true, false, false);
+      break;
+
+    case DiffData::WITH_DIFFERENT_REVISION:
+      client.diff(*sink, tmpPath, getPath1(path), path,
+                  diffData.revision1, svn::Revision::WORKING,
+                  true, false, false);
+      break;
+
+    case DiffData::TWO_REVISIONS:
+      client.diff(*sink, tmpPath, getPath1(path), getPath2(path),
+                  diffData.revision1, diffData.revision2,
+                  true, false, false);
+      break;
+
+    default:
+      // do nothing!
+      break;
+    }
+  }
 };
 
-DiffAction::DiffAction(wxWindow * parent)
+DiffAction::DiffAction(wxWindow * parent, bool useViewer)
     : Action(parent, _("Diff"), DONT_UPDATE)
 {
   m = new Data(this, parent);
+  m->diffData.useViewer = useViewer;
 }
 
 DiffAction::DiffAction(wxWindow * parent, DiffData & data)
@@ -210,13 +270,11 @@ DiffAction::Prepare()
   if (!Action::Prepare())
     return false;
 
+  // without a diff tool we can still show the diff
+  // in the built-in viewer
   Preferences prefs;
-
   if (prefs.diffTool.Length() == 0)
-  {
-    TraceError(_("No diff tool set in the preferences"));
-    return false;
-  }
+    m->diffData.useViewer = true;
 
   if (m->showDialog)
   {
@@ -259,7 +317,22 @@ DiffAction::Prepare()
     if (dlg.ShowModal() != wxID_OK)
       return false;
 
+    bool useViewer = m->diffData.useViewer;
     m->diffData = dlg.GetData();
+    m->diffData.useViewer = useViewer;
+  }
+
+  if (m->diffData.useViewer)
+  {
+    wxString title(_("Diff"));
+    if (GetTargets().size() == 1)
+      title += wxT(": ") + Utf8ToLocal(GetTarget().c_str());
+
+    DiffViewer * viewer = new DiffViewer(GetParent(), title);
+    viewer->Show();
+
+    delete m->sink;
+    m->sink = viewer->CreateSink();
   }
 
   return true;
@@ -268,6 +341,26 @@ DiffAction::Prepare()
 bool
 DiffAction::Perform()
 {
+  if (m->sink != 0)
+  {
+    if (m->diffData.path.IsEmpty())
+    {
+      const svn::PathVector & v = GetTargets();
+      svn::PathVector::const_iterator it;
+
+      for (it=v.begin(); it != v.end(); it++)
+        m->diffTargetUnified(*it);
+    }
+    else
+      m->diffTargetUnified(PathUtf8(m->diffData.path));
+
+    // this tells the viewer the diff is complete
+    delete m->sink;
+    m->sink = 0;
+
+    return true;
+  }
+
   if (m->diffData.path.IsEmpty())
   {
     const svn::PathVector & v = GetTargets();
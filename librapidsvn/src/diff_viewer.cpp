@@ -0,0 +1,709 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// stl
+#include <algorithm>
+#include <cstring>
+#include "svncpp/string_wrapper.hpp"
+#include "svncpp/vector_wrapper.hpp"
+
+// wxWidgets
+#include "wx/wx.h"
+#include "wx/file.h"
+#include "wx/filename.h"
+#include "wx/listctrl.h"
+#include "wx/thread.h"
+#include "wx/timer.h"
+
+// svncpp
+#include "svncpp/output_sink.hpp"
+
+// app
+#include "diff_viewer.hpp"
+
+/**
+ * interval (in milliseconds) in which the window
+ * picks up new diff output
+ */
+static const int FEED_INTERVAL = 200;
+
+/**
+ * a sink that is not running in the main thread
+ * blocks once this much data is waiting for the window
+ */
+static const size_t MAX_PENDING = 4 * 1024 * 1024;
+
+/**
+ * size of the blocks the visible lines are read
+ * from the spooled diff output
+ */
+static const size_t READ_BLOCK_SIZE = 64 * 1024;
+
+enum
+{
+  ID_DiffViewer_Timer = 0x2100,
+  ID_DiffViewer_Files,
+  ID_DiffViewer_PrevHunk,
+  ID_DiffViewer_NextHunk
+};
+
+/**
+ * Data shared between the window and the sink. The
+ * window and the sink might be destroyed in any order,
+ * whichever comes last deletes the feed.
+ */
+struct DiffFeed
+{
+  wxMutex mutex;
+  std::string pending;
+  bool closed;
+  bool finished;
+  int refCount;
+
+  DiffFeed()
+      : closed(false), finished(false), refCount(1)
+  {
+  }
+
+  void
+  AddRef()
+  {
+    wxMutexLocker lock(mutex);
+    refCount++;
+  }
+
+  void
+  Release()
+  {
+    bool last;
+    {
+      wxMutexLocker lock(mutex);
+      last = --refCount == 0;
+    }
+
+    if (last)
+      delete this;
+  }
+};
+
+class DiffFeedSink : public svn::OutputSink
+{
+public:
+  DiffFeedSink(DiffFeed * feed)
+      : m_feed(feed)
+  {
+    m_feed->AddRef();
+  }
+
+  virtual ~DiffFeedSink()
+  {
+    {
+      wxMutexLocker lock(m_feed->mutex);
+      m_feed->finished = true;
+    }
+    m_feed->Release();
+  }
+
+  virtual bool
+  write(const char * data, size_t len)
+  {
+    for (;;)
+    {
+      {
+        wxMutexLocker lock(m_feed->mutex);
+
+        if (m_feed->closed)
+          return false;
+
+        // the main thread cannot wait for itself
+        if ((m_feed->pending.length() < MAX_PENDING) || wxThread::IsMain())
+        {
+          m_feed->pending.append(data, len);
+          return true;
+        }
+      }
+
+      // give the window a chance to catch up
+      wxMilliSleep(FEED_INTERVAL / 4);
+    }
+  }
+
+private:
+  DiffFeed * m_feed;
+};
+
+/**
+ * Classification of a line of unified diff output
+ */
+enum DiffLineKind
+{
+  LINE_CONTEXT = 0,
+  LINE_FILE,
+  LINE_HEADER,
+  LINE_HUNK,
+  LINE_ADDED,
+  LINE_REMOVED
+};
+
+/**
+ * The diff output received so far together with an
+ * index of lines, files and hunks.
+ *
+ * The output itself is spooled to a temporary file and
+ * only the index is kept in memory, the visible lines are
+ * read back on demand. If no temporary file can be created
+ * the output is kept in memory instead.
+ */
+struct DiffText
+{
+  struct Line
+  {
+    wxFileOffset start;
+    size_t length;
+    DiffLineKind kind;
+
+    Line(wxFileOffset start_, size_t length_, DiffLineKind kind_)
+        : start(start_), length(length_), kind(kind_)
+    {
+    }
+  };
+
+  struct File
+  {
+    std::string name;
+    long line;
+
+    File(const std::string & name_, long line_)
+        : name(name_), line(line_)
+    {
+    }
+  };
+
+  std::vector<Line> lines;
+  std::vector<File> files;
+  std::vector<long> hunks;
+
+  /** true between a file header and its first hunk */
+  bool inHeader;
+
+  DiffText()
+      : inHeader(false), m_memoryStart(wxInvalidOffset),
+      m_tailStart(0), m_blockStart(0)
+  {
+    m_spoolName = wxFileName::CreateTempFileName(
+                    wxT("rapidsvn-diff"), &m_spool);
+
+    if (m_spoolName.IsEmpty() ||
+        !m_spoolReader.Open(m_spoolName, wxFile::read))
+    {
+      m_spool.Close();
+      m_memoryStart = 0;
+    }
+  }
+
+  ~DiffText()
+  {
+    m_spool.Close();
+    m_spoolReader.Close();
+
+    if (!m_spoolName.IsEmpty())
+      ::wxRemoveFile(m_spoolName);
+  }
+
+  void
+  Append(const std::string & data)
+  {
+    if (m_spool.IsOpened() &&
+        (m_spool.Write(data.c_str(), data.length()) != data.length()))
+    {
+      // disk full? continue in memory, starting with the
+      // incomplete line so no line is split between both
+      m_spool.Close();
+      m_memory = m_tail;
+      m_memoryStart = m_tailStart;
+    }
+
+    if (!m_spool.IsOpened())
+      m_memory.append(data);
+
+    // only the last incomplete line stays in memory
+    size_t pos = m_tail.length();
+    m_tail.append(data);
+
+    size_t parsed = 0;
+    while ((pos = m_tail.find('\n', pos)) != std::string::npos)
+    {
+      AddLine(m_tail.c_str() + parsed, pos - parsed, m_tailStart + parsed);
+      parsed = ++pos;
+    }
+
+    m_tail.erase(0, parsed);
+    m_tailStart += parsed;
+  }
+
+  /**
+   * index the remaining data, even if it doesn't
+   * end with a newline
+   */
+  void
+  Finish()
+  {
+    if (!m_tail.empty())
+    {
+      AddLine(m_tail.c_str(), m_tail.length(), m_tailStart);
+      m_tailStart += m_tail.length();
+      m_tail.clear();
+    }
+  }
+
+  static bool
+  StartsWith(const char * line, size_t length, const char * prefix)
+  {
+    size_t prefixLength = strlen(prefix);
+
+    if (length < prefixLength)
+      return false;
+
+    return strncmp(line, prefix, prefixLength) == 0;
+  }
+
+  void
+  AddFile(const char * line, size_t length, size_t prefixLength)
+  {
+    std::string name(line + prefixLength, length - prefixLength);
+    if (!name.empty() && (name[name.length() - 1] == '\r'))
+      name.erase(name.length() - 1);
+
+    // property changes of the last file belong to the same entry
+    if (!files.empty() && (files.back().name == name))
+      return;
+
+    files.push_back(File(name, (long)lines.size()));
+  }
+
+  void
+  AddLine(const char * line, size_t length, wxFileOffset start)
+  {
+    DiffLineKind kind = LINE_CONTEXT;
+
+    static const char INDEX[] = "Index: ";
+    static const char PROPS[] = "Property changes on: ";
+
+    if (StartsWith(line, length, INDEX))
+    {
+      kind = LINE_FILE;
+      AddFile(line, length, sizeof(INDEX) - 1);
+      inHeader = true;
+    }
+    else if (StartsWith(line, length, PROPS))
+    {
+      kind = LINE_FILE;
+      AddFile(line, length, sizeof(PROPS) - 1);
+      inHeader = true;
+    }
+    else if (StartsWith(line, length, "@@"))
+    {
+      kind = LINE_HUNK;
+      hunks.push_back((long)lines.size());
+      inHeader = false;
+    }
+    else if (inHeader)
+      kind = LINE_HEADER;
+    else if (length > 0)
+    {
+      if (line[0] == '+')
+        kind = LINE_ADDED;
+      else if (line[0] == '-')
+        kind = LINE_REMOVED;
+    }
+
+    lines.push_back(Line(start, length, kind));
+  }
+
+  static wxString
+  Decode(const char * data, size_t length)
+  {
+    wxString str(data, wxConvUTF8, length);
+
+    // not valid utf8? show the raw bytes
+    if (str.IsEmpty() && (length > 0))
+      str = wxString(data, wxConvISO8859_1, length);
+
+    return str;
+  }
+
+  wxString
+  GetLine(long index) const
+  {
+    const Line & line = lines[index];
+    const char * data = ReadLine(line);
+    if (data == NULL)
+      return wxEmptyString;
+
+    wxString str(Decode(data, line.length));
+
+    // Windows displays tabs and line breaks as squares
+    str.Replace(wxT("\r"), wxT(""));
+    str.Replace(wxT("\t"), wxT("    "));
+
+    return str;
+  }
+
+private:
+  wxFile m_spool;
+  mutable wxFile m_spoolReader;
+  wxString m_spoolName;
+
+  /**
+   * the output from @a m_memoryStart on, if it isn't
+   * spooled (wxInvalidOffset: everything is spooled)
+   */
+  std::string m_memory;
+  wxFileOffset m_memoryStart;
+
+  /** data after the last newline and its offset */
+  std::string m_tail;
+  wxFileOffset m_tailStart;
+
+  /** the part of the spool file that was read last */
+  mutable std::string m_block;
+  mutable wxFileOffset m_blockStart;
+
+  /**
+   * @return the bytes of @a line or NULL if they cannot be read.
+   *         The spool file is read in blocks, so scrolling through
+   *         neighbouring lines doesn't hit the disk for every line
+   */
+  const char *
+  ReadLine(const Line & line) const
+  {
+    if ((m_memoryStart != wxInvalidOffset) && (line.start >= m_memoryStart))
+      return m_memory.c_str() + (line.start - m_memoryStart);
+
+    wxFileOffset end = line.start + (wxFileOffset)line.length;
+    if ((line.start < m_blockStart) ||
+        (end > m_blockStart + (wxFileOffset)m_block.length()))
+    {
+      size_t size = std::max(READ_BLOCK_SIZE, line.length);
+      m_block.resize(size);
+      m_blockStart = line.start;
+
+      ssize_t read = wxInvalidOffset;
+      if (m_spoolReader.Seek(line.start) != wxInvalidOffset)
+        read = m_spoolReader.Read(&m_block[0], size);
+
+      if ((read == wxInvalidOffset) || ((size_t)read < line.length))
+      {
+        m_block.clear();
+        return NULL;
+      }
+
+      m_block.resize(read);
+    }
+
+    return m_block.c_str() + (line.start - m_blockStart);
+  }
+};
+
+/**
+ * Virtual list that renders only the visible lines
+ * of a @a DiffText
+ */
+class DiffLineList : public wxListView
+{
+public:
+  DiffLineList(wxWindow * parent, const DiffText & text)
+      : wxListView(parent, -1, wxDefaultPosition, wxDefaultSize,
+                   wxLC_REPORT | wxLC_VIRTUAL | wxLC_NO_HEADER |
+                   wxLC_SINGLE_SEL),
+      m_text(text)
+  {
+    wxFont font(GetFont().GetPointSize(), wxFONTFAMILY_TELETYPE,
+                wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    wxFont boldFont(GetFont().GetPointSize(), wxFONTFAMILY_TELETYPE,
+                    wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
+    SetFont(font);
+
+    m_attrFile.SetFont(boldFont);
+    m_attrFile.SetBackgroundColour(wxColour(224, 224, 224));
+    m_attrHeader.SetTextColour(wxColour(96, 96, 96));
+    m_attrHunk.SetTextColour(wxColour(0, 0, 160));
+    m_attrHunk.SetBackgroundColour(wxColour(236, 240, 255));
+    m_attrAdded.SetTextColour(wxColour(0, 128, 0));
+    m_attrRemoved.SetTextColour(wxColour(176, 0, 0));
+
+    InsertColumn(0, wxEmptyString);
+    SetColumnWidth(0, 4000);
+  }
+
+  /**
+   * scroll @a index to the top of the list and select it
+   */
+  void
+  ScrollToLine(long index)
+  {
+    long count = GetItemCount();
+    if ((index < 0) || (index >= count))
+      return;
+
+    long bottom = std::min(count - 1, index + GetCountPerPage() - 1);
+    EnsureVisible(bottom);
+    EnsureVisible(index);
+
+    Select(index);
+    Focus(index);
+  }
+
+  /**
+   * @return the line the user is looking at
+   */
+  long
+  GetCurrentLine() const
+  {
+    long index = GetFocusedItem();
+    if (index == -1)
+      index = GetTopItem();
+
+    return index;
+  }
+
+protected:
+  virtual wxString
+  OnGetItemText(long item, long WXUNUSED(column)) const
+  {
+    if ((item < 0) || (item >= (long)m_text.lines.size()))
+      return wxEmptyString;
+
+    return m_text.GetLine(item);
+  }
+
+  virtual wxListItemAttr *
+  OnGetItemAttr(long item) const
+  {
+    if ((item < 0) || (item >= (long)m_text.lines.size()))
+      return 0;
+
+    switch (m_text.lines[item].kind)
+    {
+    case LINE_FILE:
+      return &m_attrFile;
+    case LINE_HEADER:
+      return &m_attrHeader;
+    case LINE_HUNK:
+      return &m_attrHunk;
+    case LINE_ADDED:
+      return &m_attrAdded;
+    case LINE_REMOVED:
+      return &m_attrRemoved;
+    default:
+      return 0;
+    }
+  }
+
+private:
+  const DiffText & m_text;
+  mutable wxListItemAttr m_attrFile;
+  mutable wxListItemAttr m_attrHeader;
+  mutable wxListItemAttr m_attrHunk;
+  mutable wxListItemAttr m_attrAdded;
+  mutable wxListItemAttr m_attrRemoved;
+};
+
+
+struct DiffViewer::Data
+{
+public:
+  DiffFeed * feed;
+  DiffText text;
+  wxTimer timer;
+  DiffLineList * lineList;
+  wxListBox * fileList;
+
+  Data(DiffViewer * window)
+      : feed(new DiffFeed()), timer(window, ID_DiffViewer_Timer),
+      lineList(0), fileList(0)
+  {
+  }
+
+  ~Data()
+  {
+    {
+      wxMutexLocker lock(feed->mutex);
+      feed->closed = true;
+    }
+    feed->Release();
+  }
+
+  void
+  UpdateStatus(DiffViewer * window, bool finished)
+  {
+    wxString status;
+    status.Printf(_("%lu files, %lu hunks, %lu lines"),
+                  (unsigned long)text.files.size(),
+                  (unsigned long)text.hunks.size(),
+                  (unsigned long)text.lines.size());
+
+    if (!finished)
+      status += wxT(" ") + wxString(_("(loading...)"));
+
+    window->SetStatusText(status);
+  }
+};
+
+
+BEGIN_EVENT_TABLE(DiffViewer, wxFrame)
+  EVT_TIMER(ID_DiffViewer_Timer, DiffViewer::OnTimer)
+  EVT_LISTBOX(ID_DiffViewer_Files, DiffViewer::OnFileSelected)
+  EVT_BUTTON(ID_DiffViewer_PrevHunk, DiffViewer::OnPrevHunk)
+  EVT_BUTTON(ID_DiffViewer_NextHunk, DiffViewer::OnNextHunk)
+END_EVENT_TABLE()
+
+DiffViewer::DiffViewer(wxWindow * parent, const wxString & title)
+    : wxFrame(parent, -1, title, wxDefaultPosition, wxSize(800, 600))
+{
+  m = new Data(this);
+
+  wxPanel * panel = new wxPanel(this);
+
+  wxBoxSizer * buttonSizer = new wxBoxSizer(wxHORIZONTAL);
+  buttonSizer->Add(new wxButton(panel, ID_DiffViewer_PrevHunk,
+                                _("&Previous Hunk")), 0, wxALL, 5);
+  buttonSizer->Add(new wxButton(panel, ID_DiffViewer_NextHunk,
+                                _("&Next Hunk")), 0, wxALL, 5);
+
+  m->fileList = new wxListBox(panel, ID_DiffViewer_Files,
+                              wxDefaultPosition, wxSize(200, -1));
+  m->lineList = new DiffLineList(panel, m->text);
+
+  wxBoxSizer * viewSizer = new wxBoxSizer(wxHORIZONTAL);
+  viewSizer->Add(m->fileList, 0, wxEXPAND | wxALL, 5);
+  viewSizer->Add(m->lineList, 1, wxEXPAND | wxALL, 5);
+
+  wxBoxSizer * mainSizer = new wxBoxSizer(wxVERTICAL);
+  mainSizer->Add(buttonSizer, 0, wxALIGN_LEFT);
+  mainSizer->Add(viewSizer, 1, wxEXPAND);
+
+  panel->SetSizer(mainSizer);
+
+  CreateStatusBar();
+  m->UpdateStatus(this, false);
+
+  m->timer.Start(FEED_INTERVAL);
+}
+
+DiffViewer::~DiffViewer()
+{
+  m->timer.Stop();
+  delete m;
+}
+
+svn::OutputSink *
+DiffViewer::CreateSink()
+{
+  return new DiffFeedSink(m->feed);
+}
+
+void
+DiffViewer::OnTimer(wxTimerEvent & WXUNUSED(event))
+{
+  std::string chunk;
+  bool finished;
+  {
+    wxMutexLocker lock(m->feed->mutex);
+    chunk.swap(m->feed->pending);
+    finished = m->feed->finished;
+  }
+
+  size_t fileCount = m->text.files.size();
+  size_t lineCount = m->text.lines.size();
+
+  if (!chunk.empty())
+    m->text.Append(chunk);
+
+  if (finished)
+  {
+    m->text.Finish();
+    m->timer.Stop();
+  }
+
+  if (m->text.files.size() > fileCount)
+  {
+    wxArrayString names;
+    for (size_t i = fileCount; i < m->text.files.size(); i++)
+    {
+      const std::string & name = m->text.files[i].name;
+      names.Add(DiffText::Decode(name.c_str(), name.length()));
+    }
+
+    m->fileList->Append(names);
+  }
+
+  if (m->text.lines.size() != lineCount)
+    m->lineList->SetItemCount((long)m->text.lines.size());
+
+  m->UpdateStatus(this, finished);
+}
+
+void
+DiffViewer::OnFileSelected(wxCommandEvent & event)
+{
+  int index = event.GetSelection();
+
+  if ((index < 0) || (index >= (int)m->text.files.size()))
+    return;
+
+  m->lineList->ScrollToLine(m->text.files[index].line);
+}
+
+void
+DiffViewer::OnPrevHunk(wxCommandEvent & WXUNUSED(event))
+{
+  const std::vector<long> & hunks = m->text.hunks;
+  long current = m->lineList->GetCurrentLine();
+
+  std::vector<long>::const_iterator it =
+    std::lower_bound(hunks.begin(), hunks.end(), current);
+
+  if (it != hunks.begin())
+    m->lineList->ScrollToLine(*(--it));
+}
+
+void
+DiffViewer::OnNextHunk(wxCommandEvent & WXUNUSED(event))
+{
+  const std::vector<long> & hunks = m->text.hunks;
+  long current = m->lineList->GetCurrentLine();
+
+  std::vector<long>::const_iterator it =
+    std::upper_bound(hunks.begin(), hunks.end(), current);
+
+  if (it != hunks.end())
+    m->lineList->ScrollToLine(*it);
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
@@ -33,6 +33,7 @@
 #include "svncpp/wc.hpp"
 #include "svncpp/path.hpp"
 #include "svncpp/status.hpp"
+#include "svncpp/targets.hpp"
 
 // app
 #include "drag_n_drop_action.hpp"
@@ -284,38 +285,55 @@ DragAndDropAction::Perform()
   svn::Client client(GetContext());
 
   wxString msg = wxEmptyString;
+  svn::Path destDir = PathUtf8(m->m_destination);
+
+  // copy, move and import into the repository are done with
+  // a single commit for all the files
+  svn::Targets srcPaths;
+  for (unsigned int i=0; i<m->m_files.GetCount(); i++)
+    srcPaths.push_back(PathUtf8(m->m_files [i]));
+
+  switch (m->m_action)
+  {
+  case DragAndDropDlg::RESULT_COPY:
+    msg.Printf(_("Copying %d file(s) to: %s"),
+               (int)srcPaths.size(), PathToNative(destDir).c_str());
+    Trace(msg);
+    client.copy(srcPaths, unusedRevision, destDir);
+    return true;
+  case DragAndDropDlg::RESULT_MOVE:
+    msg.Printf(_("Moving %d file(s) to: %s"),
+               (int)srcPaths.size(), PathToNative(destDir).c_str());
+    Trace(msg);
+    client.move(srcPaths, destDir, false);
+    return true;
+  case DragAndDropDlg::RESULT_IMPORT:
+    if (destDir.isUrl())
+    {
+      msg.Printf(_("Importing %d file(s) into repository: %s"),
+                 (int)srcPaths.size(), PathToNative(destDir).c_str());
+      Trace(msg);
+      client.import(srcPaths, destDir,
+                    LocalToUtf8(m->m_logMessage).c_str(),
+                    m->m_recursiveAdd);
+      return true;
+    }
+    break;
+  default:
+    return true;
+  }
+
   for (unsigned int i=0; i<m->m_files.GetCount(); i++)
   {
     svn::Path srcPath = PathUtf8(m->m_files [i]);
     wxFileName srcFilename(m->m_files[i]);
-    svn::Path destPath = PathUtf8(m->m_destination);
+    svn::Path destPath = destDir;
     destPath.addComponent(LocalToUtf8(srcFilename.GetFullName()));
     switch (m->m_action)
     {
-    case DragAndDropDlg::RESULT_COPY:
-      msg.Printf(_("Copying file: %s"), PathToNative(srcPath).c_str());
-      Trace(msg);
-      client.copy(srcPath, unusedRevision, destPath);
-      break;
-    case DragAndDropDlg::RESULT_MOVE:
-      msg.Printf(_("Moving file: %s"), PathToNative(srcPath).c_str());
-      Trace(msg);
-      client.move(srcPath, unusedRevision, destPath, false);
-      break;
     case DragAndDropDlg::RESULT_IMPORT:
-      // Imports only work when the destination directory is a URL.
       // For imports into a WC, copy the files to the WC and mark
       //  them to be added to the repository
-      if (destPath.isUrl())
-      {
-        msg.Printf(_("Importing file into repository: %s"),
-                   PathToNative(srcPath).c_str());
-        Trace(msg);
-        client.import(srcPath, destPath,
-                      LocalToUtf8(m->m_logMessage).c_str(),
-                      srcFilename.IsDir() && m->m_recursiveAdd);
-      }
-      else
       {
         // If the src file is just a file, then use ::wxCopyFile
         //  otherwise is wxDirTraverser to copy the whole directory
@@ -40,6 +40,7 @@
 #include "svncpp/entry.hpp"
 #include "svncpp/status.hpp"
 #include "svncpp/status_selection.hpp"
+#include "svncpp/trace.hpp"
 #include "svncpp/url.hpp"
 
 // app
@@ -53,6 +54,9 @@
 #include "rapidsvn_app.hpp"
 #include "utils.hpp"
 #include "rapidsvn_drop_target.hpp"
+#include "shared_image_list.hpp"
+#include "stall_watchdog.hpp"
+#include "status_snapshot.hpp"
 
 // Bitmaps
 #include "res/bitmaps/sort_down.png.h"
@@ -646,6 +650,62 @@ static const MapItem MAP_REPLOCK_ICON_ARRAY [] =
 static const size_t MAP_REPLOCK_ICON_COUNT =
   sizeof(MAP_REPLOCK_ICON_ARRAY) / sizeof(MAP_REPLOCK_ICON_ARRAY [0]);
 
+/**
+ * This table holds information about image index in a image list.
+ * It will be accessed using a status code as a first index and locked
+ * flag as a second index.
+ * For every index that equals a valid status code there should be
+ * a valid value which represents an index in the image list
+ * when the second index is 0 (meaning that file is not locked).
+ * When second index equals 1 (for locked files), there are
+ * corresponding image indeces for some states.
+ *
+ * Filled together with @ref FileListImages
+ */
+static std::map<int,int> ImageIndexArray;
+
+/**
+ * form neccessary ImageIndexArray and image list
+ * from the arrays above, first common, than for locked items.
+ */
+static void
+FillFileListImages(wxImageList & list)
+{
+  size_t i;
+  size_t lock_offset = 0;
+  for (i=0; i < MAP_ICON_COUNT; i++)
+  {
+    const MapItem & item = MAP_ICON_ARRAY [i];
+
+    ImageIndexArray [item.status + lock_offset] = i;
+    list.Add(EmbeddedBitmap(item.data, item.len));
+  }
+
+  lock_offset += IMG_INDX_COUNT;
+  for (i=0; i < MAP_LOCK_ICON_COUNT; i++)
+  {
+    const MapItem & item = MAP_LOCK_ICON_ARRAY [i];
+
+    ImageIndexArray [item.status + lock_offset] = MAP_ICON_COUNT + i;
+    list.Add(EmbeddedBitmap(item.data, item.len));
+  }
+
+  lock_offset += IMG_INDX_COUNT;
+  for (i=0; i < MAP_REPLOCK_ICON_COUNT; i++)
+  {
+    const MapItem & item = MAP_REPLOCK_ICON_ARRAY [i];
+
+    ImageIndexArray [item.status + lock_offset] = MAP_LOCK_ICON_COUNT + MAP_ICON_COUNT + i;
+    list.Add(EmbeddedBitmap(item.data, item.len));
+  }
+}
+
+/**
+ * the status icons, decoded once and shared by
+ * all the file lists
+ */
+static SharedImageList FileListImages(FillFileListImages);
+
 /**
  * private struct that hide implementation details
  * to users of @a FileListCtrl
@@ -654,7 +714,6 @@ struct FileListCtrl::Data
 {
 public:
   wxWindow * Parent;
-  wxImageList * ImageListSmall;
   wxString Path;
 
   svn::Context * Context;
@@ -679,16 +738,32 @@ public:
   svn::StatusSel statusSel;
 
   /**
-   * This table holds information about image index in a image list.
-   * It will be accessed using a status code as a first index and locked
-   * flag as a second index.
-   * For every index that equals a valid status code there should be
-   * a valid value which represents an index in the image list
-   * when the second index is 0 (meaning that file is not locked).
-   * When second index equals 1 (for locked files), there are
-   * corresponding image indeces for some states.
+   * everything svn reported for @a CachePath. Changes to
+   * the filter settings are applied to these entries
+   * without crawling the working copy again
+   */
+  svn::StatusEntries StatusCache;
+  bool CacheValid;
+  wxString CachePath;
+  bool CacheFlatMode;
+  bool CacheWithUpdate;
+
+  /**
+   * whether ignored entries and the contents of externals
+   * were crawled. They are left out unless they are shown,
+   * large ignored build directories slow down the crawl
+   */
+  bool CacheIgnored;
+  bool CacheExternals;
+
+  /** dirent fields that were retrieved for a repository listing */
+  apr_uint32_t CacheFields;
+
+  /**
+   * true while the list shows the snapshot of the last
+   * session, which still has to be revalidated
    */
-  std::map<int,int> ImageIndexArray;
+  bool Stale;
 
   bool ColumnVisible [COL_COUNT];
   int ColumnIndex [COL_COUNT];
@@ -714,58 +789,54 @@ public:
 
   void
   WriteConfig();
+
+  apr_uint32_t
+  GetDirentFields() const;
 };
 
+/**
+ * the dirent fields needed for the visible columns of a
+ * repository listing. Sizes and property flags arent
+ * displayed at all.
+ */
+apr_uint32_t
+FileListCtrl::Data::GetDirentFields() const
+{
+  apr_uint32_t fields = SVN_DIRENT_KIND;
+
+  if (ColumnVisible[COL_REV] || ColumnVisible[COL_CMT_REV])
+    fields |= SVN_DIRENT_CREATED_REV;
+
+  if (ColumnVisible[COL_AUTHOR])
+    fields |= SVN_DIRENT_LAST_AUTHOR;
+
+  if (ColumnVisible[COL_CMT_DATE] || ColumnVisible[COL_TEXT_TIME] ||
+      ColumnVisible[COL_PROP_TIME])
+    fields |= SVN_DIRENT_TIME;
+
+  return fields;
+}
+
 /** default constructor */
 FileListCtrl::Data::Data()
     : Context(0), SortColumn(COL_NAME),
     IncludePath(true), SortAscending(true),
     DirtyColumns(true), FlatMode(false),
     WithUpdate(false), ShowUnversioned(true),
-    IgnoreExternals(false), ShowIgnored(false)
+    IgnoreExternals(false), ShowIgnored(false),
+    CacheValid(false), CacheFlatMode(false), CacheWithUpdate(false),
+    CacheIgnored(false), CacheExternals(false),
+    CacheFields(SVN_DIRENT_ALL),
+    Stale(false)
 #if WORKAROUND_ISSUE_324
     ,IsRelative(false)
 #endif
 {
-  ImageListSmall = new wxImageList(16, 16, TRUE);
-
-  /**
-   * form neccessary ImageIndexArray and ImageListSmall arrays
-   * from two previous arrays, first common, than for locked items.
-   */
-  size_t i;
-  size_t lock_offset = 0;
-  for (i=0; i < MAP_ICON_COUNT; i++)
-  {
-    const MapItem & item = MAP_ICON_ARRAY [i];
-
-    ImageIndexArray [item.status + lock_offset] = i;
-    ImageListSmall->Add(EmbeddedBitmap(item.data, item.len));
-  }
-
-  lock_offset += IMG_INDX_COUNT;
-  for (i=0; i < MAP_LOCK_ICON_COUNT; i++)
-  {
-    const MapItem & item = MAP_LOCK_ICON_ARRAY [i];
-
-    ImageIndexArray [item.status + lock_offset] = MAP_ICON_COUNT + i;
-    ImageListSmall->Add(EmbeddedBitmap(item.data, item.len));
-  }
-
-  lock_offset += IMG_INDX_COUNT;
-  for (i=0; i < MAP_REPLOCK_ICON_COUNT; i++)
-  {
-    const MapItem & item = MAP_REPLOCK_ICON_ARRAY [i];
-
-    ImageIndexArray [item.status + lock_offset] = MAP_LOCK_ICON_COUNT + MAP_ICON_COUNT + i;
-    ImageListSmall->Add(EmbeddedBitmap(item.data, item.len));
-  }
 }
 
 /** destructor */
 FileListCtrl::Data::~Data()
 {
-  delete ImageListSmall;
 }
 
 /**
@@ -1009,7 +1080,7 @@ FileListCtrl::FileListCtrl(wxWindow* parent, wxWindowID id,
   m = new Data();
 
   // set this file list control to use the image list
-  SetImageList(m->ImageListSmall, wxIMAGE_LIST_SMALL);
+  SetImageList(FileListImages.Get(), wxIMAGE_LIST_SMALL);
 
   m->ReadConfig();
 
@@ -1036,6 +1107,173 @@ FileListCtrl::RefreshFileList(const wxString & path)
 void
 FileListCtrl::RefreshFileList()
 {
+  svn::TraceSpan span("filelist", "RefreshFileList");
+  StallWatchdog::Scope scope(wxT("FileListCtrl::RefreshFileList ") + m->Path);
+  svn::Path pathUtf8(PathUtf8(m->Path));
+
+  wxLogStatus(_("Listing entries in '%s'"), m->Path.c_str());
+
+  // fetch everything but ignored entries and externals
+  // that aren't shown, the other filter settings are
+  // applied when the entries are displayed
+  svn::Client client(m->Context);
+  svn::StatusFilter filter;
+  filter.showUnversioned = true;
+  filter.showUnmodified = true;
+  filter.showModified = true;
+  filter.showConflicted = true;
+  filter.showIgnored = m->ShowIgnored;
+  filter.showExternals = !m->IgnoreExternals;
+
+  m->CacheValid = false;
+  m->StatusCache.clear();
+  m->CacheFields = SVN_DIRENT_ALL;
+
+  if (pathUtf8.isUrl())
+  {
+    // transfer only what the visible columns show (plus
+    // the locks for the icons). Other fields are fetched
+    // when their columns are shown
+#if WORKAROUND_ISSUE_324
+    m->IsRelative = false;
+#endif
+    m->CacheFields = m->GetDirentFields();
+    m->StatusCache = client.listStatus(pathUtf8.c_str(), m->FlatMode,
+                                       m->CacheFields, true);
+  }
+#if WORKAROUND_ISSUE_324
+  // Workaround for issue 324 (only local+non-flat+update):
+  //   we chdir to the requested dir and pass "." to svn
+  else if (m->WithUpdate && !m->FlatMode)
+  {
+    m->IsRelative = true;
+    ::wxSetWorkingDirectory(m->Path);
+
+    // "" is the canonical expression for "."
+    client.status("", filter, m->FlatMode,
+                  m->WithUpdate, m->StatusCache);
+  }
+  else
+  {
+    m->IsRelative = false;
+    client.status(pathUtf8.c_str(), filter, m->FlatMode,
+                  m->WithUpdate, m->StatusCache);
+  }
+#else
+  else
+    client.status(pathUtf8.c_str(), filter, m->FlatMode,
+                  m->WithUpdate, m->StatusCache);
+#endif
+
+  m->CacheValid = true;
+  m->CachePath = m->Path;
+  m->CacheFlatMode = m->FlatMode;
+  m->CacheWithUpdate = m->WithUpdate;
+  m->CacheIgnored = filter.showIgnored;
+  m->CacheExternals = filter.showExternals;
+  SetStale(false);
+
+  ShowFileList();
+}
+
+void
+FileListCtrl::ShowStale(const wxString & path,
+                        const svn::StatusEntries & entries)
+{
+  m->Path = path;
+  m->StatusCache = entries;
+  m->CacheValid = true;
+  m->CachePath = path;
+  m->CacheFlatMode = m->FlatMode;
+  m->CacheWithUpdate = m->WithUpdate;
+  m->CacheFields = SVN_DIRENT_ALL;
+
+  // the snapshot might have been written without them
+  m->CacheIgnored = false;
+  m->CacheExternals = false;
+  SetStale(true);
+
+  ShowFileList();
+
+  wxLogStatus(_("Showing the last known entries of '%s', refreshing..."),
+              path.c_str());
+}
+
+void
+FileListCtrl::Revalidated(const svn::StatusEntries & entries)
+{
+  if (!m->Stale)
+    return;
+
+  // the revalidation crawls everything
+  m->StatusCache = entries;
+  m->CacheIgnored = true;
+  m->CacheExternals = true;
+  SetStale(false);
+
+  // the selection and scroll position are kept
+  ShowFileList();
+}
+
+bool
+FileListCtrl::IsStale() const
+{
+  return m->Stale;
+}
+
+void
+FileListCtrl::SetStale(bool stale)
+{
+  if (stale == m->Stale)
+    return;
+
+  m->Stale = stale;
+
+  // stale entries are greyed out
+  if (stale)
+    SetTextColour(wxSystemSettings::GetColour(wxSYS_COLOUR_GRAYTEXT));
+  else
+    SetTextColour(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT));
+}
+
+bool
+FileListCtrl::WriteSnapshot(const wxString & fileName) const
+{
+  // only local entries are worth keeping: listing
+  // the repository is what takes the time there
+  if (!m->CacheValid || m->CachePath.IsEmpty() ||
+      PathUtf8(m->CachePath).isUrl() || m->CacheWithUpdate)
+  {
+    if (::wxFileExists(fileName))
+      ::wxRemoveFile(fileName);
+    return false;
+  }
+
+  return WriteStatusSnapshot(fileName, m->CachePath, m->CacheFlatMode,
+                             m->StatusCache);
+}
+
+void
+FileListCtrl::FilterFileList(const wxString & path)
+{
+  if (!m->CacheValid || (path != m->CachePath) ||
+      (m->FlatMode != m->CacheFlatMode) ||
+      (m->WithUpdate != m->CacheWithUpdate) ||
+      (m->ShowIgnored && !m->CacheIgnored) ||
+      (!m->IgnoreExternals && !m->CacheExternals) ||
+      ((m->GetDirentFields() & ~m->CacheFields) != 0))
+  {
+    RefreshFileList(path);
+    return;
+  }
+
+  ShowFileList();
+}
+
+void
+FileListCtrl::ShowFileList()
+{
+  svn::TraceSpan span("filelist", "ShowFileList");
   svn::Path pathUtf8(PathUtf8(m->Path));
 
   // store selection
@@ -1061,46 +1299,32 @@ FileListCtrl::RefreshFileList()
 
     UpdateColumns();
 
-    wxLogStatus(_("Listing entries in '%s'"), m->Path.c_str());
-
-    svn::Client client(m->Context);
-    svn::StatusEntries statusSelector;
-    svn::StatusFilter filter;
-    filter.showUnversioned = m->ShowUnversioned;
-    filter.showUnmodified = m->ShowUnmodified;
-    filter.showModified = m->ShowModified;
-    filter.showConflicted = m->ShowConflicted;
-    filter.showIgnored = m->ShowIgnored;
-    filter.showExternals = !m->IgnoreExternals;
-
-#if WORKAROUND_ISSUE_324
-    // Workaround for issue 324 (only local+non-flat+update):
-    //   we chdir to the requested dir and pass "." to svn
-    if (!pathUtf8.isUrl() && m->WithUpdate && !m->FlatMode)
+    // remote listings are not filtered by svn either
+    svn::StatusPointers statusSelector;
+    if (pathUtf8.isUrl())
     {
-      m->IsRelative = true;
-      ::wxSetWorkingDirectory(m->Path);
-
-      // "" is the canonical expression for "."
-      client.status("", filter, m->FlatMode,
-                    m->WithUpdate, statusSelector);
+      statusSelector.reserve(m->StatusCache.size());
+      svn::StatusEntries::const_iterator it;
+      for (it = m->StatusCache.begin(); it != m->StatusCache.end(); it++)
+        statusSelector.push_back(&(*it));
     }
     else
     {
-      m->IsRelative = false;
-      client.status(pathUtf8.c_str(), filter, m->FlatMode,
-                    m->WithUpdate, statusSelector);
+      svn::StatusFilter filter;
+      filter.showUnversioned = m->ShowUnversioned;
+      filter.showUnmodified = m->ShowUnmodified;
+      filter.showModified = m->ShowModified;
+      filter.showConflicted = m->ShowConflicted;
+      filter.showIgnored = m->ShowIgnored;
+      filter.showExternals = !m->IgnoreExternals;
+
+      svn::Client::filterStatus(filter, m->StatusCache, statusSelector);
     }
-#else
-    client.status(pathUtf8.c_str(), filter, m->FlatMode,
-                  m->WithUpdate, statusSelector);
-#endif
-
 
-    svn::StatusEntries::const_iterator it;
+    svn::StatusPointers::const_iterator it;
     for (it = statusSelector.begin(); it != statusSelector.end(); it++)
     {
-      const svn::Status & status = *it;
+      const svn::Status & status = **it;
 
       CreateLabels(status, pathUtf8);
       // trying to restore selection
@@ -40,6 +40,7 @@
 #include "svncpp/dirent.hpp"
 #include "svncpp/status.hpp"
 #include "svncpp/status_selection.hpp"
+#include "svncpp/trace.hpp"
 #include "svncpp/url.hpp"
 #include "svncpp/wc.hpp"
 
@@ -51,6 +52,8 @@
 #include "preferences.hpp"
 #include "rapidsvn_app.hpp"
 #include "rapidsvn_drop_target.hpp"
+#include "shared_image_list.hpp"
+#include "stall_watchdog.hpp"
 #include "utils.hpp"
 
 // bitmaps
@@ -87,9 +90,34 @@ const static wxChar ConfigBookmarkFmt[] = wxT("/Bookmarks/Bookmark%ld");
 const static wxChar ConfigBookmarkCount[] = wxT("/Bookmarks/Count");
 const static wxChar ConfigFlatModeFmt[] = wxT("/Bookmarks/Bookmark%ldFlat");
 const static wxChar ConfigIndicateModifiedChildrenFmt[] = wxT("/Bookmarks/Bookmark%ldIndicateModifiedChildren");
+const static wxChar ConfigSelectedBookmark[] = wxT("/Bookmarks/SelectedBookmark");
+const static wxChar ConfigSelectedPath[] = wxT("/Bookmarks/SelectedPath");
 
 static const wxString EmptyString;
 
+/**
+ * fill the list with the folder icons, the order
+ * has to match the FOLDER_IMAGE_... constants
+ */
+static void
+FillFolderImages(wxImageList & list)
+{
+  list.Add(EMBEDDED_BITMAP(computer_png));
+  list.Add(EMBEDDED_BITMAP(folder_png));
+  list.Add(EMBEDDED_BITMAP(open_folder_png));
+  list.Add(EMBEDDED_BITMAP(nonsvn_folder_png));
+  list.Add(EMBEDDED_BITMAP(nonsvn_open_folder_png));
+  list.Add(EMBEDDED_BITMAP(modified_folder_png));
+  list.Add(EMBEDDED_BITMAP(modified_open_folder_png));
+  list.Add(EMBEDDED_BITMAP(bookmark_png));
+  list.Add(EMBEDDED_BITMAP(repository_bookmark_png));
+  list.Add(EMBEDDED_BITMAP(externals_folder_png));
+  list.Add(EMBEDDED_BITMAP(externals_open_folder_png));
+}
+
+/** the folder icons shared by all the folder browsers */
+static SharedImageList FolderImages(FillFolderImages);
+
 // local functions
 static bool
 IsValidSeparator(const wxString & sep)
@@ -150,28 +178,18 @@ public:
   bool useAuthCache;
   wxTreeCtrl* treeCtrl;
   wxTreeItemId rootId;
-  wxImageList* imageList;
   BookmarkHashMap bookmarks;
   svn::Context defaultContext;
   svn::StatusSel statusSel;
 
+  /** selection of the last session, see RestoreSelection */
+  wxString lastBookmarkPath;
+  wxString lastPath;
+
   Data(wxTreeCtrl * treeCtrl_)
       : singleContext(0), listener(0), useAuthCache(true), treeCtrl(treeCtrl_)
   {
-    imageList = new wxImageList(16, 16, TRUE);
-    imageList->Add(EMBEDDED_BITMAP(computer_png));
-    imageList->Add(EMBEDDED_BITMAP(folder_png));
-    imageList->Add(EMBEDDED_BITMAP(open_folder_png));
-    imageList->Add(EMBEDDED_BITMAP(nonsvn_folder_png));
-    imageList->Add(EMBEDDED_BITMAP(nonsvn_open_folder_png));
-    imageList->Add(EMBEDDED_BITMAP(modified_folder_png));
-    imageList->Add(EMBEDDED_BITMAP(modified_open_folder_png));
-    imageList->Add(EMBEDDED_BITMAP(bookmark_png));
-    imageList->Add(EMBEDDED_BITMAP(repository_bookmark_png));
-    imageList->Add(EMBEDDED_BITMAP(externals_folder_png));
-    imageList->Add(EMBEDDED_BITMAP(externals_open_folder_png));
-
-    treeCtrl->AssignImageList(imageList);
+    treeCtrl->SetImageList(FolderImages.Get());
 
     FolderItemData* data = new FolderItemData(FOLDER_TYPE_BOOKMARKS);
     rootId = treeCtrl->AddRoot(_("Bookmarks"), FOLDER_IMAGE_COMPUTER,
@@ -462,6 +480,8 @@ public:
     {
     case FOLDER_TYPE_BOOKMARKS:
     {
+      svn::TraceSpan span("folderbrowser", "ExpandBookmarks");
+      StallWatchdog::Scope scope(wxT("FolderBrowser: expand bookmarks"));
       BookmarkHashMap::iterator it = bookmarks.begin();
       svn::Client client(GetContext());
 
@@ -563,6 +583,8 @@ public:
     if (treeCtrl->IsExpanded(parentId))
       return;
 
+    svn::TraceSpan span("folderbrowser", "Refresh");
+    StallWatchdog::Scope scope(wxT("FolderBrowser::Refresh ") + parentPath);
     wxFont fontBold (treeCtrl->GetFont());
     fontBold.SetWeight(wxFONTWEIGHT_BOLD);
     size_t parentLength = parentPath.Length() + 1; //+1 = path separator
@@ -570,15 +592,24 @@ public:
     svn::Client client(GetContext());
     svn::Path parentPathUtf8(PathUtf8(parentPath));
 
-    // Get status array for parent and all entries within it
-    svn::StatusEntries entries(
-      client.status(parentPathUtf8.c_str(),
-                    false,      // Not recursive
-                    true,       // Get all entries
-                    false,      // Dont update from repository
-                    false));     // Use global ignores
-
     bool pathIsUrl = parentPathUtf8.isUrl();
+
+    // Get status array for parent and all entries within it.
+    // In the repository only the kind is of interest: the
+    // tree shows directories only
+    svn::StatusEntries entries;
+    if (pathIsUrl)
+      entries = client.listStatus(parentPathUtf8.c_str(),
+                                  false,           // Not recursive
+                                  SVN_DIRENT_KIND,
+                                  false);          // No locks
+    else
+      entries = client.status(parentPathUtf8.c_str(),
+                              false,      // Not recursive
+                              true,       // Get all entries
+                              false,      // Dont update from repository
+                              false);     // Use global ignores
+
     bool indicateModifiedChildren  = GetSelectedBookmark().indicateModifiedChildren &&
                                      !pathIsUrl;
     std::map<wxString, int> modifiedEntriesMap;
@@ -1207,6 +1238,9 @@ FolderBrowser::WriteConfig(wxConfigBase * cfg) const
 
     item++;
   }
+
+  cfg->Write(ConfigSelectedBookmark, m->GetSelectedBookmarkPath());
+  cfg->Write(ConfigSelectedPath, m->GetPath());
 }
 
 void
@@ -1238,6 +1272,28 @@ FolderBrowser::ReadConfig(wxConfigBase * cfg)
     if (path.Length() > 0)
       m->bookmarks [path] = Bookmark(flatMode != 0, indicateModifiedChildren != 0);
   }
+
+  cfg->Read(ConfigSelectedBookmark, &m->lastBookmarkPath, wxEmptyString);
+  cfg->Read(ConfigSelectedPath, &m->lastPath, wxEmptyString);
+}
+
+bool
+FolderBrowser::RestoreSelection()
+{
+  if (m->lastBookmarkPath.Length() == 0)
+    return false;
+
+  if (!m->SelectBookmark(m->lastBookmarkPath))
+    return false;
+
+  wxTreeItemId bookmarkId = m->treeCtrl->GetSelection();
+  if (m->treeCtrl->ItemHasChildren(bookmarkId))
+    m->treeCtrl->Expand(bookmarkId);
+
+  if (m->lastPath.Length() > 0)
+    SelectFolder(m->lastPath);
+
+  return true;
 }
 
 bool
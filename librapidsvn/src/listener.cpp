@@ -24,6 +24,7 @@
 
 // wxWidgets
 #include "wx/wx.h"
+#include "wx/filename.h"
 #include "wx/thread.h"
 #include "wx/utils.h"
 
@@ -38,6 +39,133 @@
 #include "tracer.hpp"
 #include "utils.hpp"
 
+/**
+ * the status bar shows the progress at most this often, in ms
+ */
+static const long PROGRESS_INTERVAL = 500;
+
+/**
+ * Bytes and files transferred by the running action.
+ * Updated in the thread of the action.
+ */
+struct TransferProgress
+{
+  wxLongLong start;
+  apr_off_t bytes;
+  apr_off_t remaining;
+  long files;
+
+  /** the values when the status bar was updated the last time */
+  wxLongLong lastReport;
+  apr_off_t lastReportBytes;
+  long lastReportFiles;
+
+  TransferProgress()
+  {
+    Reset();
+  }
+
+  void
+  Reset()
+  {
+    start = wxGetLocalTimeMillis();
+    bytes = 0;
+    remaining = -1;
+    files = 0;
+    lastReport = start;
+    lastReportBytes = 0;
+    lastReportFiles = 0;
+  }
+
+  /**
+   * @return is it time to update the status bar?
+   */
+  bool
+  IsReportDue() const
+  {
+    return (wxGetLocalTimeMillis() - lastReport) >= PROGRESS_INTERVAL;
+  }
+
+  /**
+   * @return the rate, totals and the estimated time
+   *         left since the last report
+   */
+  wxString
+  Report()
+  {
+    wxLongLong now = wxGetLocalTimeMillis();
+    double seconds = (now - lastReport).ToDouble() / 1000.0;
+    if (seconds <= 0.0)
+      seconds = 0.001;
+
+    double bytesPerSecond = (bytes - lastReportBytes) / seconds;
+    double filesPerSecond = (files - lastReportFiles) / seconds;
+
+    wxString str;
+    str.Printf(_("%s transferred (%s/s), %ld files (%.0f/s)"),
+               wxFileName::GetHumanReadableSize(wxULongLong(bytes)).c_str(),
+               wxFileName::GetHumanReadableSize(wxULongLong((wxULongLong_t)bytesPerSecond)).c_str(),
+               files, filesPerSecond);
+
+    if ((remaining > 0) && (bytesPerSecond > 0.0))
+      str += wxString::Format(_(", about %ld s left"),
+                              (long)(remaining / bytesPerSecond) + 1);
+
+    lastReport = now;
+    lastReportBytes = bytes;
+    lastReportFiles = files;
+
+    return str;
+  }
+
+  /**
+   * @return totals and the average rate of the
+   *         whole action, empty if nothing was transferred
+   */
+  wxString
+  Summary() const
+  {
+    if ((bytes == 0) && (files == 0))
+      return wxEmptyString;
+
+    double seconds = (wxGetLocalTimeMillis() - start).ToDouble() / 1000.0;
+    if (seconds <= 0.0)
+      seconds = 0.001;
+
+    wxString str;
+    str.Printf(_("%s and %ld files transferred in %.1f s (%s/s, %.0f files/s)"),
+               wxFileName::GetHumanReadableSize(wxULongLong(bytes)).c_str(),
+               files, seconds,
+               wxFileName::GetHumanReadableSize(wxULongLong((wxULongLong_t)(bytes / seconds))).c_str(),
+               files / seconds);
+
+    return str;
+  }
+};
+
+/**
+ * @return does @a action stand for a file or
+ *         directory that was transferred?
+ */
+static bool
+IsTransferAction(svn_wc_notify_action_t action)
+{
+  switch (action)
+  {
+  case svn_wc_notify_update_add:
+  case svn_wc_notify_update_delete:
+  case svn_wc_notify_update_update:
+  case svn_wc_notify_commit_modified:
+  case svn_wc_notify_commit_added:
+  case svn_wc_notify_commit_deleted:
+  case svn_wc_notify_commit_replaced:
+    return true;
+
+  default:
+    return false;
+  }
+}
+
 struct Listener::Data
 {
 public:
@@ -63,8 +191,10 @@ public:
   /**
    * is ongoing operation to be cancelled?
    * will be evaluated by Listener::contextCancel
+   * and by the prompts (written by the main thread,
+   * read by the worker)
    */
-  bool isCancelled;
+  volatile bool isCancelled;
 
   /**
    * the context under which the action will be
@@ -94,6 +224,29 @@ public:
   svn::ContextListener::SslServerTrustData sslServerTrustData;
   apr_uint32_t acceptedFailures;
 
+  /** protects @a progress */
+  wxCriticalSection progressLock;
+  TransferProgress progress;
+
+  /**
+   * updates the status bar if it is time to
+   */
+  void
+  ReportProgress()
+  {
+    wxString msg;
+
+    {
+      wxCriticalSectionLocker lock(progressLock);
+      if (!progress.IsReportDue())
+        return;
+
+      msg = progress.Report();
+    }
+
+    ActionEvent::Post(parent, TOKEN_PROGRESS, msg);
+  }
+
 
   Data(wxWindow * parent_)
       : parent(parent_), tracer(NULL), ownTracer(false),
@@ -120,10 +273,20 @@ public:
    *
    * if we are already in the main thread we
    * can skip the shit and wait here
+   *
+   * once the operation is cancelled no prompt
+   * is shown anymore: the main thread may be
+   * waiting for the worker to finish
    */
   void
   sendSignalAndWait(int id)
   {
+    if (isCancelled)
+    {
+      refusePrompt();
+      return;
+    }
+
     wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED, id);
 
     if (::wxIsMainThread())
@@ -134,12 +297,26 @@ public:
     }
     else
     {
+      // lock before posting, otherwise the main
+      // thread might signal before we wait
+      wxMutexLocker lock(mutex);
       wxPostEvent(parent, event);
       parentDoneSignal->Wait();
     }
   }
 
 
+  /**
+   * answers a prompt negatively without asking
+   */
+  void
+  refusePrompt()
+  {
+    dataReceived = false;
+    sslServerTrustAnswer = svn::ContextListener::DONT_ACCEPT;
+  }
+
+
   /**
    * The callback functions will call this
    * function to signal they are done;
@@ -249,6 +426,16 @@ public:
   void
   handleEvent(wxCommandEvent & event)
   {
+    if (isCancelled)
+    {
+      // the worker might have been cancelled while
+      // this event was waiting in the queue
+      wxMutexLocker lock(mutex);
+      refusePrompt();
+      signalDone();
+      return;
+    }
+
     switch (event.GetId())
     {
     case SIG_GET_LOG_MSG:
@@ -440,6 +627,17 @@ Listener::contextNotify(const char *path,
   static UpdateCounter updateCounter;
 
   TraceDefaultMessage(action, path);
+
+  if (IsTransferAction(action))
+  {
+    {
+      wxCriticalSectionLocker lock(m->progressLock);
+      m->progress.files++;
+    }
+
+    m->ReportProgress();
+  }
+
   switch (action)
   {
   case svn_wc_notify_update_add:
@@ -512,6 +710,34 @@ Listener::contextNotify(const char *path,
 #endif
 }
 
+void
+Listener::contextProgress(apr_off_t transferred, apr_off_t remaining)
+{
+  {
+    wxCriticalSectionLocker lock(m->progressLock);
+    m->progress.bytes = transferred;
+    m->progress.remaining = remaining;
+  }
+
+  m->ReportProgress();
+}
+
+void
+Listener::ResetProgress()
+{
+  wxCriticalSectionLocker lock(m->progressLock);
+
+  m->progress.Reset();
+}
+
+wxString
+Listener::GetProgressSummary() const
+{
+  wxCriticalSectionLocker lock(m->progressLock);
+
+  return m->progress.Summary();
+}
+
 bool
 Listener::contextGetLogin(const std::string & /*realm*/,
                           std::string & username,
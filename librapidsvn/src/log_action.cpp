@@ -28,7 +28,6 @@
 
 // svncpp
 #include "svncpp/client.hpp"
-#include "svncpp/info.hpp"
 #include "svncpp/repository_path.hpp"
 #include "svncpp/revision.hpp"
 #include "svncpp/status_selection.hpp"
@@ -75,9 +74,8 @@ LogAction::CheckStatusSel(const svn::StatusSel & statusSel)
 svn::RepositoryPath
 LogAction::CreateRepositoryPath(svn::Client & client, svn::Path & path)
 {
-  svn::InfoVector info = client.info(path, svn::Revision::START, svn::Revision::HEAD);
-  std::string repositoryRoot = !info.empty() ? info.back().repos() : "";
-  return svn::RepositoryPath(path.path(), repositoryRoot);
+  svn::RepositoryInfo info = client.repositoryInfo(path);
+  return svn::RepositoryPath(path.path(), info.root);
 }
 /* -----------------------------------------------------------------
  * local variables:
@@ -27,8 +27,8 @@
 // wxWidgets
 #include "wx/confbase.h"
 #include "wx/wx.h"
+#include "wx/ffile.h"
 #include "wx/filename.h"
-#include "wx/stdpaths.h"
 #include <wx/tipdlg.h>
 
 // svncpp
@@ -37,6 +37,7 @@
 #include "svncpp/exception.hpp"
 #include "svncpp/status_selection.hpp"
 #include "svncpp/targets.hpp"
+#include "svncpp/trace.hpp"
 #include "svncpp/url.hpp"
 #include "svncpp/wc.hpp"
 
@@ -80,10 +81,13 @@
 
 // dialogs
 #include "about_dlg.hpp"
+#include "action_statistics.hpp"
+#include "action_statistics_dlg.hpp"
 #include "auth_dlg.hpp"
 #include "report_dlg.hpp"
 #include "preferences.hpp"
 #include "preferences_dlg.hpp"
+#include "process_runner.hpp"
 #include "update_dlg.hpp"
 #include "log_dlg.hpp"
 
@@ -92,6 +96,8 @@
 
 #include "filelist_ctrl_drop_target.hpp"
 #include "folder_browser_drop_target.hpp"
+#include "stall_watchdog.hpp"
+#include "status_snapshot.hpp"
 
 // Bitmaps
 #include "res/bitmaps/rapidsvn_16x16.xpm"
@@ -184,6 +190,12 @@ public:
   int vertSashPos;
   int idleCount;
 
+  /** brings the file list of the last session up to date */
+  StatusRevalidator * revalidator;
+
+  /** runs diff tools, editors and svnadmin */
+  ProcessRunner * processRunner;
+
 private:
   bool m_running;
   wxFrame * m_parent;
@@ -210,6 +222,7 @@ public:
       activePane(ACTIVEPANE_FOLDER_BROWSER),
       showUnversioned(false), showUnmodified(false),
       showModified(false), showConflicted(false), idleCount(0),
+      revalidator(0), processRunner(0),
       m_running(false), m_parent(parent),
       m_isErrorDialogActive(false),
       m_folderBrowser(folderBrowser), 
@@ -316,6 +329,9 @@ public:
     // Extras menu
     wxMenu *menuExtras = new wxMenu;
     AppendMenuItem(*menuExtras, ID_Cleanup);
+    menuExtras->AppendSeparator();
+    menuExtras->Append(ID_ActionStatistics, _("Action &Statistics..."));
+    menuExtras->AppendCheckItem(ID_Trace, _("Record &Trace"));
 
     // Help Menu
     wxMenu *menuHelp = new wxMenu;
@@ -620,6 +636,8 @@ BEGIN_EVENT_TABLE(MainFrame, wxFrame)
   EVT_MENU(ID_HelpIndex, MainFrame::OnHelpIndex)
   EVT_MENU(ID_HelpStartupTips, MainFrame::OnHelpStartupTips)
   EVT_MENU(ID_About, MainFrame::OnAbout)
+  EVT_MENU(ID_ActionStatistics, MainFrame::OnActionStatistics)
+  EVT_MENU(ID_Trace, MainFrame::OnTrace)
 
   #ifdef USE_DEBUG_TESTS
   EVT_MENU(ID_TestNewWxString, MainFrame::OnTestNewWxString)
@@ -686,6 +704,7 @@ MainFrame::MainFrame(const wxString & title,
 
   m->logTracer = new EventTracer(this);
   m->listener.SetTracer(m->logTracer, false);
+  m->processRunner = new ProcessRunner(this, m->logTracer);
 
 
   // Create the list control to display files
@@ -753,7 +772,7 @@ MainFrame::MainFrame(const wxString & title,
     m_folderBrowser->SetAuthPerBookmark(prefs.authPerBookmark);
   }
   UpdateCurrentPath();
-  RefreshFolderBrowser();
+  RestoreLastSession();
 
   // Initialize for drag and drop
   m_folderBrowser->SetDropTarget(new FolderBrowserDropTarget(m_folderBrowser));
@@ -761,10 +780,29 @@ MainFrame::MainFrame(const wxString & title,
 
   // this is a workaround for the buggy Splitter initialisation
   Connect(wxEVT_IDLE, wxIdleEventHandler(MainFrame::OnIdle), NULL, this);
+
+  // report blocking calls in the GUI thread
+  {
+    Preferences prefs;
+    TheStallWatchdog.Start(this, prefs.stallThreshold);
+  }
 }
 
 MainFrame::~MainFrame()
 {
+  TheStallWatchdog.Stop();
+
+  // running programs and the revalidator thread
+  // mustn't report to a deleted frame
+  delete m->processRunner;
+  m->processRunner = 0;
+
+  if (m->revalidator)
+  {
+    delete m->revalidator;
+    m->revalidator = 0;
+  }
+
   wxConfigBase *cfg = wxConfigBase::Get();
   if (cfg == NULL)
     return;
@@ -775,6 +813,8 @@ MainFrame::~MainFrame()
   if (m_actionWorker)
     delete m_actionWorker;
 
+  m_listCtrl->WriteSnapshot(GetStatusSnapshotFileName());
+
   // Save frame size and position.
   if (!IsIconized())
   {
@@ -867,6 +907,18 @@ MainFrame::TrimDisabledMenuItems(wxMenu & menu)
 
 void
 MainFrame::RefreshFileList()
+{
+  UpdateFileList(false);
+}
+
+void
+MainFrame::FilterFileList()
+{
+  UpdateFileList(true);
+}
+
+void
+MainFrame::UpdateFileList(bool filterOnly)
 {
   if (m->dontUpdateFilelist)
     return;
@@ -905,7 +957,10 @@ MainFrame::RefreshFileList()
       else
       {
         m_listCtrl->SetContext(m_context);
-        m_listCtrl->RefreshFileList(m->currentPath);
+        if (filterOnly)
+          m_listCtrl->FilterFileList(m->currentPath);
+        else
+          m_listCtrl->RefreshFileList(m->currentPath);
       }
 
     }
@@ -939,6 +994,47 @@ MainFrame::RefreshFileList()
     m->SetRunning(false);
 }
 
+void
+MainFrame::RestoreLastSession()
+{
+  // build the tree and select the folder of the last
+  // session without listing any files yet
+  m->dontUpdateFilelist = true;
+  m->skipFilelistUpdate = true;
+  RefreshFolderBrowser();
+
+  m->dontUpdateFilelist = true;
+  bool restored = m_folderBrowser->RestoreSelection();
+  m->dontUpdateFilelist = false;
+
+  UpdateCurrentPath();
+
+  if (!restored)
+  {
+    RefreshFileList();
+    return;
+  }
+
+  // show the entries of the last session right away and
+  // bring them up to date in the background. The background
+  // crawl cannot answer prompts, so listings with update
+  // are refreshed the usual way
+  wxString path;
+  bool flat;
+  svn::StatusEntries entries;
+  if (!m_listCtrl->GetWithUpdate() &&
+      ReadStatusSnapshot(GetStatusSnapshotFileName(), path, flat, entries) &&
+      (path == m->currentPath) && (flat == m_listCtrl->IsFlat()))
+  {
+    m_listCtrl->SetContext(m_context);
+    m_listCtrl->ShowStale(path, entries);
+
+    m->revalidator = new StatusRevalidator(this, path, flat);
+  }
+  else
+    RefreshFileList();
+}
+
 void
 MainFrame::RefreshFolderBrowser()
 {
@@ -990,7 +1086,8 @@ MainFrame::OnActivate(wxActivateEvent & event)
         (!m->IsUrl() &&
          !m->IsFlat() &&
          !m->IsRunning() &&
-         !m->IsErrorDialogActive()))
+         !m->IsErrorDialogActive() &&
+         !m_listCtrl->IsStale()))
     {
       m->updateAfterActivate = false;
 
@@ -1061,7 +1158,7 @@ MainFrame::OnColumnReset(wxCommandEvent & WXUNUSED(event))
     int sortid = id + Columns::SORT_COLUMN_OFFSET;
     m->EnableMenuEntry(sortid, visible);
   }
-  RefreshFileList();
+  FilterFileList();
 }
 
 void
@@ -1089,7 +1186,7 @@ MainFrame::OnColumn(wxCommandEvent & event)
     UpdateMenuSorting();
     UpdateMenuAscending();
 
-    RefreshFileList();
+    FilterFileList();
   }
 }
 
@@ -1168,7 +1265,7 @@ MainFrame::OnShowUnversioned(wxCommandEvent & WXUNUSED(event))
 {
   bool checked = m->ToggleMenuAndTool(ID_ShowUnversioned, m->showUnversioned);
   m_listCtrl->SetShowUnversioned(checked);
-  RefreshFileList();
+  FilterFileList();
 }
 
 void
@@ -1176,7 +1273,7 @@ MainFrame::OnShowUnmodified(wxCommandEvent & WXUNUSED(event))
 {
   bool checked = m->ToggleMenuAndTool(ID_ShowUnmodified, m->showUnmodified);
   m_listCtrl->SetShowUnmodified(checked);
-  RefreshFileList();
+  FilterFileList();
 }
 
 void
@@ -1184,7 +1281,7 @@ MainFrame::OnShowModified(wxCommandEvent & WXUNUSED(event))
 {
   bool checked = m->ToggleMenuAndTool(ID_ShowModified, m->showModified);
   m_listCtrl->SetShowModified(checked);
-  RefreshFileList();
+  FilterFileList();
 }
 
 void
@@ -1192,7 +1289,7 @@ MainFrame::OnShowConflicted(wxCommandEvent & WXUNUSED(event))
 {
   bool checked = m->ToggleMenuAndTool(ID_ShowConflicted, m->showConflicted);
   m_listCtrl->SetShowConflicted(checked);
-  RefreshFileList();
+  FilterFileList();
 }
 
 void
@@ -1200,7 +1297,7 @@ MainFrame::OnIgnoreExternals(wxCommandEvent & WXUNUSED(event))
 {
   bool checked = m->IsMenuChecked(ID_IgnoreExternals);
   m_listCtrl->SetIgnoreExternals(checked);
-  RefreshFileList();
+  FilterFileList();
 }
 
 void
@@ -1208,7 +1305,7 @@ MainFrame::OnShowIgnored(wxCommandEvent & WXUNUSED(event))
 {
   bool checked = m->IsMenuChecked(ID_ShowIgnored);
   m_listCtrl->SetShowIgnored(checked);
-  RefreshFileList();
+  FilterFileList();
 }
 
 void
@@ -1339,44 +1436,58 @@ MainFrame::OnAbout(wxCommandEvent & WXUNUSED(event))
   dlg.ShowModal();
 }
 
-#ifdef USE_DEBUG_TESTS
-static void
-info_print_time(apr_time_t atime, const wxChar * desc, wxString & str)
+void
+MainFrame::OnActionStatistics(wxCommandEvent & WXUNUSED(event))
 {
-  apr_time_exp_t extime;
-  apr_status_t apr_err;
+  ActionStatisticsDlg dlg(this);
 
-  /* if this returns an error, just don't print anything out */
-  apr_err = apr_time_exp_tz(&extime, atime, 0);
-  if (!apr_err)
-    str.Printf(wxT("%s: %02lu:%02lu:%02lu:%02lu"), desc,
-               (unsigned long)(extime.tm_hour),
-               (unsigned long)(extime.tm_min),
-               (unsigned long)(extime.tm_sec),
-               (unsigned long)(extime.tm_usec));
+  dlg.ShowModal();
 }
 
 void
-MainFrame::PrintTimeMeasurements(apr_time_t start, apr_time_t end, const wxString & name)
+MainFrame::OnTrace(wxCommandEvent & event)
 {
-  wxString msg(name);
-  m->Trace(wxT('\n') + msg);
+  if (event.IsChecked())
+  {
+    svn::Trace::start();
+    m->Trace(_("Recording a trace..."));
+    return;
+  }
 
-  info_print_time(start, _("Test started at"), msg);
-  m->Trace(wxT("\n") + msg);
+  svn::Trace::stop();
 
-  info_print_time(end, _("Test ended at"), msg);
-  m->Trace(msg);
+  wxFileDialog dlg(this, _("Save trace"), wxEmptyString,
+                   wxT("rapidsvn-trace.json"),
+                   _("Trace files (*.json)|*.json"),
+                   wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+  if (dlg.ShowModal() != wxID_OK)
+    return;
+
+  // the file can be opened with chrome://tracing
+  std::string json(svn::Trace::toJson());
+  wxFFile file(dlg.GetPath(), wxT("w"));
+
+  if (!file.IsOpened() ||
+      (file.Write(json.c_str(), json.length()) != json.length()))
+  {
+    wxLogError(_("Could not write \"%s\"."), dlg.GetPath().c_str());
+    return;
+  }
 
-  apr_time_t duration = end - start;
-  info_print_time(duration, _("Test duration"), msg);
-  m->Trace(msg + wxT("\n"));
+  wxString msg;
+  msg.Printf(_("Trace with %lu spans written to \"%s\"."),
+             (unsigned long)svn::Trace::count(), dlg.GetPath().c_str());
+  m->Trace(msg);
 }
 
+#ifdef USE_DEBUG_TESTS
 void
 MainFrame::OnTestNewWxString(wxCommandEvent & WXUNUSED(event))
 {
-  apr_time_t start = apr_time_now();
+  ActionMeasurement measurement;
+  measurement.Start(wxT("Created 10 000 wxStrings and printed them with Trace ()"), 0);
+  measurement.BeginPhase();
 
   // starting the test
   for (int i = 1; i <= 10000; i++)
@@ -1393,16 +1504,16 @@ MainFrame::OnTestNewWxString(wxCommandEvent & WXUNUSED(event))
     }
   }
   // ending the test
-  apr_time_t end = apr_time_now();
-
-  wxString name(wxT("Created 10 000 wxStrings and printed them with Trace ()"));
-  PrintTimeMeasurements(start, end, name);
+  measurement.EndPhase(true);
+  m->Trace(wxT("\n") + measurement.Finish(true).Format());
 }
 
 void
 MainFrame::OnTestListener(wxCommandEvent & WXUNUSED(event))
 {
-  apr_time_t start = apr_time_now();
+  ActionMeasurement measurement;
+  measurement.Start(wxT("Tested Listener, 1000 loops through all the 22/26 actions"), 0);
+  measurement.BeginPhase();
 
   // starting the test
 
@@ -1466,25 +1577,19 @@ MainFrame::OnTestListener(wxCommandEvent & WXUNUSED(event))
     }
   }
   // ending the test
-  apr_time_t end = apr_time_now();
-
-  wxString name(wxT("Tested Listener, 1000 loops through all the 22/26 actions"));
-  PrintTimeMeasurements(start, end, name);
+  measurement.EndPhase(true);
+  m->Trace(wxT("\n") + measurement.Finish(true).Format());
 }
 
 void
 MainFrame::OnTestCheckout(wxCommandEvent & WXUNUSED(event))
 {
-  apr_time_t start = apr_time_now();
-
   Action * action = new CheckoutAction(this);
 
+  // the worker records the statistics of the checkout,
+  // see "Action Statistics..." in the "Extras" menu
   if (action)
     Perform(action);
-
-  apr_time_t end = apr_time_now();
-  wxString name(wxT("Tested Checkout (works only in single-threaded version)"));
-  PrintTimeMeasurements(start, end, name);
 }
 
 void 
@@ -1714,54 +1819,45 @@ MainFrame::OnActionEvent(wxCommandEvent & event)
       }
     }
 
+    wxString summary(m->listener.GetProgressSummary());
+    if (!summary.IsEmpty())
+    {
+      m->Trace(summary);
+      SetStatusText(summary);
+    }
+
     m->Trace(_("Ready\n"));
     m->SetRunning(false);
   }
   break;
 
+  case TOKEN_PROGRESS:
+    // only while the action is running, a late update
+    // would hide the summary
+    if (m->IsRunning())
+      SetStatusText(event.GetString());
+    break;
+
   case TOKEN_CMD:
+  case TOKEN_CMD_VIEW:
+    // execute the command sent
+    m->processRunner->Run(ProcessRunner::TOOL, event.GetString());
+    break;
+
   case TOKEN_CMD_DIFF:
   case TOKEN_CMD_MERGE:
-  case TOKEN_CMD_VIEW:
+    m->processRunner->Run(ProcessRunner::DIFF_TOOL, event.GetString());
+    break;
+
+  case TOKEN_RUN_COMMAND:
   {
-#ifdef _WIN32
-    // recover initial environment
-    wxString apr_iconv_path;
-    bool saved_apr_iconv_path = false;
-    if (wxGetEnv(wxT("__SAVED_APR_ICONV_PATH"), &apr_iconv_path))
-    {
-      saved_apr_iconv_path = true;
-      wxSetEnv(wxT("APR_ICONV_PATH"), apr_iconv_path.c_str());
-      wxUnsetEnv(wxT("__SAVED_APR_ICONV_PATH"));
-    }
-#endif
-    // execute the command sent
-    wxExecute(event.GetString());
-#ifdef _WIN32
-    // set custom environment again
-    if (saved_apr_iconv_path)
+    ProcessData * pData = static_cast<ProcessData *>(event.GetClientData());
+
+    if (pData != 0)
     {
-      wxSetEnv(wxT("__SAVED_APR_ICONV_PATH"), apr_iconv_path.c_str());
-      wxSetEnv(wxT("APR_ICONV_PATH"), wxStandardPaths::Get().GetDataDir() + wxT("\\iconv"));
+      m->processRunner->Run(*pData);
+      delete pData;
     }
-#endif
-    /**
-     * @todo Would be good to be able to interpret the return value
-     *       to see if the command could be executed.
-     *       The documentation on @a wxExecute teaches us 0 means
-     *       process couldnt be created. But with Linux/wxGTK I got
-     *       a positive integer even if the command couldnt be found.
-     *       Another way to check this might be to explicitely scan
-     *       the PATH variable to find the executable if a relative
-     *       pathname is given.
-     */
-    // not working code
-    // if (result != 0)
-    // {
-    //  // 0 as return value means the command couldnt be executed
-    //  TraceError (wxString::Format (_("Execution of command failed: '%s'"),
-    //                                event.GetString ().c_str ()));
-    // }
   }
   break;
 
@@ -1910,6 +2006,36 @@ MainFrame::OnActionEvent(wxCommandEvent & event)
     }
   }
   break;
+
+  case TOKEN_STATUS_REVALIDATED:
+  {
+    RevalidatedStatus * result =
+      static_cast<RevalidatedStatus *>(event.GetClientData());
+
+    if (m->revalidator)
+    {
+      delete m->revalidator;
+      m->revalidator = 0;
+    }
+
+    // if the list has been refreshed in the meantime
+    // there is nothing left to do
+    if ((result != 0) && m_listCtrl->IsStale())
+    {
+      if (result->error.IsEmpty() &&
+          (result->path == m->currentPath) &&
+          (result->flat == m_listCtrl->IsFlat()))
+      {
+        m_listCtrl->Revalidated(result->entries);
+        wxLogStatus(_("Ready"));
+      }
+      else
+        RefreshFileList();
+    }
+
+    delete result;
+  }
+  break;
   }
 }
 
@@ -2061,6 +2187,44 @@ MainFrame::AddRepoBookmark()
   //RefreshFileList ();
 }
 
+void
+MainFrame::OpenPath(const wxString & path)
+{
+  if (IsIconized())
+    Iconize(false);
+  Raise();
+
+  if (path.IsEmpty())
+    return;
+
+  // open the folder of a file
+  wxString bookmark(path);
+  if (!svn::Url::isValid(LocalToUtf8(path).c_str()) &&
+      !wxDirExists(path))
+  {
+    if (!wxFileExists(path))
+    {
+      wxLogError(_("Cannot open '%s': no such file or directory"),
+                 path.c_str());
+      return;
+    }
+
+    bookmark = wxFileName(path).GetPath();
+  }
+
+  if (m_folderBrowser->SelectBookmark(bookmark))
+    return;
+
+  m_folderBrowser->AddBookmark(bookmark);
+
+  m->skipFilelistUpdate = true;
+  RefreshFolderBrowser();
+
+  wxLogStatus(_("Added '%s' to bookmarks"), bookmark.c_str());
+
+  m_folderBrowser->SelectBookmark(bookmark);
+}
+
 inline void
 MainFrame::RemoveBookmark()
 {
@@ -2213,6 +2377,7 @@ MainFrame::Perform(Action * action)
   try
   {
     m->listener.cancel(false);
+    m->listener.ResetProgress();
 
     svn::Path currentPathUtf8(PathUtf8(m->currentPath));
     action->SetPath(currentPathUtf8);
@@ -27,6 +27,7 @@
 
 // svncpp
 #include "svncpp/client.hpp"
+#include "svncpp/targets.hpp"
 
 // app
 #include "destination_dlg.hpp"
@@ -85,16 +86,18 @@ MoveAction::Perform()
 
   for (it = targets.begin(); it != targets.end(); it++)
   {
-    svn::Path srcPath(*it);
+    if (*it == GetPath())
+      *it = ".";
+  }
 
-    if (srcPath == GetPath())
-      srcPath = ".";
+  // all the targets are moved/copied at once: for urls
+  // this results in a single commit
+  svn::Targets srcPaths(targets);
+  if (m_kind == MOVE_MOVE)
+    client.move(srcPaths, destPath, m_force);
+  else
+    client.copy(srcPaths, unusedRevision, destPath);
 
-    if (m_kind == MOVE_MOVE)
-      client.move(srcPath, unusedRevision, destPath, m_force);
-    else
-      client.copy(srcPath, unusedRevision, destPath);
-  }
   return true;
 }
 
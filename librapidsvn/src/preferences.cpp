@@ -38,6 +38,7 @@ static const wxChar * DEFAULT_EXPLORER = wxT("");
 #endif
 static const wxChar * DEFAULT_EDITOR = wxT("");
 static const wxChar * DEFAULT_DIFF_TOOL = wxT("");
+static const long DEFAULT_STALL_THRESHOLD = 500;
 
 /**
  * Configuration key names
@@ -72,6 +73,10 @@ static const wxChar CONF_USE_LAST_COMMIT_MESSAGE[] =
   wxT("/Preferences/UseLastCommitMessage");
 static const wxChar CONF_RESET_FLAT_MODE_ON_START[] =
   wxT("/Preferences/ResetFlatModeOnStart");
+static const wxChar CONF_STALL_THRESHOLD[] =
+  wxT("/Preferences/StallThreshold");
+static const wxChar CONF_SINGLE_INSTANCE[] =
+  wxT("/Preferences/SingleInstance");
 
 Preferences::Preferences()
     : editor(DEFAULT_EDITOR), editorAlways(false), editorArgs(wxEmptyString),
@@ -79,7 +84,8 @@ Preferences::Preferences()
     explorerArgs(wxEmptyString), diffTool(DEFAULT_DIFF_TOOL),
     diffToolArgs(wxEmptyString), mergeTool(wxEmptyString),
     mergeToolArgs(wxEmptyString), purgeTempFiles(true),
-    authPerBookmark(false), useAuthCache(true)
+    authPerBookmark(false), useAuthCache(true),
+    stallThreshold(DEFAULT_STALL_THRESHOLD), singleInstance(true)
 {
   Read();
 }
@@ -115,6 +121,8 @@ Preferences::Read()
 
   config->Read(CONF_USE_LAST_COMMIT_MESSAGE, &useLastCommitMessage);
   config->Read(CONF_RESET_FLAT_MODE_ON_START, &resetFlatModeOnStart, false);
+  config->Read(CONF_STALL_THRESHOLD, &stallThreshold);
+  config->Read(CONF_SINGLE_INSTANCE, &singleInstance);
 }
 
 void Preferences::Write() const
@@ -142,6 +150,8 @@ void Preferences::Write() const
 
   config->Write(CONF_USE_LAST_COMMIT_MESSAGE, useLastCommitMessage);
   config->Write(CONF_RESET_FLAT_MODE_ON_START, resetFlatModeOnStart);
+  config->Write(CONF_STALL_THRESHOLD, stallThreshold);
+  config->Write(CONF_SINGLE_INSTANCE, singleInstance);
 }
 
 /* -----------------------------------------------------------------
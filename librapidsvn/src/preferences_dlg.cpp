@@ -66,6 +66,7 @@ PreferencesDlg::TransferDataFromWindow()
   m_prefs->purgeTempFiles = m_checkPurgeTempFiles->GetValue();
   m_prefs->useLastCommitMessage = m_checkUseLastCommitMessage->GetValue();
   m_prefs->resetFlatModeOnStart = m_checkResetFlatMode->GetValue();
+  m_prefs->singleInstance = m_checkSingleInstance->GetValue();
 
   // Programs
   m_prefs->editor = m_textEditor->GetValue();
@@ -99,6 +100,7 @@ PreferencesDlg::TransferDataToWindow()
   m_checkPurgeTempFiles->SetValue(m_prefs->purgeTempFiles);
   m_checkUseLastCommitMessage->SetValue(m_prefs->useLastCommitMessage);
   m_checkResetFlatMode->SetValue(m_prefs->resetFlatModeOnStart);
+  m_checkSingleInstance->SetValue(m_prefs->singleInstance);
 
   // Programs
   m_textEditor->SetValue(m_prefs->editor);
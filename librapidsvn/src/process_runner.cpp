@@ -0,0 +1,392 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// stl
+#include <deque>
+#include <list>
+#include <string>
+
+// wxWidgets
+#include "wx/wx.h"
+#include "wx/process.h"
+#include "wx/stdpaths.h"
+#include "wx/stream.h"
+#include "wx/timer.h"
+
+// app
+#include "action_event.hpp"
+#include "process_runner.hpp"
+#include "tracer.hpp"
+
+const size_t ProcessRunner::MAX_DIFF_TOOLS = 4;
+
+/** how often the output of running commands is read (ms) */
+static const int POLL_INTERVAL = 100;
+
+/** size of the buffer the output is read with */
+static const size_t READ_BUFFER_SIZE = 4096;
+
+
+struct ProcessRunner::Data : public wxEvtHandler
+{
+  /**
+   * a program that is waiting or running
+   */
+  struct Request
+  {
+    Kind kind;
+    ProcessData data;
+
+    Request(Kind kind_, const ProcessData & data_)
+      : kind(kind_), data(data_)
+    {
+    }
+  };
+
+  /**
+   * a running program. It tells the runner when it
+   * terminates and deletes itself then
+   */
+  class Process : public wxProcess
+  {
+  public:
+    /** the runner, 0 if it is gone already */
+    Data * runner;
+    Request request;
+
+    /** output read already, but without line end yet */
+    std::string outputTail;
+    std::string errorTail;
+
+    Process(Data * runner_, const Request & request_)
+      : runner(runner_), request(request_)
+    {
+    }
+
+    virtual void
+    OnTerminate(int WXUNUSED(pid), int status)
+    {
+      if (runner != 0)
+        runner->OnTerminate(this, status);
+
+      delete this;
+    }
+  };
+
+  typedef std::list<Process *> ProcessList;
+
+  wxWindow * parent;
+  Tracer * tracer;
+  ProcessList running;
+  std::deque<Request> waiting;
+  wxTimer timer;
+
+  Data(wxWindow * parent_, Tracer * tracer_)
+    : parent(parent_), tracer(tracer_)
+  {
+    timer.SetOwner(this);
+    Connect(wxEVT_TIMER, wxTimerEventHandler(Data::OnTimer));
+  }
+
+  virtual ~Data()
+  {
+    timer.Stop();
+
+    ProcessList::iterator it;
+    for (it = running.begin(); it != running.end(); it++)
+      (*it)->runner = 0;
+  }
+
+  void
+  Trace(const wxString & msg)
+  {
+    if (tracer)
+      tracer->Trace(msg);
+  }
+
+  void
+  TraceError(const wxString & msg)
+  {
+    if (tracer)
+      tracer->TraceError(msg);
+  }
+
+  size_t
+  CountDiffTools() const
+  {
+    size_t count = 0;
+
+    ProcessList::const_iterator it;
+    for (it = running.begin(); it != running.end(); it++)
+    {
+      if ((*it)->request.kind == DIFF_TOOL)
+        count++;
+    }
+
+    return count;
+  }
+
+  void
+  Run(const Request & request)
+  {
+    if ((request.kind == DIFF_TOOL) && (CountDiffTools() >= MAX_DIFF_TOOLS))
+    {
+      Trace(wxString::Format(_("Waiting for a diff tool to be closed: %s"),
+                             request.data.command.c_str()));
+      waiting.push_back(request);
+      return;
+    }
+
+    Start(request);
+  }
+
+  /**
+   * starts the waiting programs as long as there are free slots
+   */
+  void
+  StartWaiting()
+  {
+    while (!waiting.empty() && (CountDiffTools() < MAX_DIFF_TOOLS))
+    {
+      Request request(waiting.front());
+      waiting.pop_front();
+
+      Start(request);
+    }
+  }
+
+  void
+  Start(const Request & request)
+  {
+    const wxString & command = request.data.command;
+    Process * process = new Process(this, request);
+
+    if (request.kind == COMMAND)
+    {
+      Trace(wxString::Format(_("Running command %s:"), command.c_str()));
+      process->Redirect();
+    }
+
+    if (Execute(command, process) == 0)
+    {
+      // the process was never created, there
+      // won't be any notification for it
+      delete process;
+
+      TraceError(wxString::Format(_("Execution of command failed: '%s'"),
+                                  command.c_str()));
+      return;
+    }
+
+    running.push_back(process);
+
+    if ((request.kind == COMMAND) && !timer.IsRunning())
+      timer.Start(POLL_INTERVAL);
+  }
+
+  /**
+   * wraps @a wxExecute, which returns the process id or 0
+   */
+  long
+  Execute(const wxString & command, wxProcess * process)
+  {
+#ifdef _WIN32
+    // recover initial environment
+    wxString apr_iconv_path;
+    bool saved_apr_iconv_path = false;
+    if (wxGetEnv(wxT("__SAVED_APR_ICONV_PATH"), &apr_iconv_path))
+    {
+      saved_apr_iconv_path = true;
+      wxSetEnv(wxT("APR_ICONV_PATH"), apr_iconv_path.c_str());
+      wxUnsetEnv(wxT("__SAVED_APR_ICONV_PATH"));
+    }
+#endif
+    long pid = wxExecute(command, wxEXEC_ASYNC, process);
+#ifdef _WIN32
+    // set custom environment again
+    if (saved_apr_iconv_path)
+    {
+      wxSetEnv(wxT("__SAVED_APR_ICONV_PATH"), apr_iconv_path.c_str());
+      wxSetEnv(wxT("APR_ICONV_PATH"), wxStandardPaths::Get().GetDataDir() + wxT("\\iconv"));
+    }
+#endif
+    return pid;
+  }
+
+  /**
+   * writes the output that is available so far to the log.
+   *
+   * Only the bytes that are there already are read, a line
+   * that isn't complete yet stays in the tail of the process
+   * until the next call. With @a final the tails are written
+   * as well.
+   */
+  void
+  ReadOutput(Process * process, bool final = false)
+  {
+    ReadLines(process->GetInputStream(), process->outputTail, false, final);
+    ReadLines(process->GetErrorStream(), process->errorTail, true, final);
+  }
+
+  void
+  ReadLines(wxInputStream * stream, std::string & tail,
+            bool error, bool final)
+  {
+    char buffer[READ_BUFFER_SIZE];
+
+    while ((stream != 0) && stream->CanRead())
+    {
+      stream->Read(buffer, sizeof(buffer));
+      size_t count = stream->LastRead();
+      if (count == 0)
+        break;
+
+      tail.append(buffer, count);
+    }
+
+    std::string::size_type start = 0;
+    std::string::size_type end;
+    while ((end = tail.find('\n', start)) != std::string::npos)
+    {
+      TraceLine(tail.substr(start, end - start), error);
+      start = end + 1;
+    }
+    tail.erase(0, start);
+
+    if (final && !tail.empty())
+    {
+      TraceLine(tail, error);
+      tail.clear();
+    }
+  }
+
+  void
+  TraceLine(std::string line, bool error)
+  {
+    if (!line.empty() && (line[line.length() - 1] == '\r'))
+      line.erase(line.length() - 1);
+
+    wxString msg(line.c_str(), wxConvLocal);
+    if (error)
+      TraceError(msg);
+    else
+      Trace(msg);
+  }
+
+  void
+  OnTerminate(Process * process, int status)
+  {
+    const Request & request = process->request;
+    const wxString & command = request.data.command;
+
+    running.remove(process);
+
+    if (request.kind == COMMAND)
+    {
+      ReadOutput(process, true);
+
+      if (status != 0)
+        TraceError(wxString::Format(_("Command failed with exit code %d: %s"),
+                                    status, command.c_str()));
+      else if (request.data.doneToken != 0)
+        ActionEvent::Post(parent, request.data.doneToken,
+                          request.data.doneMessage);
+    }
+    else if (status != 0)
+    {
+      // tools like diff use the exit code for
+      // their result, so this is no error
+      Trace(wxString::Format(_("Exit code %d: %s"),
+                             status, command.c_str()));
+    }
+
+    if (!HasCommands())
+      timer.Stop();
+
+    StartWaiting();
+  }
+
+  bool
+  HasCommands() const
+  {
+    ProcessList::const_iterator it;
+    for (it = running.begin(); it != running.end(); it++)
+    {
+      if ((*it)->request.kind == COMMAND)
+        return true;
+    }
+
+    return false;
+  }
+
+  void
+  OnTimer(wxTimerEvent & WXUNUSED(event))
+  {
+    ProcessList::iterator it;
+    for (it = running.begin(); it != running.end(); it++)
+    {
+      if ((*it)->request.kind == COMMAND)
+        ReadOutput(*it);
+    }
+  }
+};
+
+
+ProcessRunner::ProcessRunner(wxWindow * parent, Tracer * tracer)
+  : m(new Data(parent, tracer))
+{
+}
+
+
+ProcessRunner::~ProcessRunner()
+{
+  delete m;
+}
+
+
+void
+ProcessRunner::Run(Kind kind, const wxString & command)
+{
+  m->Run(Data::Request(kind, ProcessData(command)));
+}
+
+
+void
+ProcessRunner::Run(const ProcessData & data)
+{
+  m->Run(Data::Request(COMMAND, data));
+}
+
+
+size_t
+ProcessRunner::GetCount() const
+{
+  return m->running.size() + m->waiting.size();
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
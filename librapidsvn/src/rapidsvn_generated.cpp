@@ -54,6 +54,47 @@ AboutDlgBase::~AboutDlgBase()
 {
 }
 
+ActionStatisticsDlgBase::ActionStatisticsDlgBase( wxWindow* parent, wxWindowID id, const wxString& title, const wxPoint& pos, const wxSize& size, long style ) : wxDialog( parent, id, title, pos, size, style )
+{
+	this->SetSizeHints( wxDefaultSize, wxDefaultSize );
+	
+	m_mainSizer = new wxBoxSizer( wxVERTICAL );
+	
+	m_list = new wxListCtrl( this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT );
+	m_mainSizer->Add( m_list, 1, wxALL|wxEXPAND, 5 );
+	
+	m_buttonSizer = new wxBoxSizer( wxHORIZONTAL );
+	
+	m_buttonExport = new wxButton( this, wxID_ANY, _("&Export..."), wxDefaultPosition, wxDefaultSize, 0 );
+	m_buttonSizer->Add( m_buttonExport, 0, wxALL, 10 );
+	
+	m_buttonClear = new wxButton( this, wxID_ANY, _("&Clear"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_buttonSizer->Add( m_buttonClear, 0, wxALL, 10 );
+	
+	
+	m_buttonSizer->Add( 20, 20, 1, wxEXPAND, 5 );
+	
+	m_buttonOK = new wxButton( this, wxID_OK, _("OK"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_buttonOK->SetDefault(); 
+	m_buttonSizer->Add( m_buttonOK, 0, wxALL, 10 );
+	
+	m_mainSizer->Add( m_buttonSizer, 0, wxEXPAND, 5 );
+	
+	this->SetSizer( m_mainSizer );
+	this->Layout();
+	
+	// Connect Events
+	m_buttonExport->Connect( wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler( ActionStatisticsDlgBase::OnExport ), NULL, this );
+	m_buttonClear->Connect( wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler( ActionStatisticsDlgBase::OnClear ), NULL, this );
+}
+
+ActionStatisticsDlgBase::~ActionStatisticsDlgBase()
+{
+	// Disconnect Events
+	m_buttonExport->Disconnect( wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler( ActionStatisticsDlgBase::OnExport ), NULL, this );
+	m_buttonClear->Disconnect( wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler( ActionStatisticsDlgBase::OnClear ), NULL, this );
+}
+
 AnnotateDlgBase::AnnotateDlgBase( wxWindow* parent, wxWindowID id, const wxString& title, const wxPoint& pos, const wxSize& size, long style ) : wxDialog( parent, id, title, pos, size, style )
 {
 	this->SetSizeHints( wxDefaultSize, wxDefaultSize );
@@ -1547,6 +1588,9 @@ PreferencesDlgBase::PreferencesDlgBase( wxWindow* parent, wxWindowID id, const w
 	m_checkResetFlatMode = new wxCheckBox( m_panelGeneral, wxID_ANY, _("Reset Flat Mode on every program start"), wxDefaultPosition, wxDefaultSize, 0 );
 	bSizer3->Add( m_checkResetFlatMode, 0, wxALL, 5 );
 	
+	m_checkSingleInstance = new wxCheckBox( m_panelGeneral, wxID_ANY, _("Reuse the running program when started again"), wxDefaultPosition, wxDefaultSize, 0 );
+	bSizer3->Add( m_checkSingleInstance, 0, wxALL, 5 );
+	
 	m_panelGeneral->SetSizer( bSizer3 );
 	m_panelGeneral->Layout();
 	bSizer3->Fit( m_panelGeneral );
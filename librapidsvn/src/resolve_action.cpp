@@ -48,16 +48,8 @@ ResolveAction::Prepare()
 bool
 ResolveAction::Perform()
 {
-  const svn::PathVector v = GetTargets();
-  svn::PathVector::const_iterator it;
-
   svn::Client client(GetContext());
-  for (it = v.begin(); it != v.end(); it++)
-  {
-    const svn::Path & path = *it;
-
-    client.resolved(path.c_str(), false);
-  }
+  client.resolved(GetTargets(), false);
 
   return true;
 }
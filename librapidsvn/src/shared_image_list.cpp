@@ -0,0 +1,105 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// wxWidgets
+#include "wx/wx.h"
+#include "wx/imaglist.h"
+#include "wx/module.h"
+
+// app
+#include "shared_image_list.hpp"
+
+
+/** lists that have been created and have to be deleted on shutdown */
+static SharedImageList * CreatedLists = 0;
+
+
+SharedImageList::SharedImageList(FillFunc fill, int width, int height)
+    : m_fill(fill), m_width(width), m_height(height), m_list(0), m_next(0)
+{
+}
+
+
+wxImageList *
+SharedImageList::Get()
+{
+  if (m_list == 0)
+  {
+    m_list = new wxImageList(m_width, m_height, TRUE);
+    m_fill(*m_list);
+
+    m_next = CreatedLists;
+    CreatedLists = this;
+  }
+
+  return m_list;
+}
+
+
+void
+SharedImageList::DeleteAll()
+{
+  while (CreatedLists != 0)
+  {
+    SharedImageList * shared = CreatedLists;
+    CreatedLists = shared->m_next;
+
+    delete shared->m_list;
+    shared->m_list = 0;
+    shared->m_next = 0;
+  }
+}
+
+
+/**
+ * Deletes the shared lists while wxWidgets is still
+ * initialized. The static @ref SharedImageList objects
+ * themselves are destroyed too late for that.
+ */
+class SharedImageListModule : public wxModule
+{
+public:
+  virtual bool
+  OnInit()
+  {
+    return true;
+  }
+
+  virtual void
+  OnExit()
+  {
+    SharedImageList::DeleteAll();
+  }
+
+private:
+  DECLARE_DYNAMIC_CLASS(SharedImageListModule)
+};
+
+IMPLEMENT_DYNAMIC_CLASS(SharedImageListModule, wxModule)
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
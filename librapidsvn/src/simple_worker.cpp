@@ -28,12 +28,15 @@
 // svncpp
 #include "svncpp/context.hpp"
 #include "svncpp/exception.hpp"
+#include "svncpp/trace.hpp"
 
 // app
 #include "action.hpp"
 #include "action_event.hpp"
+#include "action_statistics.hpp"
 #include "ids.hpp"
 #include "simple_worker.hpp"
+#include "stall_watchdog.hpp"
 #include "tracer.hpp"
 #include "utils.hpp"
 
@@ -47,6 +50,7 @@ public:
   bool ownContext;
   ActionState state;
   ActionResult result;
+  ActionMeasurement measurement;
 
   /**
    * constructor
@@ -138,7 +142,9 @@ SimpleWorker::Perform(Action * action)
   }
 
   action->SetContext(m->context);
+  action->SetWorker(this);
   m->context->reset();
+  m->measurement.Start(action->GetName(), m->context);
 
   m->result = ACTION_NOTHING;
   m->action = action;
@@ -146,6 +152,9 @@ SimpleWorker::Perform(Action * action)
 
   try
   {
+    svn::TraceSpan span("action", LocalToUtf8(wxT("Prepare ") + action->GetName()));
+    StallWatchdog::Scope scope(wxT("Prepare ") + action->GetName());
+    m->measurement.BeginPhase();
     if (!m->action->Prepare())
     {
       m->result = ACTION_ABORTED;
@@ -160,14 +169,18 @@ SimpleWorker::Perform(Action * action)
     wxString msg, errtxt(Utf8ToLocal(e.message()));
     msg.Printf(_("Error while preparing action: %s"), errtxt.c_str());
     TraceError(msg);
+    m->measurement.Finish(false);
     return false;
   }
   catch (...)
   {
     TraceError(_("Error while preparing action."));
+    m->measurement.Finish(false);
     return false;
   }
 
+  m->measurement.EndPhase(true);
+
   ActionEvent event(m->parent, TOKEN_ACTION_START);
 
   {
@@ -185,7 +198,11 @@ SimpleWorker::Perform(Action * action)
     // this cursor stuff has to change...
     wxBusyCursor wait;
     m->state = ACTION_RUNNING;
+    svn::TraceSpan span("action", LocalToUtf8(wxT("Perform ") + action->GetName()));
+    StallWatchdog::Scope scope(wxT("Perform ") + action->GetName());
+    m->measurement.BeginPhase();
     bool result = m->action->Perform();
+    m->measurement.EndPhase(true);
     if (!result)
     {
       m->result = ACTION_ERROR;
@@ -209,6 +226,8 @@ SimpleWorker::Perform(Action * action)
     event.init(m->parent, TOKEN_SVN_INTERNAL_ERROR, msg);
     event.Post();
 
+    m->measurement.EndPhase(true);
+    m->measurement.Finish(false);
     return false;
   }
   catch (...)
@@ -218,15 +237,26 @@ SimpleWorker::Perform(Action * action)
     event.init(m->parent, TOKEN_SVN_INTERNAL_ERROR, msg);
     event.Post();
 
+    m->measurement.EndPhase(true);
+    m->measurement.Finish(false);
     return false;
   }
 
+  m->measurement.Finish(m->result == ACTION_SUCCESS);
+
   event.init(m->parent, TOKEN_ACTION_END, (void*) new unsigned int(actionFlags));
   event.Post();
 
   return true;
 }
 
+void
+SimpleWorker::PrepareInBackground(Action * action)
+{
+  // there is no background, do the work right away
+  action->RunPrepareInBackground();
+}
+
 void
 SimpleWorker::SetTracer(Tracer * tracer)
 {
@@ -0,0 +1,203 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// wxWidgets
+#include "wx/wx.h"
+#include "wx/ipc.h"
+#include "wx/snglinst.h"
+#include "wx/utils.h"
+
+// app
+#include "main_frame.hpp"
+#include "single_instance.hpp"
+
+/** the one and only topic of the conversation */
+static const wxChar IPC_TOPIC[] = wxT("open");
+
+/** how often, and how long in between, a new invocation tries to connect */
+static const int CONNECT_RETRIES = 5;
+static const int CONNECT_RETRY_DELAY = 200;
+
+
+/**
+ * @return name of the lock that tells whether the user
+ *         is running RapidSVN already
+ */
+static wxString
+GetCheckerName()
+{
+  return wxString::Format(wxT("rapidsvn-%s"), wxGetUserId().c_str());
+}
+
+
+/**
+ * @return the DDE service name on Windows, otherwise the
+ *         name of the local socket. The socket is local to
+ *         the host, so its name has to be as well in case
+ *         the home directory is shared.
+ */
+static wxString
+GetServiceName()
+{
+#ifdef __WXMSW__
+  return GetCheckerName();
+#else
+  return wxString::Format(wxT("%s/.rapidsvn-%s.sock"),
+                          wxGetHomeDir().c_str(),
+                          wxGetHostName().c_str());
+#endif
+}
+
+
+/**
+ * Connection of the running process, receives the paths
+ */
+class OpenPathConnection : public wxConnection
+{
+public:
+#if wxCHECK_VERSION(2, 9, 0)
+  virtual bool
+  OnExecute(const wxString & WXUNUSED(topic), const void * data,
+            size_t size, wxIPCFormat format)
+  {
+    return OpenPath(GetTextFromData(data, size, format));
+  }
+#else
+  virtual bool
+  OnExecute(const wxString & WXUNUSED(topic), wxChar * data,
+            int WXUNUSED(size), wxIPCFormat WXUNUSED(format))
+  {
+    return OpenPath(data);
+  }
+#endif
+
+private:
+  bool
+  OpenPath(const wxString & path)
+  {
+    MainFrame * frame = dynamic_cast<MainFrame *>(wxTheApp->GetTopWindow());
+
+    // shutting down?
+    if (frame == 0)
+      return false;
+
+    frame->OpenPath(path);
+    return true;
+  }
+};
+
+
+class OpenPathServer : public wxServer
+{
+public:
+  virtual wxConnectionBase *
+  OnAcceptConnection(const wxString & topic)
+  {
+    if (topic != IPC_TOPIC)
+      return 0;
+
+    return new OpenPathConnection();
+  }
+};
+
+
+struct SingleInstance::Data
+{
+  wxSingleInstanceChecker checker;
+  OpenPathServer * server;
+
+  Data()
+      : checker(GetCheckerName()), server(0)
+  {
+  }
+
+  ~Data()
+  {
+    delete server;
+  }
+};
+
+
+SingleInstance::SingleInstance()
+    : m(new Data())
+{
+}
+
+
+SingleInstance::~SingleInstance()
+{
+  delete m;
+}
+
+
+bool
+SingleInstance::Forward(const wxString & path)
+{
+  if (!m->checker.IsAnotherRunning())
+    return false;
+
+  // the other process might still be starting up
+  // and not listening yet
+  wxClient client;
+  for (int i = 0; i < CONNECT_RETRIES; i++)
+  {
+    wxConnectionBase * connection =
+      client.MakeConnection(wxT("localhost"), GetServiceName(), IPC_TOPIC);
+
+    if (connection != 0)
+    {
+      bool success = connection->Execute(path);
+      connection->Disconnect();
+      delete connection;
+
+      return success;
+    }
+
+    wxMilliSleep(CONNECT_RETRY_DELAY);
+  }
+
+  return false;
+}
+
+
+void
+SingleInstance::Listen()
+{
+  if (m->server != 0)
+    return;
+
+  m->server = new OpenPathServer();
+  if (!m->server->Create(GetServiceName()))
+  {
+    // no harm done, new invocations start on their own
+    delete m->server;
+    m->server = 0;
+  }
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
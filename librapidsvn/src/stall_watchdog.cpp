@@ -0,0 +1,363 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// stl
+#include "svncpp/vector_wrapper.hpp"
+
+// wxWidgets
+#include "wx/wx.h"
+#include "wx/thread.h"
+
+// svncpp
+#include "svncpp/pool.hpp"
+
+// app
+#include "action_event.hpp"
+#include "action_statistics.hpp"
+#include "ids.hpp"
+#include "stall_watchdog.hpp"
+
+/**
+ * how often the watchdog looks at the GUI thread, in ms
+ */
+static const long POLL_INTERVAL = 100;
+
+StallWatchdog TheStallWatchdog;
+
+/**
+ * An event handler or a @a StallWatchdog::Scope
+ * the GUI thread is in
+ */
+struct StallFrame
+{
+  /** class of the event handler, 0 for a scope */
+  const wxChar * className;
+  int eventType;
+  int id;
+
+  /** name of the scope */
+  wxString name;
+
+  StallFrame()
+    : className(0), eventType(0), id(0)
+  {
+  }
+};
+
+struct StallWatchdog::Data
+{
+  /**
+   * receives the pings of the watchdog
+   * in the GUI thread
+   */
+  class PingHandler : public wxEvtHandler
+  {
+  public:
+    PingHandler(Data * data_)
+      : data(data_)
+    {
+    }
+
+    virtual bool
+    ProcessEvent(wxEvent & WXUNUSED(event))
+    {
+      data->Pong();
+      return true;
+    }
+
+  private:
+    Data * data;
+  };
+
+  class Thread : public wxThread
+  {
+  public:
+    Thread(Data * data_)
+      : wxThread(wxTHREAD_JOINABLE), data(data_)
+    {
+    }
+
+    virtual void *
+    Entry()
+    {
+      while (!data->stop)
+      {
+        data->Check();
+        Sleep(POLL_INTERVAL);
+      }
+
+      svn::Pool::threadExit();
+      return 0;
+    }
+
+  private:
+    Data * data;
+  };
+
+  /** is the watchdog running? Only changed in the GUI thread */
+  bool running;
+
+  /** tells the thread to end */
+  volatile bool stop;
+
+  wxWindow * parent;
+  long threshold;
+  Thread * thread;
+  PingHandler * handler;
+
+  /** protects everything below */
+  wxCriticalSection cs;
+
+  std::vector<StallFrame> frames;
+
+  /** is there a ping the GUI thread didn't answer yet? */
+  bool pingPending;
+  wxLongLong pingTime;
+  wxDateTime pingDate;
+
+  /** did the current ping take longer than the threshold? */
+  bool stalled;
+  wxString stallLocation;
+
+  Data()
+    : running(false), stop(false), parent(0), threshold(0),
+      thread(0), handler(0), pingPending(false), stalled(false)
+  {
+  }
+
+  /**
+   * @return the frames, from the outermost to the
+   *         innermost. The caller has to hold @a cs.
+   */
+  wxString
+  DescribeFrames() const
+  {
+    if (frames.empty())
+      return _("no event handler");
+
+    wxString str;
+    std::vector<StallFrame>::const_iterator it;
+    for (it = frames.begin(); it != frames.end(); ++it)
+    {
+      if (it != frames.begin())
+        str += wxT(" > ");
+
+      // the characters are copied on purpose: wxString
+      // isn't safe to share between threads
+      if (it->className == 0)
+        str += it->name.c_str();
+      else
+        str += wxString::Format(wxT("%s (event %d, id %d)"),
+                                it->className, it->eventType, it->id);
+    }
+
+    return str;
+  }
+
+  /**
+   * called by the watchdog thread: pings the GUI thread
+   * or notices that it doesn't answer
+   */
+  void
+  Check()
+  {
+    bool ping = false;
+
+    {
+      wxCriticalSectionLocker lock(cs);
+      wxLongLong now = wxGetLocalTimeMillis();
+
+      if (!pingPending)
+      {
+        pingPending = true;
+        pingTime = now;
+        pingDate = wxDateTime::Now();
+        ping = true;
+      }
+      else if (!stalled && ((now - pingTime) > threshold))
+      {
+        // remember what is running now, by the time the
+        // GUI thread responds it is done
+        stalled = true;
+        stallLocation = DescribeFrames();
+      }
+    }
+
+    if (ping)
+    {
+      wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED);
+      handler->AddPendingEvent(event);
+    }
+  }
+
+  /**
+   * called in the GUI thread when a ping arrives
+   */
+  void
+  Pong()
+  {
+    StallStatistics stall;
+    bool report = false;
+
+    {
+      wxCriticalSectionLocker lock(cs);
+
+      pingPending = false;
+      if (stalled)
+      {
+        stalled = false;
+        report = true;
+
+        stall.start = pingDate;
+        stall.durationMs = (wxGetLocalTimeMillis() - pingTime).ToLong();
+        stall.location = stallLocation.c_str();
+      }
+    }
+
+    if (report)
+    {
+      TheActionStatistics.AddStall(stall);
+      ActionEvent::Post(parent, TOKEN_INFO, stall.Format());
+    }
+  }
+
+  void
+  Push(const StallFrame & frame)
+  {
+    wxCriticalSectionLocker lock(cs);
+
+    frames.push_back(frame);
+  }
+
+  void
+  Pop()
+  {
+    wxCriticalSectionLocker lock(cs);
+
+    // there may have been handlers running
+    // when the watchdog was started
+    if (!frames.empty())
+      frames.pop_back();
+  }
+};
+
+StallWatchdog::StallWatchdog()
+  : m(new Data)
+{
+}
+
+StallWatchdog::~StallWatchdog()
+{
+  Stop();
+  delete m;
+}
+
+void
+StallWatchdog::Start(wxWindow * parent, long thresholdMs)
+{
+  Stop();
+
+  if (thresholdMs <= 0)
+    return;
+
+  m->parent = parent;
+  m->threshold = thresholdMs;
+  m->stop = false;
+  m->pingPending = false;
+  m->stalled = false;
+  m->frames.clear();
+
+  m->handler = new Data::PingHandler(m);
+  m->thread = new Data::Thread(m);
+
+  if ((m->thread->Create() != wxTHREAD_NO_ERROR) ||
+      (m->thread->Run() != wxTHREAD_NO_ERROR))
+  {
+    delete m->thread;
+    m->thread = 0;
+    delete m->handler;
+    m->handler = 0;
+    return;
+  }
+
+  m->running = true;
+}
+
+void
+StallWatchdog::Stop()
+{
+  if (!m->running)
+    return;
+
+  m->running = false;
+  m->stop = true;
+
+  // joinable threads have to be waited for
+  m->thread->Wait();
+  delete m->thread;
+  m->thread = 0;
+
+  // a pending ping is discarded with the handler
+  delete m->handler;
+  m->handler = 0;
+}
+
+StallWatchdog::Scope::Scope(const wxString & name)
+  : m_entered(TheStallWatchdog.m->running)
+{
+  if (m_entered)
+  {
+    StallFrame frame;
+    frame.name = name;
+
+    TheStallWatchdog.m->Push(frame);
+  }
+}
+
+StallWatchdog::Scope::Scope(wxEvtHandler * handler, const wxEvent & event)
+  : m_entered(TheStallWatchdog.m->running)
+{
+  if (m_entered)
+  {
+    StallFrame frame;
+    frame.className = handler->GetClassInfo()->GetClassName();
+    frame.eventType = (int)event.GetEventType();
+    frame.id = event.GetId();
+
+    TheStallWatchdog.m->Push(frame);
+  }
+}
+
+StallWatchdog::Scope::~Scope()
+{
+  if (m_entered)
+    TheStallWatchdog.m->Pop();
+}
+
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
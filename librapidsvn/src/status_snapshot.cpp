@@ -0,0 +1,450 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+// wxWidgets
+#include "wx/wx.h"
+#include "wx/datstrm.h"
+#include "wx/filename.h"
+#include "wx/stdpaths.h"
+#include "wx/wfstream.h"
+
+// apr
+#include "apr_pools.h"
+
+// svncpp
+#include "svncpp/context.hpp"
+#include "svncpp/context_listener.hpp"
+#include "svncpp/entry.hpp"
+#include "svncpp/exception.hpp"
+#include "svncpp/pool.hpp"
+#include "svncpp/status.hpp"
+#include "svncpp/trace.hpp"
+
+// app
+#include "action_event.hpp"
+#include "ids.hpp"
+#include "status_snapshot.hpp"
+#include "utils.hpp"
+
+static const char SNAPSHOT_MAGIC [] = "RSVNSNAP";
+static const size_t SNAPSHOT_MAGIC_LENGTH = 8;
+static const wxUint32 SNAPSHOT_VERSION = 1;
+
+/** marks a NULL string in the snapshot */
+static const wxUint32 NULL_STRING = 0xffffffff;
+
+/** sanity limit for strings read from a snapshot */
+static const wxUint32 MAX_STRING_LENGTH = 0x100000;
+
+static void
+WriteString(wxDataOutputStream & out, const char * str)
+{
+  if (str == 0)
+  {
+    out.Write32(NULL_STRING);
+    return;
+  }
+
+  wxUint32 length = strlen(str);
+  out.Write32(length);
+  out.Write8((const wxUint8 *)str, length);
+}
+
+/**
+ * reads a string written by @ref WriteString
+ *
+ * @return string allocated in @a pool or NULL
+ */
+static const char *
+ReadString(wxDataInputStream & in, wxInputStream & stream,
+           apr_pool_t * pool, bool & ok)
+{
+  wxUint32 length = in.Read32();
+  if (length == NULL_STRING)
+    return 0;
+
+  if (length > MAX_STRING_LENGTH)
+  {
+    ok = false;
+    return 0;
+  }
+
+  char * str = (char *)apr_palloc(pool, length + 1);
+  in.Read8((wxUint8 *)str, length);
+  str[length] = '\0';
+
+  if (!stream.IsOk())
+    ok = false;
+
+  return str;
+}
+
+wxString
+GetStatusSnapshotFileName()
+{
+  wxFileName fileName(wxStandardPaths::Get().GetUserDataDir(),
+                      wxT("filelist.snapshot"));
+
+  return fileName.GetFullPath();
+}
+
+bool
+WriteStatusSnapshot(const wxString & fileName,
+                    const wxString & path, bool flat,
+                    const svn::StatusEntries & entries)
+{
+  wxFileName name(fileName);
+  if (!name.DirExists() && !wxFileName::Mkdir(name.GetPath(), 0777, wxPATH_MKDIR_FULL))
+    return false;
+
+  // write to a temporary file first, so an interrupted
+  // write doesnt leave a broken snapshot behind
+  wxString tempName(fileName + wxT(".tmp"));
+  {
+    wxFileOutputStream file(tempName);
+    if (!file.IsOk())
+      return false;
+
+    wxBufferedOutputStream stream(file);
+    wxDataOutputStream out(stream);
+
+    out.Write8((const wxUint8 *)SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LENGTH);
+    out.Write32(SNAPSHOT_VERSION);
+    WriteString(out, LocalToUtf8(path).c_str());
+    out.Write8(flat ? 1 : 0);
+    out.Write32(entries.size());
+
+    svn::StatusEntries::const_iterator it;
+    for (it = entries.begin(); it != entries.end(); it++)
+    {
+      const svn::Status & status = *it;
+
+      WriteString(out, status.path());
+      out.Write32(status.textStatus());
+      out.Write32(status.propStatus());
+      out.Write8(status.isCopied() ? 1 : 0);
+      out.Write8(status.isSwitched() ? 1 : 0);
+
+      const svn::Entry entry(status.entry());
+      out.Write8(entry.isValid() ? 1 : 0);
+      if (!entry.isValid())
+        continue;
+
+      const svn_wc_entry_t * e = entry;
+      WriteString(out, e->name);
+      out.Write64((wxUint64)e->revision);
+      WriteString(out, e->url);
+      WriteString(out, e->repos);
+      WriteString(out, e->uuid);
+      out.Write32(e->kind);
+      out.Write32(e->schedule);
+      out.Write8(e->copied ? 1 : 0);
+      WriteString(out, e->copyfrom_url);
+      out.Write64((wxUint64)e->copyfrom_rev);
+      WriteString(out, e->conflict_old);
+      WriteString(out, e->conflict_new);
+      WriteString(out, e->conflict_wrk);
+      WriteString(out, e->prejfile);
+      out.Write64((wxUint64)e->text_time);
+      out.Write64((wxUint64)e->prop_time);
+      WriteString(out, e->checksum);
+      out.Write64((wxUint64)e->cmt_rev);
+      out.Write64((wxUint64)e->cmt_date);
+      WriteString(out, e->cmt_author);
+      WriteString(out, e->lock_token);
+      WriteString(out, e->lock_owner);
+      WriteString(out, e->lock_comment);
+      out.Write64((wxUint64)e->lock_creation_date);
+    }
+
+    stream.Sync();
+    if (!stream.IsOk() || !file.Close())
+    {
+      ::wxRemoveFile(tempName);
+      return false;
+    }
+  }
+
+  return ::wxRenameFile(tempName, fileName, true);
+}
+
+bool
+ReadStatusSnapshot(const wxString & fileName,
+                   wxString & path, bool & flat,
+                   svn::StatusEntries & entries)
+{
+  entries.clear();
+
+  if (!::wxFileExists(fileName))
+    return false;
+
+  wxFileInputStream file(fileName);
+  if (!file.IsOk())
+    return false;
+
+  wxBufferedInputStream stream(file);
+  wxDataInputStream in(stream);
+
+  char magic [SNAPSHOT_MAGIC_LENGTH];
+  in.Read8((wxUint8 *)magic, SNAPSHOT_MAGIC_LENGTH);
+  if (!stream.IsOk() ||
+      (memcmp(magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LENGTH) != 0) ||
+      (in.Read32() != SNAPSHOT_VERSION))
+    return false;
+
+  bool ok = true;
+  svn::Pool pool;
+
+  const char * pathUtf8 = ReadString(in, stream, pool, ok);
+  if (!ok || (pathUtf8 == 0))
+    return false;
+
+  path = Utf8ToLocal(pathUtf8);
+  flat = in.Read8() != 0;
+
+  wxUint32 count = in.Read32();
+  entries.reserve(count);
+
+  for (wxUint32 i = 0; ok && (i < count); i++)
+  {
+    pool.renew();
+
+    svn_wc_status2_t * status =
+      (svn_wc_status2_t *)apr_pcalloc(pool, sizeof(svn_wc_status2_t));
+
+    const char * statusPath = ReadString(in, stream, pool, ok);
+    status->text_status = (svn_wc_status_kind)in.Read32();
+    status->prop_status = (svn_wc_status_kind)in.Read32();
+    status->copied = in.Read8() != 0;
+    status->switched = in.Read8() != 0;
+    status->repos_text_status = svn_wc_status_none;
+    status->repos_prop_status = svn_wc_status_none;
+    status->ood_last_cmt_rev = SVN_INVALID_REVNUM;
+    status->ood_kind = svn_node_none;
+
+    if (in.Read8() != 0)
+    {
+      svn_wc_entry_t * e =
+        (svn_wc_entry_t *)apr_pcalloc(pool, sizeof(svn_wc_entry_t));
+
+      e->name = ReadString(in, stream, pool, ok);
+      e->revision = (svn_revnum_t)in.Read64();
+      e->url = ReadString(in, stream, pool, ok);
+      e->repos = ReadString(in, stream, pool, ok);
+      e->uuid = ReadString(in, stream, pool, ok);
+      e->kind = (svn_node_kind_t)in.Read32();
+      e->schedule = (svn_wc_schedule_t)in.Read32();
+      e->copied = in.Read8() != 0;
+      e->copyfrom_url = ReadString(in, stream, pool, ok);
+      e->copyfrom_rev = (svn_revnum_t)in.Read64();
+      e->conflict_old = ReadString(in, stream, pool, ok);
+      e->conflict_new = ReadString(in, stream, pool, ok);
+      e->conflict_wrk = ReadString(in, stream, pool, ok);
+      e->prejfile = ReadString(in, stream, pool, ok);
+      e->text_time = (apr_time_t)in.Read64();
+      e->prop_time = (apr_time_t)in.Read64();
+      e->checksum = ReadString(in, stream, pool, ok);
+      e->cmt_rev = (svn_revnum_t)in.Read64();
+      e->cmt_date = (apr_time_t)in.Read64();
+      e->cmt_author = ReadString(in, stream, pool, ok);
+      e->lock_token = ReadString(in, stream, pool, ok);
+      e->lock_owner = ReadString(in, stream, pool, ok);
+      e->lock_comment = ReadString(in, stream, pool, ok);
+      e->lock_creation_date = (apr_time_t)in.Read64();
+      e->depth = (e->kind == svn_node_dir) ? svn_depth_infinity : svn_depth_empty;
+      e->working_size = SVN_WC_ENTRY_WORKING_SIZE_UNKNOWN;
+
+      status->entry = e;
+      status->url = e->url;
+    }
+
+    if (!stream.IsOk() || (statusPath == 0))
+      ok = false;
+
+    if (ok)
+      entries.push_back(svn::Status(statusPath, status));
+  }
+
+  if (!ok)
+    entries.clear();
+
+  return ok;
+}
+
+struct StatusRevalidator::Data : public wxThread, public svn::ContextListener
+{
+public:
+  wxWindow * parent;
+  wxString path;
+  bool flat;
+  bool created;
+  volatile bool cancelled;
+  volatile bool running;
+
+  Data(wxWindow * parent_, const wxString & path_, bool flat_)
+      : wxThread(wxTHREAD_JOINABLE), parent(parent_),
+      path(path_.c_str()), flat(flat_), created(false),
+      cancelled(false), running(false)
+  {
+    if (Create() != wxTHREAD_NO_ERROR)
+      return;
+
+    running = true;
+    created = Run() == wxTHREAD_NO_ERROR;
+    if (!created)
+      running = false;
+  }
+
+  /**
+   * thread execution starts here
+   */
+  virtual void *
+  Entry()
+  {
+    svn::TraceSpan span("filelist", "Revalidate");
+    RevalidatedStatus * result = new RevalidatedStatus;
+    result->path = path.c_str();
+    result->flat = flat;
+
+    try
+    {
+      svn::Context context;
+      context.setListener(this);
+
+      svn::StatusFilter filter;
+      filter.showUnversioned = true;
+      filter.showUnmodified = true;
+      filter.showModified = true;
+      filter.showConflicted = true;
+      filter.showIgnored = true;
+      filter.showExternals = true;
+
+      svn::Client client(&context);
+      client.status(PathUtf8(path).c_str(), filter, flat, false,
+                    result->entries);
+    }
+    catch (svn::ClientException & e)
+    {
+      result->error = Utf8ToLocal(e.message());
+    }
+    catch (...)
+    {
+      result->error = _("Error while updating filelist");
+    }
+
+    running = false;
+
+    if (cancelled)
+      delete result;
+    else
+      ActionEvent::Post(parent, TOKEN_STATUS_REVALIDATED, (void*)result);
+
+    // the entries keep the pools they use alive
+    svn::Pool::threadExit();
+    return 0;
+  }
+
+  // nobody is there to answer prompts: refuse all of them
+  virtual bool
+  contextGetLogin(const std::string & WXUNUSED(realm),
+                  std::string & WXUNUSED(username),
+                  std::string & WXUNUSED(password),
+                  bool & WXUNUSED(maySave))
+  {
+    return false;
+  }
+
+  virtual void
+  contextNotify(const char * WXUNUSED(path),
+                svn_wc_notify_action_t WXUNUSED(action),
+                svn_node_kind_t WXUNUSED(kind),
+                const char * WXUNUSED(mime_type),
+                svn_wc_notify_state_t WXUNUSED(content_state),
+                svn_wc_notify_state_t WXUNUSED(prop_state),
+                svn_revnum_t WXUNUSED(revision))
+  {
+  }
+
+  virtual bool
+  contextCancel()
+  {
+    return cancelled;
+  }
+
+  virtual bool
+  contextGetLogMessage(std::string & WXUNUSED(msg))
+  {
+    return false;
+  }
+
+  virtual SslServerTrustAnswer
+  contextSslServerTrustPrompt(const SslServerTrustData & WXUNUSED(data),
+                              apr_uint32_t & WXUNUSED(acceptedFailures))
+  {
+    return DONT_ACCEPT;
+  }
+
+  virtual bool
+  contextSslClientCertPrompt(std::string & WXUNUSED(certFile))
+  {
+    return false;
+  }
+
+  virtual bool
+  contextSslClientCertPwPrompt(std::string & WXUNUSED(password),
+                               const std::string & WXUNUSED(realm),
+                               bool & WXUNUSED(maySave))
+  {
+    return false;
+  }
+};
+
+StatusRevalidator::StatusRevalidator(wxWindow * parent,
+                                     const wxString & path, bool flat)
+    : m(new Data(parent, path, flat))
+{
+}
+
+StatusRevalidator::~StatusRevalidator()
+{
+  m->cancelled = true;
+
+  // joinable threads have to be waited for, even if
+  // they are done already
+  if (m->created)
+    m->Wait();
+
+  delete m;
+}
+
+bool
+StatusRevalidator::IsRunning() const
+{
+  return m->running;
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../rapidsvn-dev.el")
+ * end:
+ */
@@ -27,7 +27,6 @@
 
 // svncpp
 #include "svncpp/client.hpp"
-#include "svncpp/info.hpp"
 #include "svncpp/status.hpp"
 #include "svncpp/url.hpp"
 
@@ -70,11 +69,11 @@ SwitchAction::Prepare()
   // first try to get the URL for the target
   svn::Path path = GetTarget();
   svn::Client client(GetContext());
-  svn::InfoVector infoVector(client.info(path));
-  if (infoVector.size() != 1)
+  svn::RepositoryInfo info(client.repositoryInfo(path));
+  if (info.url.empty())
     return false;
 
-  m->old_url = Utf8ToLocal(svn::Url::unescape(infoVector[0].url()));
+  m->old_url = Utf8ToLocal(svn::Url::unescape(info.url.c_str()));
 
   SwitchDlg dlg(GetParent(), m->old_url, true, false);
 
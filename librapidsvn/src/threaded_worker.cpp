@@ -28,11 +28,15 @@
 // svncpp
 #include "svncpp/context.hpp"
 #include "svncpp/exception.hpp"
+#include "svncpp/pool.hpp"
+#include "svncpp/trace.hpp"
 
 // app
 #include "action.hpp"
 #include "action_event.hpp"
+#include "action_statistics.hpp"
 #include "ids.hpp"
+#include "stall_watchdog.hpp"
 #include "threaded_worker.hpp"
 #include "tracer.hpp"
 #include "utils.hpp"
@@ -43,11 +47,16 @@ public:
   wxWindow * parent;
   svn::Context * context;
   Action * action;
+
+  /** action that waits for PrepareInBackground */
+  Action * volatile preparing;
+
   Tracer * tracer;
   bool ownContext;
   ActionState state;
   ActionResult result;
   wxString actionName;
+  ActionMeasurement measurement;
 
   /**
    * constructor
@@ -74,6 +83,7 @@ public:
     this->parent = parent;
     context = 0;
     action = 0;
+    preparing = 0;
     tracer = 0;
     ownContext = false;
     state = ACTION_NONE;
@@ -113,10 +123,13 @@ public:
   {
     while (!TestDestroy())
     {
+      PrepareAction();
       ExecuteAction();
 
       Sleep(10);
     }
+
+    svn::Pool::threadExit();
     return 0;
   }
 
@@ -127,6 +140,21 @@ public:
     action = 0;
   }
 
+  /**
+   * runs the background part of the preparation
+   * if there is any, see Action::PrepareInBackground
+   */
+  void
+  PrepareAction()
+  {
+    Action * action = preparing;
+    if (action == 0)
+      return;
+
+    preparing = 0;
+    action->RunPrepareInBackground();
+  }
+
   /**
    * executes the action if there is any
    */
@@ -151,10 +179,13 @@ public:
     try
     {
       state = ACTION_RUNNING;
+      svn::TraceSpan span("action", LocalToUtf8(wxT("Perform ") + actionName));
+      measurement.BeginPhase();
       if (!action->Perform())
         result = ACTION_ERROR;
       else
         result = ACTION_SUCCESS;
+      measurement.EndPhase(false);
       actionFlags = action->GetFlags();
 
       state = ACTION_NONE;
@@ -170,6 +201,8 @@ public:
 
       state = ACTION_NONE;
       result = ACTION_ERROR;
+      measurement.EndPhase(false);
+      measurement.Finish(false);
       DeleteAction();
       return;
     }
@@ -182,10 +215,14 @@ public:
 
       state = ACTION_NONE;
       result = ACTION_ERROR;
+      measurement.EndPhase(false);
+      measurement.Finish(false);
       DeleteAction();
       return;
     }
 
+    measurement.Finish(result == ACTION_SUCCESS);
+
     event.init(parent, TOKEN_ACTION_END, (void*) new unsigned int(actionFlags));
     event.Post();
     DeleteAction();
@@ -254,13 +291,18 @@ ThreadedWorker::Perform(Action * action_)
   }
 
   action_->SetContext(m->context);
+  action_->SetWorker(this);
   m->context->reset();
+  m->measurement.Start(action_->GetName(), m->context);
 
   m->result = ACTION_NOTHING;
   m->state = ACTION_INIT;
 
   try
   {
+    svn::TraceSpan span("action", LocalToUtf8(wxT("Prepare ") + action_->GetName()));
+    StallWatchdog::Scope scope(wxT("Prepare ") + action_->GetName());
+    m->measurement.BeginPhase();
     if (!action_->Prepare())
     {
       m->result = ACTION_ABORTED;
@@ -275,6 +317,7 @@ ThreadedWorker::Perform(Action * action_)
     wxString msg, errtxt(Utf8ToLocal(e.message()));
     msg.Printf(_("Error while preparing action: %s"), errtxt.c_str());
     m->TraceError(msg);
+    m->measurement.Finish(false);
 
     m->result = ACTION_ERROR;
     m->state = ACTION_NONE;
@@ -284,6 +327,7 @@ ThreadedWorker::Perform(Action * action_)
   catch (...)
   {
     m->TraceError(_("Error while preparing action."));
+    m->measurement.Finish(false);
 
     m->result = ACTION_ERROR;
     m->state = ACTION_NONE;
@@ -291,12 +335,19 @@ ThreadedWorker::Perform(Action * action_)
     return false;
   }
 
+  m->measurement.EndPhase(true);
   m->actionName = action_->GetName();
   m->action = action_;
 
   return true;
 }
 
+void
+ThreadedWorker::PrepareInBackground(Action * action)
+{
+  m->preparing = action;
+}
+
 void
 ThreadedWorker::SetTracer(Tracer * tracer)
 {
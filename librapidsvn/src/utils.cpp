@@ -205,6 +205,7 @@ AppendQueryMenu(wxMenu * parentMenu)
   AppendMenuItem(parentMenu, ID_Diff, _("&Diff...\tCTRL+D"));
   AppendMenuItem(parentMenu, ID_DiffBase, _("&Diff to Base...\tCTRL+B"));
   AppendMenuItem(parentMenu, ID_DiffHead, _("&Diff to Head...\tCTRL+H"));
+  AppendMenuItem(parentMenu, ID_DiffViewer, _("&Unified Diff..."));
   parentMenu->AppendSeparator();
   AppendMenuItem(parentMenu, ID_Log, _("&Log...\tCTRL-L"),
                  EMBEDDED_BITMAP(log_png));
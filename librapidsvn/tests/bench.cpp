@@ -0,0 +1,648 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+/**
+ * @file bench.cpp
+ *
+ * Measures the controls of rapidsvn that have to cope with
+ * large working copies and long histories. They are created
+ * off-screen in a frame that is never shown.
+ *
+ * Usage: librapidsvn_bench [options]
+ *
+ *   --sizes=N,N,...   entries of the synthetic lists
+ *                     (default 1000,10000,100000,500000)
+ *   --iterations=N    runs of every benchmark
+ *   --format=json|csv json: one object per line (default)
+ *   --keep            don't remove the repository afterwards
+ *
+ * and the options of libsvncpp_bench that describe the
+ * generated repository (--dir, --files-per-dir, --dirs-per-dir,
+ * --depth, --history, --changes-per-revision, --file-size,
+ * --modified, --unversioned, --seed).
+ *
+ * The generated working copy is used to measure the refresh of
+ * the file list and the expansion of the folder browser. Lists,
+ * sorting and selection are measured for every size in --sizes
+ * as well, with status entries, log entries and annotated lines
+ * that are generated in memory: working copies with hundreds of
+ * thousands of files would take far too long to create.
+ */
+
+// ansi c lib
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// wxWidgets
+#include "wx/wx.h"
+#include "wx/fileconf.h"
+#include "wx/filename.h"
+
+// Subversion api
+#include "svn_io.h"
+#include "svn_wc.h"
+
+// svncpp
+#include "svncpp/apr.hpp"
+#include "svncpp/client.hpp"
+#include "svncpp/context.hpp"
+#include "svncpp/log_entry.hpp"
+#include "svncpp/annotate_line.hpp"
+#include "svncpp/path.hpp"
+#include "svncpp/pool.hpp"
+#include "svncpp/status.hpp"
+#include "svncpp/status_selection.hpp"
+
+// app
+#include "annotate_dlg.hpp"
+#include "filelist_ctrl.hpp"
+#include "folder_browser.hpp"
+#include "log_rev_list.hpp"
+#include "rapidsvn_app.hpp"
+#include "utils.hpp"
+
+// libsvncpp benchmarks
+#include "bench_report.hpp"
+#include "bench_repos.hpp"
+
+/** files per directory of the synthetic status entries */
+static const long SYNTHETIC_FILES_PER_DIR = 1000;
+
+/** columns the sort benchmark sorts by */
+static const int SORT_COLUMNS [] =
+{
+  FileListCtrl::COL_NAME,
+  FileListCtrl::COL_PATH,
+  FileListCtrl::COL_REV,
+  FileListCtrl::COL_TEXT_STATUS,
+  FileListCtrl::COL_CMT_DATE,
+  -1
+};
+
+/**
+ * The controls of librapidsvn ask wxGetApp() for the main
+ * frame when they show context menus. The benchmarks never
+ * do that, so there doesn't have to be a real RapidSvnApp.
+ */
+RapidSvnApp &
+wxGetApp()
+{
+  return *static_cast<RapidSvnApp *>(wxTheApp);
+}
+
+class BenchApp : public wxApp
+{
+public:
+  virtual bool OnInit()
+  {
+    return true;
+  }
+};
+
+
+/**
+ * the settings and controls of the benchmarks
+ */
+struct BenchEnv
+{
+  BenchReport & report;
+  int iterations;
+  wxFrame * frame;
+  svn::Context & context;
+
+  BenchEnv(BenchReport & report_, int iterations_, wxFrame * frame_,
+           svn::Context & context_)
+    : report(report_), iterations(iterations_), frame(frame_),
+      context(context_)
+  {
+  }
+};
+
+/**
+ * @return name of a benchmark that runs with @a count entries
+ */
+static const char *
+sizedName(const char * name, long count)
+{
+  static char buffer[64];
+  sprintf(buffer, "%s_%ld", name, count);
+  return buffer;
+}
+
+static svn::StatusEntries
+makeStatusEntries(const std::string & base, long count)
+{
+  svn::StatusEntries entries;
+  entries.reserve(count);
+
+  svn::Pool pool;
+  char name[64];
+
+  for (long i = 0; i < count; i++)
+  {
+    pool.renew();
+
+    svn_wc_entry_t * e =
+      (svn_wc_entry_t *)apr_pcalloc(pool, sizeof(svn_wc_entry_t));
+    sprintf(name, "file%06ld.txt", i);
+    e->name = name;
+    e->kind = svn_node_file;
+    e->schedule = svn_wc_schedule_normal;
+    e->revision = 1000 - (i % 1000);
+    e->cmt_rev = e->revision - (i % 7);
+    e->cmt_date = apr_time_from_sec(1000000000 + (i * 7919) % 100000000);
+    e->cmt_author = (i % 3) == 0 ? "alice" : ((i % 3) == 1 ? "bob" : "carol");
+    e->depth = svn_depth_empty;
+    e->working_size = SVN_WC_ENTRY_WORKING_SIZE_UNKNOWN;
+
+    svn_wc_status2_t * status =
+      (svn_wc_status2_t *)apr_pcalloc(pool, sizeof(svn_wc_status2_t));
+    status->entry = e;
+    status->text_status =
+      (i % 20) == 0 ? svn_wc_status_modified : svn_wc_status_normal;
+    status->prop_status = svn_wc_status_none;
+    status->repos_text_status = svn_wc_status_none;
+    status->repos_prop_status = svn_wc_status_none;
+    status->ood_last_cmt_rev = SVN_INVALID_REVNUM;
+    status->ood_kind = svn_node_none;
+
+    char path[64];
+    sprintf(path, "/dir%03ld/", i / SYNTHETIC_FILES_PER_DIR);
+    entries.push_back(svn::Status((base + path + name).c_str(), status));
+  }
+
+  return entries;
+}
+
+static svn::LogEntries
+makeLogEntries(long count)
+{
+  svn::LogEntries entries;
+  entries.reserve(count);
+
+  for (long i = count; i > 0; i--)
+  {
+    svn::LogEntry entry;
+    entry.revision = i;
+    entry.author = (i % 3) == 0 ? "alice" : "bob";
+    entry.message = "Change a few files\n\nwith a longer description";
+    entry.date = apr_time_from_sec(1000000000 + i * 600);
+    entries.push_back(entry);
+  }
+
+  return entries;
+}
+
+/**
+ * measures sorting @a list by the columns in SORT_COLUMNS
+ */
+static void
+benchSort(BenchEnv & env, FileListCtrl * list, long count)
+{
+  BenchTimer timer;
+  bool ascending = list->GetSortAscending();
+
+  for (int i = 0; i < env.iterations; i++)
+  {
+    for (const int * col = SORT_COLUMNS; *col >= 0; col++)
+    {
+      list->SetSortColumn(*col);
+
+      // toggling the order makes sure the list is really sorted
+      ascending = !ascending;
+      timer.start();
+      list->SetSortAscending(ascending);
+      timer.stop();
+    }
+  }
+
+  env.report.printResult(timer.result(sizedName("filelist_sort", count),
+                                      "entries", count));
+}
+
+/**
+ * measures retrieving the selected entries of @a list
+ * with all of them selected
+ */
+static void
+benchSelection(BenchEnv & env, FileListCtrl * list, long count)
+{
+  long items = list->GetItemCount();
+  for (long item = 0; item < items; item++)
+    list->Select(item, true);
+
+  BenchTimer timer;
+  size_t selected = 0;
+  for (int i = 0; i < env.iterations; i++)
+  {
+    timer.start();
+    selected = list->GetStatusSel().size();
+    timer.stop();
+  }
+
+  env.report.printResult(timer.result(sizedName("filelist_selection", count),
+                                      "entries", (long)selected));
+}
+
+static void
+benchLogRevList(BenchEnv & env, const svn::LogEntries & entries,
+                const char * name)
+{
+  LogRevList * list = new LogRevList(env.frame, wxID_ANY);
+
+  BenchTimer timer;
+  for (int i = 0; i < env.iterations; i++)
+  {
+    timer.start();
+    list->SetEntries(&entries);
+    timer.stop();
+  }
+
+  env.report.printResult(timer.result(name, "revisions",
+                                      list->GetItemCount()));
+  list->Destroy();
+}
+
+static void
+benchAnnotate(BenchEnv & env, const svn::AnnotatedFile & lines,
+              const char * name)
+{
+  BenchTimer timer;
+  long count = 0;
+
+  for (int i = 0; i < env.iterations; i++)
+  {
+    AnnotateDlg * dlg = new AnnotateDlg(env.frame, wxT("Annotate"));
+
+    timer.start();
+    svn::AnnotatedFile::const_iterator it;
+    for (it = lines.begin(); it != lines.end(); it++)
+    {
+      dlg->AddAnnotateLine(it->revision(),
+                           Utf8ToLocal(it->author()),
+                           Utf8ToLocal(it->line()));
+    }
+    dlg->AutoSizeColumn();
+    timer.stop();
+
+    count = (long)lines.size();
+    dlg->Destroy();
+  }
+
+  env.report.printResult(timer.result(name, "lines", count));
+}
+
+/**
+ * expands all the folders below @a id
+ *
+ * @return number of expanded folders
+ */
+static long
+expandAll(wxTreeCtrl * tree, const wxTreeItemId & id)
+{
+  long count = 1;
+  tree->Expand(id);
+
+  wxTreeItemIdValue cookie;
+  wxTreeItemId child = tree->GetFirstChild(id, cookie);
+  while (child.IsOk())
+  {
+    if (tree->ItemHasChildren(child))
+      count += expandAll(tree, child);
+    child = tree->GetNextChild(id, cookie);
+  }
+
+  return count;
+}
+
+/**
+ * the benchmarks that need a real working copy
+ */
+static void
+benchWorkingCopy(BenchEnv & env, const BenchRepository & repos)
+{
+  wxString wcPath(Utf8ToLocal(svn::Path(repos.wcPath()).native().c_str()));
+  svn::Client client(&env.context);
+
+  // file list
+  FileListCtrl * list = new FileListCtrl(env.frame, wxID_ANY);
+  list->SetContext(&env.context);
+  list->SetFlat(true);
+  list->SetWithUpdate(false);
+  list->SetShowUnversioned(true);
+  list->SetShowUnmodified(true);
+  list->SetShowModified(true);
+  list->SetShowConflicted(true);
+
+  BenchTimer refreshTimer;
+  for (int i = 0; i < env.iterations; i++)
+  {
+    refreshTimer.start();
+    list->RefreshFileList(wcPath);
+    refreshTimer.stop();
+  }
+  long count = list->GetItemCount();
+  env.report.printResult(refreshTimer.result("filelist_refresh",
+                                             "entries", count));
+
+  BenchTimer filterTimer;
+  for (int i = 0; i < env.iterations; i++)
+  {
+    list->SetShowUnmodified(false);
+    filterTimer.start();
+    list->FilterFileList(wcPath);
+    filterTimer.stop();
+
+    list->SetShowUnmodified(true);
+    filterTimer.start();
+    list->FilterFileList(wcPath);
+    filterTimer.stop();
+  }
+  env.report.printResult(filterTimer.result("filelist_filter",
+                                            "entries", count));
+
+  benchSort(env, list, count);
+  benchSelection(env, list, count);
+  list->Destroy();
+
+  // folder browser
+  FolderBrowser * browser = new FolderBrowser(env.frame, wxID_ANY);
+  browser->AddBookmark(wcPath);
+
+  BenchTimer expandTimer;
+  long folders = 0;
+  for (int i = 0; i < env.iterations; i++)
+  {
+    // collapsing removes the children, so they are
+    // listed again when they are expanded
+    wxTreeItemId root = browser->GetRootItem();
+    browser->Collapse(root);
+
+    expandTimer.start();
+    folders = expandAll(browser, root);
+    expandTimer.stop();
+  }
+  env.report.printResult(expandTimer.result("folder_expand",
+                                            "folders", folders));
+  browser->Destroy();
+
+  // log and annotate of the generated history
+  const svn::LogEntries * entries =
+    client.log(repos.url().c_str(), svn::Revision::HEAD,
+               svn::Revision::START, true, false);
+  benchLogRevList(env, *entries, "logrevlist");
+  delete entries;
+
+  svn::Path url(repos.url() + "/" + repos.busiestFile());
+  svn::AnnotatedFile * lines =
+    client.annotate(url, svn::Revision::START, svn::Revision::HEAD);
+  benchAnnotate(env, *lines, "annotate");
+  delete lines;
+}
+
+/**
+ * the benchmarks with @a count generated entries
+ */
+static void
+benchSynthetic(BenchEnv & env, const std::string & base, long count)
+{
+  wxString path(Utf8ToLocal(base.c_str()));
+
+  {
+    svn::StatusEntries entries(makeStatusEntries(base, count));
+
+    FileListCtrl * list = new FileListCtrl(env.frame, wxID_ANY);
+    list->SetContext(&env.context);
+    list->SetFlat(true);
+    list->SetShowUnversioned(true);
+    list->SetShowUnmodified(true);
+    list->SetShowModified(true);
+
+    BenchTimer timer;
+    for (int i = 0; i < env.iterations; i++)
+    {
+      timer.start();
+      list->ShowStale(path, entries);
+      timer.stop();
+    }
+    env.report.printResult(timer.result(sizedName("filelist_populate", count),
+                                        "entries", list->GetItemCount()));
+
+    benchSort(env, list, count);
+    benchSelection(env, list, count);
+    list->Destroy();
+  }
+
+  {
+    svn::LogEntries entries(makeLogEntries(count));
+    benchLogRevList(env, entries, sizedName("logrevlist", count));
+  }
+
+  {
+    svn::AnnotatedFile lines;
+    lines.reserve(count);
+    for (long i = 0; i < count; i++)
+      lines.push_back(svn::AnnotateLine(i, count - i % 100, "alice",
+                                        "2012-01-01T00:00:00.000000Z",
+                                        "  some line of the annotated file;"));
+    benchAnnotate(env, lines, sizedName("annotate", count));
+  }
+}
+
+/**
+ * @return true if @a arg is "--name=value". The value
+ *         is stored in @a value
+ */
+static bool
+option(const char * arg, const char * name, const char ** value)
+{
+  size_t len = strlen(name);
+  if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, len) != 0 ||
+      arg[len + 2] != '=')
+    return false;
+
+  *value = arg + len + 3;
+  return true;
+}
+
+static void
+removeDir(const std::string & path)
+{
+  svn::Pool pool;
+  svn_error_t * error =
+    svn_io_remove_dir2(path.c_str(), TRUE, NULL, NULL, pool);
+  if (error != 0)
+    svn_error_clear(error);
+}
+
+int
+main(int argc, char **argv)
+{
+  svn::Apr apr;
+  BenchShape shape;
+  std::vector<long> sizes;
+  int iterations = 3;
+  bool keep = false;
+  bool csv = false;
+
+  svn::Path dir(svn::Path::getTempDir());
+
+  for (int i = 1; i < argc; i++)
+  {
+    const char * value;
+    if (option(argv[i], "dir", &value))
+      dir = value;
+    else if (option(argv[i], "files-per-dir", &value))
+      shape.filesPerDir = atoi(value);
+    else if (option(argv[i], "dirs-per-dir", &value))
+      shape.dirsPerDir = atoi(value);
+    else if (option(argv[i], "depth", &value))
+      shape.depth = atoi(value);
+    else if (option(argv[i], "history", &value))
+      shape.history = atoi(value);
+    else if (option(argv[i], "changes-per-revision", &value))
+      shape.changesPerRevision = atoi(value);
+    else if (option(argv[i], "file-size", &value))
+      shape.fileSize = atoi(value);
+    else if (option(argv[i], "modified", &value))
+      shape.modifiedPercent = atoi(value);
+    else if (option(argv[i], "unversioned", &value))
+      shape.unversionedPercent = atoi(value);
+    else if (option(argv[i], "seed", &value))
+      shape.seed = strtoul(value, 0, 10);
+    else if (option(argv[i], "sizes", &value))
+    {
+      for (char * end; *value != 0; value = end)
+      {
+        long size = strtol(value, &end, 10);
+        if (size > 0)
+          sizes.push_back(size);
+        if (*end == ',')
+          end++;
+        else if (end == value)
+          break;
+      }
+    }
+    else if (option(argv[i], "iterations", &value))
+      iterations = atoi(value);
+    else if (option(argv[i], "format", &value))
+      csv = strcmp(value, "csv") == 0;
+    else if (strcmp(argv[i], "--keep") == 0)
+      keep = true;
+    else
+    {
+      fprintf(stderr, "unknown option: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  if (iterations < 1)
+    iterations = 1;
+
+  if (sizes.empty())
+  {
+    sizes.push_back(1000);
+    sizes.push_back(10000);
+    sizes.push_back(100000);
+    sizes.push_back(500000);
+  }
+
+  // work in a directory of our own, whatever is in
+  // the directory given by --dir stays untouched
+  std::string workDir;
+  try
+  {
+    workDir = createBenchDir(dir.path(), "rapidsvn_bench");
+  }
+  catch (svn::ClientException & e)
+  {
+    fprintf(stderr, "error: %s\n", e.message());
+    return 1;
+  }
+
+  wxApp::SetInstance(new BenchApp());
+  if (!wxEntryStart(argc, argv))
+  {
+    fprintf(stderr, "error: could not initialize wxWidgets\n");
+    removeDir(workDir);
+    return 1;
+  }
+  wxTheApp->CallOnInit();
+
+  // keep the settings of the controls away from the
+  // configuration of rapidsvn and the messages out of
+  // message boxes
+  wxString configFile(wxFileName::CreateTempFileName(wxT("rapidsvn_bench")));
+  delete wxConfigBase::Set(new wxFileConfig(wxEmptyString, wxEmptyString,
+                                            configFile, wxEmptyString,
+                                            wxCONFIG_USE_LOCAL_FILE));
+  delete wxLog::SetActiveTarget(new wxLogStderr());
+
+  BenchRepository repos(workDir, shape);
+
+  int result = 0;
+  wxFrame * frame = new wxFrame(NULL, wxID_ANY, wxT("librapidsvn_bench"));
+  try
+  {
+    svn::Context context;
+    BenchReport report(csv);
+
+    apr_time_t start = apr_time_now();
+    repos.create(&context);
+    report.printSetup(shape, repos, (apr_time_now() - start) / 1000.0);
+
+    BenchEnv env(report, iterations, frame, context);
+    benchWorkingCopy(env, repos);
+
+    std::vector<long>::const_iterator it;
+    for (it = sizes.begin(); it != sizes.end(); it++)
+      benchSynthetic(env, repos.wcPath(), *it);
+  }
+  catch (svn::ClientException & e)
+  {
+    fprintf(stderr, "error: %s\n", e.message());
+    result = 1;
+  }
+
+  frame->Destroy();
+  wxTheApp->OnExit();
+
+  if (keep)
+    fprintf(stderr, "repository kept in %s\n", workDir.c_str());
+  else
+    removeDir(workDir);
+
+  delete wxConfigBase::Set(NULL);
+  ::wxRemoveFile(configFile);
+  wxEntryCleanup();
+
+  return result;
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
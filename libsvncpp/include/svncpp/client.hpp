@@ -54,6 +54,7 @@ namespace svn
   class Context;
   class DirEntry;
   class Info;
+  class OutputSink;
   class Status;
   class Targets;
 
@@ -62,6 +63,7 @@ namespace svn
   typedef std::vector<Info> InfoVector;
   typedef std::vector<LogEntry> LogEntries;
   typedef std::vector<Status> StatusEntries;
+  typedef std::vector<const Status *> StatusPointers;
 
 
   // map of property names to values
@@ -90,7 +92,7 @@ namespace svn
     StatusFilter()
       : showUnversioned(false), showUnmodified(false),
         showModified(false), showConflicted(false),
-        showExternals(false)
+        showIgnored(false), showExternals(false)
     {
     }
   };
@@ -215,6 +217,43 @@ namespace svn
            const bool update,
            StatusEntries & entries) throw(ClientException);
 
+    /**
+     * Applies @a filter to local status @a entries that were
+     * retrieved with at least everything @a filter shows
+     * (usually unversioned, unmodified and modified, plus
+     * ignored and externals if needed). The result is the same
+     * as calling @ref status with @a filter, without crawling
+     * the working copy again.
+     *
+     * The matching entries aren't copied, @a entries points
+     * into @a all and is valid as long as @a all is unchanged.
+     *
+     * @param filter filter to apply
+     * @param all status entries to filter
+     * @param entries vector receiving the matching entries
+     */
+    static void
+    filterStatus(const StatusFilter & filter,
+                 const StatusEntries & all,
+                 StatusPointers & entries);
+
+    /**
+     * Lists the entries of the repository @a url as status
+     * entries, like @ref status does for urls. Only the
+     * dirent fields in @a direntFields are retrieved.
+     *
+     * @param url repository url
+     * @param descend Recurse into subdirectories
+     * @param direntFields combination of the SVN_DIRENT_* flags
+     * @param fetchLocks whether to retrieve the locks as well
+     * @return status entries with full urls
+     */
+    StatusEntries
+    listStatus(const char * url,
+               const bool descend,
+               apr_uint32_t direntFields,
+               bool fetchLocks) throw(ClientException);
+
 
     /**
      * Executes a revision checkout.
@@ -297,6 +336,20 @@ namespace svn
     void
     add(const Path & path, bool recurse) throw(ClientException);
 
+    /**
+     * Adds many files at once. Every parent directory is
+     * locked only once for all the targets in it, which is
+     * a lot faster than calling add for each of them.
+     *
+     * @param targets paths to add
+     * @param recurse add the contents of directories as
+     *                well (except ignored files). Targets
+     *                below another target are skipped then
+     * @exception ClientException
+     */
+    void
+    add(const Targets & targets, bool recurse) throw(ClientException);
+
     /**
      * Updates the file or directory.
      * @param targets target files.
@@ -336,6 +389,27 @@ namespace svn
         const Revision & revision,
         const Revision & peg_revision = Revision::UNSPECIFIED) throw(ClientException);
 
+    /**
+     * Streams the contents for a specific @a revision of
+     * a @a path to @a sink chunk by chunk, so even huge
+     * files need only little memory.
+     *
+     * @param sink receives the contents
+     * @param path path of file
+     * @param revision revision to retrieve
+     * @param peg_revision peg revision to retrieve,
+     *        by default is the latest one
+     * @param maxBytes stop after this many bytes (e.g. for
+     *        previews). 0 means no limit
+     * @return number of bytes written to @a sink
+     */
+    size_t
+    cat(OutputSink & sink,
+        const Path & path,
+        const Revision & revision,
+        const Revision & peg_revision = Revision::UNSPECIFIED,
+        size_t maxBytes = 0) throw(ClientException);
+
 
     /**
      * Retrieves the contents for a specific @a revision of
@@ -404,6 +478,21 @@ namespace svn
          const Revision & srcRevision,
          const Path & destPath) throw(ClientException);
 
+    /**
+     * Copies several files or directories into the directory
+     * @a destPath. If it is an url, this is done with a
+     * single commit.
+     *
+     * @param srcPaths files/directories to copy
+     * @param srcRevision revision of the sources
+     * @param destPath destination directory
+     * @exception ClientException
+     */
+    void
+    copy(const Targets & srcPaths,
+         const Revision & srcRevision,
+         const Path & destPath) throw(ClientException);
+
     /**
      * Moves or renames a file.
      * @exception ClientException
@@ -414,6 +503,21 @@ namespace svn
          const Path & destPath,
          bool force) throw(ClientException);
 
+    /**
+     * Moves several files or directories into the directory
+     * @a destPath. If it is an url, this is done with a
+     * single commit.
+     *
+     * @param srcPaths files/directories to move
+     * @param destPath destination directory
+     * @param force
+     * @exception ClientException
+     */
+    void
+    move(const Targets & srcPaths,
+         const Path & destPath,
+         bool force) throw(ClientException);
+
     /**
      * Creates a directory directly in a repository or creates a
      * directory on disk and schedules it for addition. If <i>path</i>
@@ -444,6 +548,17 @@ namespace svn
     void
     resolved(const Path & path, bool recurse) throw(ClientException);
 
+    /**
+     * Removes the 'conflicted' state on several files. Each
+     * working copy directory is locked only once.
+     *
+     * @param targets files/directories to resolve
+     * @param recurse whether directories are resolved recursively
+     * @exception ClientException
+     */
+    void
+    resolved(const Targets & targets, bool recurse) throw(ClientException);
+
     /**
      * Export into file or directory TO_PATH from local or remote FROM_PATH
      * @param from_path path to import
@@ -497,6 +612,24 @@ namespace svn
            const char * message,
            bool recurse) throw(ClientException);
 
+    /**
+     * Imports several files or directories into the
+     * repository directory @a url with a single commit.
+     * Every item gets its own notification.
+     *
+     * @param targets local files/directories to import
+     * @param url existing directory in the repository
+     * @param message log message
+     * @param recurse import the contents of directories
+     *                as well (except ignored files)
+     * @exception ClientException
+     */
+    void
+    import(const Targets & targets,
+           const Path & url,
+           const char * message,
+           bool recurse) throw(ClientException);
+
 
     /**
      * Merge changes from two paths into a new local path.
@@ -529,6 +662,19 @@ namespace svn
          const Revision & revision = Revision::UNSPECIFIED,
          const Revision & pegRevision = Revision::UNSPECIFIED) throw(ClientException);
 
+    /**
+     * retrieve the url, repository root and uuid of
+     * @a pathOrUrl. The information remembered by the context
+     * from earlier status and info calls is used if possible,
+     * info is only called if the path hasn't been seen yet.
+     *
+     * @see Context::findRepositoryInfo
+     *
+     * @param pathOrUrl
+     */
+    RepositoryInfo
+    repositoryInfo(const Path & pathOrUrl) throw(ClientException);
+
 
     /**
      * Retrieve log information for the given path
@@ -639,6 +785,54 @@ namespace svn
          const bool ignoreAncestry, const bool noDiffDeleted)
     throw(ClientException);
 
+    /**
+     * Streams the diff output which describes the delta between
+     * @a path/@a revision1 and @a path/@a revision2 to @a sink
+     * chunk by chunk, without holding the whole diff in memory.
+     *
+     * @see diff(const Path &, const Path &, const Revision &,
+     *           const Revision &, const bool, const bool, const bool)
+     *
+     * @param sink receives the diff output
+     * @exception ClientException
+     */
+    void
+    diff(OutputSink & sink,
+         const Path & tmpPath, const Path & path,
+         const Revision & revision1, const Revision & revision2,
+         const bool recurse, const bool ignoreAncestry,
+         const bool noDiffDeleted) throw(ClientException);
+
+    /**
+     * Streams the diff output which describes the delta between
+     * @a path1/@a revision1 and @a path2/@a revision2 to @a sink
+     *
+     * @param sink receives the diff output
+     * @exception ClientException
+     */
+    void
+    diff(OutputSink & sink,
+         const Path & tmpPath, const Path & path1, const Path & path2,
+         const Revision & revision1, const Revision & revision2,
+         const bool recurse, const bool ignoreAncestry,
+         const bool noDiffDeleted) throw(ClientException);
+
+    /**
+     * Streams the diff output which describes the delta of
+     * @a path/@a pegRevision between @a revision1 and @a revision2
+     * to @a sink
+     *
+     * @param sink receives the diff output
+     * @exception ClientException
+     */
+    void
+    diff(OutputSink & sink,
+         const Path & tmpPath, const Path & path,
+         const Revision & pegRevision, const Revision & revision1,
+         const Revision & revision2, const bool recurse,
+         const bool ignoreAncestry, const bool noDiffDeleted)
+    throw(ClientException);
+
     /**
      * lists entries in @a pathOrUrl no matter whether local or
      * repository
@@ -654,6 +848,27 @@ namespace svn
          svn_opt_revision_t * revision,
          bool recurse) throw(ClientException);
 
+    /**
+     * lists entries in @a pathOrUrl like above, but transfers
+     * only the information that is really needed. Fields
+     * that are not requested are left empty.
+     *
+     * @param pathOrUrl
+     * @param revision
+     * @param recurse
+     * @param direntFields combination of the SVN_DIRENT_* flags,
+     *        e.g. SVN_DIRENT_KIND for a tree of directories
+     * @param fetchLocks whether to retrieve the locks as well
+     * @return a vector of directory entries, each with
+     *         a relative path (only filename)
+     */
+    DirEntries
+    list(const char * pathOrUrl,
+         svn_opt_revision_t * revision,
+         bool recurse,
+         apr_uint32_t direntFields,
+         bool fetchLocks) throw(ClientException);
+
     /**
      * lists properties in @a path no matter whether local or
      * repository
@@ -26,12 +26,14 @@
 #define _SVNCPP_CONTEXT_HPP_
 
 // stl
+#include "svncpp/map_wrapper.hpp"
 #include "svncpp/string_wrapper.hpp"
 
 // Subversion api
 #include "svn_client.h"
 
 // svncpp
+#include "svncpp/exception.hpp"
 #include "svncpp/pool.hpp"
 
 
@@ -40,6 +42,42 @@ namespace svn
   // forward declarations
   class ContextListener;
 
+  /**
+   * Repository related information about a working copy
+   * path or url as remembered by the context
+   */
+  struct RepositoryInfo
+  {
+    /** url of the path (empty if not known) */
+    std::string url;
+
+    /** repository root url */
+    std::string root;
+
+    /** repository uuid (empty if not known) */
+    std::string uuid;
+  };
+
+  /**
+   * What happened in a context, see Context::getStatistics
+   */
+  struct ContextStatistics
+  {
+    /** number of calls per svn::Client method */
+    std::map<std::string, size_t> calls;
+
+    /** bytes sent and received by the repository access layer */
+    apr_off_t bytesTransferred;
+
+    /** number of notifications passed to the listener */
+    size_t notifications;
+
+    ContextStatistics()
+      : bytesTransferred(0), notifications(0)
+    {
+    }
+  };
+
   /**
    * This class will hold the client context
    * and replace the old notification and baton
@@ -93,10 +131,34 @@ namespace svn
 
     /**
      * this will be called at the beginning of an action.
-     * the log message will be reset.
+     * the log message will be reset. If credentials were
+     * entered since the last call, the pooled ra sessions
+     * are closed.
      */
     void reset();
 
+    /**
+     * counts a call of the svn::Client method @a name.
+     * This is done by svn::Client itself.
+     *
+     * @param name name of the method
+     */
+    void
+    countCall(const char * name);
+
+    /**
+     * @return the statistics collected since the last
+     *         call of resetStatistics
+     */
+    ContextStatistics
+    getStatistics() const;
+
+    /**
+     * start collecting statistics from scratch
+     */
+    void
+    resetStatistics();
+
     /**
      * set log message
      *
@@ -146,6 +208,97 @@ namespace svn
     ContextListener *
     getListener() const;
 
+    /**
+     * remember the repository information of @a pathOrUrl.
+     * This is done by the client whenever status or info
+     * is retrieved, so later lookups of the repository root
+     * don't need another roundtrip.
+     *
+     * @param pathOrUrl working copy path or url
+     * @param info repository information. An empty root
+     *             marks @a pathOrUrl as not belonging to the
+     *             repository of its parent (externals)
+     * @param childrenKnown true if every child of @a pathOrUrl
+     *                      with an url differing from its
+     *                      parent (switched items, externals)
+     *                      has been remembered as well
+     */
+    void
+    cacheRepositoryInfo(const char * pathOrUrl,
+                        const RepositoryInfo & info,
+                        bool childrenKnown = false);
+
+    /**
+     * lookup the repository information of @a pathOrUrl.
+     * If the path itself is not known, urls are matched against
+     * the known repository roots and working copy paths against
+     * their parent directory. In these cases only fields that
+     * can be derived safely are filled in.
+     *
+     * @param pathOrUrl working copy path or url
+     * @param info receives the repository information
+     * @retval true the repository root is known
+     */
+    bool
+    findRepositoryInfo(const char * pathOrUrl,
+                       RepositoryInfo & info) const;
+
+    /**
+     * forget all the remembered repository information.
+     * This has to be called after operations that change the
+     * url of working copy paths, like switch or relocate.
+     */
+    void
+    clearRepositoryInfo();
+
+    /**
+     * get a ra session for @a url. Sessions are kept open per
+     * repository root and reused, so the connection and
+     * authentication setup is done only once. The session
+     * is reserved for the caller until it is given back
+     * with releaseSession. Changing the login or the
+     * authentication cache closes the pooled sessions.
+     *
+     * @param url
+     * @return session parented at @a url
+     * @exception ClientException
+     */
+    svn_ra_session_t *
+    acquireSession(const char * url) throw(ClientException);
+
+    /**
+     * give back a session retrieved by acquireSession
+     *
+     * @param session
+     * @param reuse false if the session is in an unknown
+     *              state (after an error) and has to be closed
+     */
+    void
+    releaseSession(svn_ra_session_t * session, bool reuse = true);
+
+    /**
+     * set the limits of the session pool
+     *
+     * @param maxSessions number of idle sessions to keep
+     * @param idleSeconds idle sessions older than this are closed
+     */
+    void
+    setSessionPoolLimits(size_t maxSessions, int idleSeconds);
+
+    /**
+     * @return number of acquireSession calls that could reuse
+     *         an open session
+     */
+    size_t
+    getSessionPoolHits() const;
+
+    /**
+     * @return number of acquireSession calls that had to open
+     *         a new session
+     */
+    size_t
+    getSessionPoolMisses() const;
+
   private:
     struct Data;
     Data * m;
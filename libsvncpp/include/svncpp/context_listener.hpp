@@ -208,6 +208,23 @@ public:
                                  const std::string & realm,
                                  bool & maySave) = 0;
 
+    /**
+     * this method is called whenever data is sent to or
+     * received from the repository. It is called from the
+     * thread of the operation and very often, so it should
+     * return quickly.
+     *
+     * @param transferred bytes transferred since the
+     *                    statistics of the context were reset
+     * @param remaining bytes the current request still has
+     *                  to transfer, -1 if unknown
+     */
+    virtual void
+    contextProgress(apr_off_t /*transferred*/,
+                    apr_off_t /*remaining*/)
+    {
+    }
+
     virtual ~ContextListener() { }
   };
 }
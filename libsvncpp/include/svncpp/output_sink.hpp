@@ -0,0 +1,92 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _SVNCPP_OUTPUT_SINK_HPP_
+#define _SVNCPP_OUTPUT_SINK_HPP_
+
+// stl
+#include <cstddef>
+#include "svncpp/string_wrapper.hpp"
+
+
+namespace svn
+{
+  /**
+   * Receiver for data that is produced chunk by chunk,
+   * like the output of a diff. Inherit from this class
+   * if you want to process large outputs without holding
+   * them in memory as a whole.
+   *
+   * @see Client::diff
+   */
+  class OutputSink
+  {
+  public:
+    virtual ~OutputSink()
+    {
+    }
+
+    /**
+     * called for every chunk of data
+     *
+     * @param data pointer to the chunk. The data is only
+     *             valid during this call
+     * @param len length of the chunk in bytes
+     * @retval true continue
+     * @retval false no more data wanted
+     */
+    virtual bool
+    write(const char * data, size_t len) = 0;
+  };
+
+
+  /**
+   * Sink that collects all of the data in a string
+   */
+  class StringOutputSink : public OutputSink
+  {
+  public:
+    StringOutputSink(std::string & str)
+        : m_str(str)
+    {
+    }
+
+    virtual bool
+    write(const char * data, size_t len)
+    {
+      m_str.append(data, len);
+      return true;
+    }
+
+  private:
+    std::string & m_str;
+  };
+}
+
+#endif
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
@@ -39,7 +39,9 @@ namespace svn
     /**
      * creates a subpool new pool to an existing pool
      *
-     * @param parent NULL -> global pool
+     * @param parent NULL -> top level pool. These come from
+     *               an allocator of the calling thread and are
+     *               recycled instead of destroyed
      */
     Pool(apr_pool_t * parent = (apr_pool_t *)0);
 
@@ -64,6 +66,37 @@ namespace svn
      */
     void renew();
 
+    /**
+     * releases the top level pools of the calling thread.
+     * Threads call this before they end, APR doesn't
+     * clean up thread data on every platform. Pools of the
+     * thread that are still in use stay valid.
+     */
+    static void
+    threadExit();
+
+    /**
+     * @return number of apr pools that had to be created
+     *         since the start of the program
+     */
+    static size_t
+    createdCount();
+
+    /**
+     * @return number of top level pools that were taken
+     *         from the free pools of a thread instead of
+     *         being created
+     */
+    static size_t
+    reusedCount();
+
+    /**
+     * @return the peak resident memory of the process in
+     *         kilobytes, 0 if it cannot be determined
+     */
+    static long
+    peakMemoryKb();
+
   private:
     apr_pool_t * m_parent;
     apr_pool_t * m_pool;
@@ -0,0 +1,128 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _SVNCPP_TRACE_HPP_
+#define _SVNCPP_TRACE_HPP_
+
+// stl
+#include "svncpp/string_wrapper.hpp"
+
+// Apache Portable Runtime
+#include "apr_time.h"
+
+namespace svn
+{
+  /**
+   * Collects spans of time (svn calls, phases of an
+   * action...) from all the threads and writes them in
+   * the trace event format of Chrome, so they can be
+   * viewed with chrome://tracing.
+   *
+   * Tracing is off unless @a start is called. While it is
+   * off a @a TraceSpan costs next to nothing.
+   */
+  class Trace
+  {
+  public:
+    /**
+     * discards the spans collected so far
+     * and starts collecting
+     */
+    static void
+    start();
+
+    /**
+     * stops collecting. The collected spans are
+     * kept until the next @a start
+     */
+    static void
+    stop();
+
+    /**
+     * @return is tracing on?
+     */
+    static bool
+    isEnabled();
+
+    /**
+     * adds a span. Used by @a TraceSpan.
+     *
+     * @param category category of the span, e.g. "svn"
+     * @param name name of the span
+     * @param start start of the span
+     * @param end end of the span
+     */
+    static void
+    add(const char * category, const std::string & name,
+        apr_time_t start, apr_time_t end);
+
+    /**
+     * @return number of collected spans
+     */
+    static size_t
+    count();
+
+    /**
+     * @return the collected spans as Chrome trace event JSON
+     */
+    static std::string
+    toJson();
+  };
+
+  /**
+   * Adds a span to the @a Trace for the lifetime of the
+   * object, e.g. for the scope of a function.
+   */
+  class TraceSpan
+  {
+  public:
+    /**
+     * @param category a string literal, e.g. "svn"
+     * @param name name of the span
+     */
+    TraceSpan(const char * category, const char * name);
+
+    TraceSpan(const char * category, const std::string & name);
+
+    ~TraceSpan();
+
+  private:
+    const char * m_category;
+    std::string m_name;
+    apr_time_t m_start;
+
+    TraceSpan(const TraceSpan &);
+
+    TraceSpan & operator = (const TraceSpan &);
+  };
+}
+
+#endif
+
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
@@ -25,6 +25,9 @@
 #ifndef _SVNCPP_WC_HPP_
 #define _SVNCPP_WC_HPP_
 
+// stl
+#include "svncpp/string_wrapper.hpp"
+
 // svncpp
 #include "svncpp/revision.hpp"
 
@@ -82,6 +85,47 @@ namespace svn
     static bool
     isAdmDir(const char * name);
 
+    /**
+     * retrieve the checksum of the pristine text-base of
+     * the versioned file @a path.
+     *
+     * @param path versioned file in a working copy
+     * @return checksum or empty string if there is no text-base
+     *         (e.g. files scheduled for addition)
+     */
+    static std::string
+    getPristineChecksum(const Path & path);
+
+    /**
+     * retrieve everything besides the text-base that goes into
+     * the working copy form of @a path: the values of svn:eol-style,
+     * svn:special and svn:keywords and, if keywords are set,
+     * the last commit and url of the entry.
+     *
+     * @param path versioned file in a working copy
+     * @return string that changes whenever the translation changes
+     */
+    static std::string
+    getTranslationKey(const Path & path);
+
+    /**
+     * retrieve the BASE revision of the versioned file @a path
+     * straight from the administrative area, without contacting
+     * the repository.
+     *
+     * If the file doesn't need keyword or eol translation,
+     * @a dstPath will be set to the (read-only) text-base itself
+     * and nothing is copied. Otherwise a translated copy
+     * is written to the temporary directory.
+     *
+     * @param dstPath path of the text-base or the translated copy
+     * @param path versioned file in a working copy
+     * @return true if @a dstPath is a new temporary file that has
+     *         to be removed by the caller
+     */
+    static bool
+    getPristineFile(Path & dstPath, const Path & path);
+
   private:
   };
 }
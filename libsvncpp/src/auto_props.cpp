@@ -0,0 +1,198 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// ansi c lib
+#include <cstring>
+
+// Apache Portable Runtime
+#include "apr_fnmatch.h"
+#include "apr_lib.h"
+#include "apr_strings.h"
+
+// subversion api
+#include "svn_config.h"
+#include "svn_io.h"
+#include "svn_path.h"
+#include "svn_props.h"
+
+// svncpp
+#include "auto_props.hpp"
+
+namespace svn
+{
+  /**
+   * the properties of a new file, collected while
+   * enumerating the auto-props of the configuration
+   */
+  struct AutoProps
+  {
+    const char * filename;
+    apr_hash_t * properties;
+    const char * mimetype;
+    bool haveExecutable;
+    apr_pool_t * pool;
+  };
+
+  /**
+   * strip leading and trailing whitespace from @a str
+   * (modified in place)
+   */
+  static char *
+  trim(char * str)
+  {
+    while (apr_isspace(*str))
+      str++;
+
+    char * end = str + strlen(str);
+    while ((end > str) && apr_isspace(end[-1]))
+      end--;
+    *end = 0;
+
+    return str;
+  }
+
+  /**
+   * called for every entry of the auto-props section:
+   * @a name is a file pattern, @a value a list of
+   * "property=value" separated by semicolons
+   */
+  static svn_boolean_t
+  autoPropsEnumerator(const char * name, const char * value,
+                      void * baton, apr_pool_t *)
+  {
+    AutoProps * autoProps = static_cast<AutoProps *>(baton);
+
+    if (*value == 0)
+      return TRUE;
+
+    if (apr_fnmatch(name, autoProps->filename,
+                    APR_FNM_CASE_BLIND) == APR_FNM_NOMATCH)
+      return TRUE;
+
+    char * last;
+    char * property =
+      apr_strtok(apr_pstrdup(autoProps->pool, value), ";", &last);
+
+    for (; property != NULL; property = apr_strtok(NULL, ";", &last))
+    {
+      const char * propValue = "";
+      char * equalSign = strchr(property, '=');
+      if (equalSign != NULL)
+      {
+        *equalSign = 0;
+        propValue = trim(equalSign + 1);
+      }
+
+      property = trim(property);
+      if (*property == 0)
+        continue;
+
+      apr_hash_set(autoProps->properties, property, APR_HASH_KEY_STRING,
+                   svn_string_create(propValue, autoProps->pool));
+
+      if (0 == strcmp(property, SVN_PROP_MIME_TYPE))
+        autoProps->mimetype = propValue;
+      else if (0 == strcmp(property, SVN_PROP_EXECUTABLE))
+        autoProps->haveExecutable = true;
+    }
+
+    return TRUE;
+  }
+
+  svn_error_t *
+  getAutoProps(apr_hash_t ** properties,
+               const char ** mimetype,
+               bool * special,
+               const char * path,
+               svn_client_ctx_t * ctx,
+               apr_pool_t * pool)
+  {
+    svn_node_kind_t kind;
+    svn_boolean_t isSpecial;
+    SVN_ERR(svn_io_check_special_path(path, &kind, &isSpecial, pool));
+
+    *special = isSpecial != 0;
+    if (*special)
+    {
+      *properties = apr_hash_make(pool);
+      apr_hash_set(*properties, SVN_PROP_SPECIAL, APR_HASH_KEY_STRING,
+                   svn_string_create(SVN_PROP_SPECIAL_VALUE, pool));
+      *mimetype = NULL;
+      return SVN_NO_ERROR;
+    }
+
+    AutoProps autoProps;
+    autoProps.filename = svn_path_basename(path, pool);
+    autoProps.properties = apr_hash_make(pool);
+    autoProps.mimetype = NULL;
+    autoProps.haveExecutable = false;
+    autoProps.pool = pool;
+
+    svn_config_t * cfg = NULL;
+    if (ctx->config != NULL)
+      cfg = static_cast<svn_config_t *>(
+              apr_hash_get(ctx->config, SVN_CONFIG_CATEGORY_CONFIG,
+                           APR_HASH_KEY_STRING));
+
+    svn_boolean_t useAutoProps = FALSE;
+    SVN_ERR(svn_config_get_bool(cfg, &useAutoProps,
+                                SVN_CONFIG_SECTION_MISCELLANY,
+                                SVN_CONFIG_OPTION_ENABLE_AUTO_PROPS,
+                                FALSE));
+
+    if (useAutoProps && (cfg != NULL))
+      svn_config_enumerate2(cfg, SVN_CONFIG_SECTION_AUTO_PROPS,
+                            autoPropsEnumerator, &autoProps, pool);
+
+    if (autoProps.mimetype == NULL)
+    {
+      SVN_ERR(svn_io_detect_mimetype2(&autoProps.mimetype, path,
+                                      ctx->mimetypes_map, pool));
+      if (autoProps.mimetype != NULL)
+        apr_hash_set(autoProps.properties, SVN_PROP_MIME_TYPE,
+                     APR_HASH_KEY_STRING,
+                     svn_string_create(autoProps.mimetype, pool));
+    }
+
+    if (!autoProps.haveExecutable)
+    {
+      svn_boolean_t executable = FALSE;
+      SVN_ERR(svn_io_is_file_executable(&executable, path, pool));
+      if (executable)
+        apr_hash_set(autoProps.properties, SVN_PROP_EXECUTABLE,
+                     APR_HASH_KEY_STRING,
+                     svn_string_create(SVN_PROP_EXECUTABLE_VALUE, pool));
+    }
+
+    *properties = autoProps.properties;
+    *mimetype = autoProps.mimetype;
+    return SVN_NO_ERROR;
+  }
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
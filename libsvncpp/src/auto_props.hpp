@@ -0,0 +1,66 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _SVNCPP_AUTO_PROPS_HPP_
+#define _SVNCPP_AUTO_PROPS_HPP_
+
+// Apache Portable Runtime
+#include "apr_hash.h"
+
+// subversion api
+#include "svn_client.h"
+
+namespace svn
+{
+  /**
+   * find the properties svn_client_add and svn_client_import
+   * give the new file @a path. A special file (a symlink) gets
+   * svn:special only. Other files get the matching auto-props
+   * of the configuration (if they are enabled), the detected
+   * svn:mime-type and svn:executable.
+   *
+   * @param properties property name (const char *) to value
+   *                   (svn_string_t *), allocated in @a pool
+   * @param mimetype the svn:mime-type, NULL if there is none
+   * @param special is @a path a special file?
+   * @param path the file on disk
+   * @param ctx the configuration and mime-types map are used
+   * @param pool
+   */
+  svn_error_t *
+  getAutoProps(apr_hash_t ** properties,
+               const char ** mimetype,
+               bool * special,
+               const char * path,
+               svn_client_ctx_t * ctx,
+               apr_pool_t * pool);
+}
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
@@ -26,6 +26,7 @@
 
 // svncpp
 #include "svncpp/client.hpp"
+#include "client_call.hpp"
 
 
 namespace svn
@@ -54,6 +55,8 @@ namespace svn
                    const Revision & revisionStart,
                    const Revision & revisionEnd) throw(ClientException)
   {
+    ClientCall call(m_context, "annotate");
+
     Pool pool;
     AnnotatedFile * entries = new AnnotatedFile;
     svn_error_t *error;
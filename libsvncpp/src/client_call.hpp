@@ -0,0 +1,64 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _SVNCPP_CLIENT_CALL_HPP_
+#define _SVNCPP_CLIENT_CALL_HPP_
+
+// svncpp
+#include "svncpp/context.hpp"
+#include "svncpp/trace.hpp"
+
+namespace svn
+{
+  /**
+   * Put one of these at the beginning of every svn::Client
+   * method, so the call shows up in the statistics of the
+   * context and, for the duration of the method, in the
+   * trace.
+   *
+   * @see Context::getStatistics
+   * @see Trace
+   */
+  class ClientCall
+  {
+  public:
+    ClientCall(Context * context, const char * name)
+      : m_span("svn", name)
+    {
+      if (context != 0)
+        context->countCall(name);
+    }
+
+  private:
+    TraceSpan m_span;
+  };
+}
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
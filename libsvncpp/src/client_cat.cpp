@@ -30,20 +30,73 @@
 // svncpp
 #include "svncpp/client.hpp"
 #include "svncpp/exception.hpp"
+#include "svncpp/output_sink.hpp"
 #include "svncpp/pool.hpp"
 #include "svncpp/status.hpp"
+#include "client_call.hpp"
 
 namespace svn
 {
-  std::string
-  Client::cat(const Path & path,
+  /**
+   * baton for the stream that passes the output
+   * of svn_client_cat2 on to an @a OutputSink
+   */
+  struct CatBaton
+  {
+    OutputSink * sink;
+    size_t maxBytes;
+    size_t written;
+    bool stopped;
+
+    CatBaton(OutputSink * sink_, size_t maxBytes_)
+        : sink(sink_), maxBytes(maxBytes_), written(0), stopped(false)
+    {
+    }
+  };
+
+  static svn_error_t *
+  catWrite(void * baton, const char * data, apr_size_t * len)
+  {
+    CatBaton * catBaton = static_cast<CatBaton *>(baton);
+    size_t count = *len;
+
+    if ((catBaton->maxBytes > 0) &&
+        (catBaton->written + count > catBaton->maxBytes))
+    {
+      count = catBaton->maxBytes - catBaton->written;
+      catBaton->stopped = true;
+    }
+
+    if (count > 0)
+    {
+      if (!catBaton->sink->write(data, count))
+        catBaton->stopped = true;
+
+      catBaton->written += count;
+    }
+
+    // stop the transfer
+    if (catBaton->stopped)
+      return svn_error_create(SVN_ERR_CANCELLED, NULL,
+                              "no more data wanted");
+
+    return SVN_NO_ERROR;
+  }
+
+  size_t
+  Client::cat(OutputSink & sink,
+              const Path & path,
               const Revision & revision,
-              const Revision & peg_revision) throw(ClientException)
+              const Revision & peg_revision,
+              size_t maxBytes) throw(ClientException)
   {
+    ClientCall call(m_context, "cat");
+
     Pool pool;
 
-    svn_stringbuf_t * stringbuf = svn_stringbuf_create("", pool);
-    svn_stream_t * stream = svn_stream_from_stringbuf(stringbuf, pool);
+    CatBaton baton(&sink, maxBytes);
+    svn_stream_t * stream = svn_stream_create(&baton, pool);
+    svn_stream_set_write(stream, catWrite);
 
     svn_error_t * error;
     error = svn_client_cat2(stream,
@@ -54,9 +107,28 @@ namespace svn
                             pool);
 
     if (error != 0)
-      throw ClientException(error);
+    {
+      // we stopped the transfer ourselves
+      if (baton.stopped)
+        svn_error_clear(error);
+      else
+        throw ClientException(error);
+    }
+
+    return baton.written;
+  }
+
+  std::string
+  Client::cat(const Path & path,
+              const Revision & revision,
+              const Revision & peg_revision) throw(ClientException)
+  {
+    std::string result;
+    StringOutputSink sink(result);
+
+    cat(sink, path, revision, peg_revision);
 
-    return std::string(stringbuf->data, stringbuf->len);
+    return result;
   }
 
   /**
@@ -129,12 +201,43 @@ namespace svn
     return file;
   }
 
+  /**
+   * Sink that writes to an open apr file
+   */
+  class AprFileOutputSink : public OutputSink
+  {
+  public:
+    AprFileOutputSink(apr_file_t * file)
+        : m_file(file), m_status(APR_SUCCESS)
+    {
+    }
+
+    virtual bool
+    write(const char * data, size_t len)
+    {
+      m_status = apr_file_write_full(m_file, data, len, NULL);
+      return m_status == APR_SUCCESS;
+    }
+
+    apr_status_t
+    status() const
+    {
+      return m_status;
+    }
+
+  private:
+    apr_file_t * m_file;
+    apr_status_t m_status;
+  };
+
   void
   Client::get(Path & dstPath,
               const Path & path,
               const Revision & revision,
               const Revision & peg_revision) throw(ClientException)
   {
+    ClientCall call(m_context, "get");
+
     Pool pool;
 
     // create a new file and suppose we only want
@@ -142,27 +245,23 @@ namespace svn
 
     apr_file_t * file = openTempFile(dstPath, path, revision, pool);
 
-    // now create a stream and let svn_client_cat write to the
-    // stream
-    svn_stream_t * stream = svn_stream_from_aprfile(file, pool);
-    if (stream != 0)
+    // now stream the contents chunk by chunk into the file
+    AprFileOutputSink sink(file);
+    try
     {
-      svn_error_t * error = svn_client_cat2(
-                              stream,
-                              path.c_str(),
-                              peg_revision.revision() ,
-                              revision.revision(),
-                              *m_context,
-                              pool);
-
-      if (error != 0)
-        throw ClientException(error);
-
-      svn_stream_close(stream);
+      cat(sink, path, revision, peg_revision);
+    }
+    catch (...)
+    {
+      apr_file_close(file);
+      throw;
     }
 
     // finalize stuff
     apr_file_close(file);
+
+    if (sink.status() != APR_SUCCESS)
+      throw ClientException(sink.status());
   }
 }
 
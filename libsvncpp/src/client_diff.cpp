@@ -21,18 +21,28 @@
  * history and logs, available at http://rapidsvn.tigris.org/.
  * ====================================================================
  */
+// Apache Portable Runtime
+#include "apr_thread_proc.h"
+
 // Subversion api
 #include "svn_client.h"
 
 // svncpp
 #include "svncpp/client.hpp"
 #include "svncpp/exception.hpp"
+#include "svncpp/output_sink.hpp"
 #include "svncpp/pool.hpp"
 #include "svncpp/status.hpp"
+#include "client_call.hpp"
 
 
 namespace svn
 {
+  /**
+   * size of the chunks that are passed to the @a OutputSink
+   */
+  static const apr_size_t DIFF_CHUNK_SIZE = 64 * 1024;
+
   /**
    * a quick way to create error messages
    */
@@ -72,111 +82,193 @@ namespace svn
       svn_error_clear(svn_io_remove_file(errfileName, pool));
   }
 
-  std::string
-  Client::diff(const Path & tmpPath, const Path & path,
-               const Revision & revision1, const Revision & revision2,
-               const bool recurse, const bool ignoreAncestry,
-               const bool noDiffDeleted) throw(ClientException)
+  /**
+   * parameters for one of the svn_client_diff
+   * variants
+   */
+  struct DiffParams
   {
-    Pool pool;
-    svn_error_t * error;
-    apr_status_t status;
-    apr_file_t * outfile = NULL;
-    const char * outfileName = NULL;
-    apr_file_t * errfile = NULL;
-    const char * errfileName = NULL;
-    apr_array_header_t * options;
-    svn_stringbuf_t * stringbuf;
+    const Path * path1;
+    const Path * path2;
+    const Revision * pegRevision;
+    const Revision * revision1;
+    const Revision * revision2;
+    bool recurse;
+    bool ignoreAncestry;
+    bool noDiffDeleted;
+
+    DiffParams()
+        : path1(0), path2(0), pegRevision(0),
+        revision1(0), revision2(0), recurse(false),
+        ignoreAncestry(false), noDiffDeleted(false)
+    {
+    }
+  };
 
+  /**
+   * runs svn_client_diff or svn_client_diff_peg
+   * (if @a params.pegRevision is set) and writes the output
+   * to @a outfile
+   */
+  static svn_error_t *
+  runDiff(const DiffParams & params,
+          apr_file_t * outfile, apr_file_t * errfile,
+          svn_client_ctx_t * ctx, apr_pool_t * pool)
+  {
     // svn_client_diff needs an options array, even if it is empty
-    options = apr_array_make(pool, 0, 0);
+    apr_array_header_t * options = apr_array_make(pool, 0, 0);
+
+    if (params.pegRevision != 0)
+      return svn_client_diff_peg(options,
+                                 params.path1->c_str(),
+                                 params.pegRevision->revision(),
+                                 params.revision1->revision(),
+                                 params.revision2->revision(),
+                                 params.recurse,
+                                 params.ignoreAncestry,
+                                 params.noDiffDeleted,
+                                 outfile, errfile,
+                                 ctx, pool);
+
+    return svn_client_diff(options,
+                           params.path1->c_str(),
+                           params.revision1->revision(),
+                           params.path2->c_str(),
+                           params.revision2->revision(),
+                           params.recurse,
+                           params.ignoreAncestry,
+                           params.noDiffDeleted,
+                           outfile, errfile,
+                           ctx, pool);
+  }
 
-    // svn_client_diff needs a temporary file to write diff output to
-    error = svn_io_open_unique_file(&outfile, &outfileName,
-                                    tmpPath.c_str(), ".tmp",
-                                    FALSE, pool);
+  /**
+   * reads from @a file in chunks and passes them to @a sink.
+   * Once the sink doesn't want any more data, the remaining
+   * data is read and discarded, so the writer won't block.
+   */
+  struct DiffReader
+  {
+    apr_file_t * file;
+    OutputSink * sink;
+    bool stopped;
+    bool failed;
 
-    if (error != NULL)
+    DiffReader(apr_file_t * file_, OutputSink * sink_)
+        : file(file_), sink(sink_), stopped(false), failed(false)
     {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      throw ClientException(error);
     }
 
-    // and another one to write errors to
+    void
+    readAll()
+    {
+      char * buffer = new char[DIFF_CHUNK_SIZE];
+
+      for (;;)
+      {
+        apr_size_t len = DIFF_CHUNK_SIZE;
+        apr_status_t status = apr_file_read(file, buffer, &len);
+
+        if ((len > 0) && !stopped)
+        {
+          try
+          {
+            if (!sink->write(buffer, len))
+              stopped = true;
+          }
+          catch (...)
+          {
+            stopped = true;
+            failed = true;
+          }
+        }
+
+        if (status != APR_SUCCESS)
+          break;
+      }
+
+      delete [] buffer;
+    }
+  };
+
+#if APR_HAS_THREADS
+  static void * APR_THREAD_FUNC
+  diffReaderThread(apr_thread_t * thread, void * baton)
+  {
+    DiffReader * reader = static_cast<DiffReader *>(baton);
+    reader->readAll();
+
+    Pool::threadExit();
+    apr_thread_exit(thread, APR_SUCCESS);
+    return 0;
+  }
+#endif
+
+  /**
+   * runs the diff and streams the output to @a sink.
+   *
+   * If threads are available the diff is written into a pipe
+   * and a reader thread passes the output on to @a sink while
+   * it is being produced. Otherwise the output goes to a temporary
+   * file first, which is read back in chunks. Either way only
+   * a single chunk of the diff is held in memory.
+   */
+  static void
+  diffToSink(OutputSink & sink, const Path & tmpPath,
+             const DiffParams & params, svn_client_ctx_t * ctx)
+  {
+    Pool pool;
+    svn_error_t * error;
+    apr_status_t status;
+    apr_file_t * errfile = NULL;
+    const char * errfileName = NULL;
+
+    // svn_client_diff needs a file to write errors to
     error = svn_io_open_unique_file(&errfile, &errfileName,
                                     tmpPath.c_str(), ".tmp",
                                     FALSE, pool);
 
     if (error != NULL)
     {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
+      diffCleanup(NULL, NULL, errfile, errfileName, pool);
       throw ClientException(error);
     }
 
-    // run diff
-    error = svn_client_diff(options,
-                            path.c_str(), revision1.revision(),
-                            path.c_str(), revision2.revision(),
-                            recurse, ignoreAncestry, noDiffDeleted,
-                            outfile, errfile,
-                            *m_context,
-                            pool);
-
-    if (error != NULL)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      throw ClientException(error);
-    }
+#if APR_HAS_THREADS
+    apr_file_t * readEnd = NULL;
+    apr_file_t * writeEnd = NULL;
 
-    // then we reopen outfile for reading
-    status = apr_file_close(outfile);
+    status = apr_file_pipe_create(&readEnd, &writeEnd, pool);
     if (status)
     {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      fail(pool, status, "failed to close '%s'", outfileName);
+      diffCleanup(NULL, NULL, errfile, errfileName, pool);
+      fail(pool, status, "failed to create pipe for diff output");
     }
 
-    status = apr_file_open(&outfile, outfileName, APR_READ, APR_OS_DEFAULT, pool);
+    DiffReader reader(readEnd, &sink);
+    apr_thread_t * thread = NULL;
+    status = apr_thread_create(&thread, NULL, diffReaderThread,
+                               &reader, pool);
     if (status)
     {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      fail(pool, status, "failed to open '%s'", outfileName);
+      diffCleanup(readEnd, NULL, errfile, errfileName, pool);
+      apr_file_close(writeEnd);
+      fail(pool, status, "failed to start diff reader");
     }
 
-    // now we can read the diff output from outfile and return that
-    error = svn_stringbuf_from_aprfile(&stringbuf, outfile, pool);
+    error = runDiff(params, writeEnd, errfile, ctx, pool);
 
-    if (error != NULL)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      throw ClientException(error);
-    }
+    // closing the write end signals EOF to the reader
+    apr_file_close(writeEnd);
 
-    diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-    return stringbuf->data;
-  }
+    apr_status_t threadStatus;
+    apr_thread_join(&threadStatus, thread);
 
-  std::string
-  Client::diff(const Path & tmpPath, const Path & path1,
-               const Path & path2, const Revision & revision1,
-               const Revision & revision2, const bool recurse,
-               const bool ignoreAncestry, const bool noDiffDeleted)
-  throw(ClientException)
-  {
-    Pool pool;
-    svn_error_t * error;
-    apr_status_t status;
+    diffCleanup(readEnd, NULL, errfile, errfileName, pool);
+#else
     apr_file_t * outfile = NULL;
     const char * outfileName = NULL;
-    apr_file_t * errfile = NULL;
-    const char * errfileName = NULL;
-    apr_array_header_t * options;
-    svn_stringbuf_t * stringbuf;
 
-    // svn_client_diff needs an options array, even if it is empty
-    options = apr_array_make(pool, 0, 0);
-
-    // svn_client_diff needs a temporary file to write diff output to
     error = svn_io_open_unique_file(&outfile, &outfileName,
                                     tmpPath.c_str(), ".tmp",
                                     FALSE, pool);
@@ -187,10 +279,7 @@ namespace svn
       throw ClientException(error);
     }
 
-    // and another one to write errors to
-    error = svn_io_open_unique_file(&errfile, &errfileName,
-                                    tmpPath.c_str(), ".tmp",
-                                    FALSE, pool);
+    error = runDiff(params, outfile, errfile, ctx, pool);
 
     if (error != NULL)
     {
@@ -198,135 +287,139 @@ namespace svn
       throw ClientException(error);
     }
 
-    // run diff
-    error = svn_client_diff(options,
-                            path1.c_str(), revision1.revision(),
-                            path2.c_str(), revision2.revision(),
-                            recurse, ignoreAncestry, noDiffDeleted,
-                            outfile, errfile,
-                            *m_context,
-                            pool);
-
-    if (error != NULL)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      throw ClientException(error);
-    }
-
-    // then we reopen outfile for reading
-    status = apr_file_close(outfile);
+    // rewind and pass the output on in chunks
+    apr_off_t offset = 0;
+    status = apr_file_seek(outfile, APR_SET, &offset);
     if (status)
     {
       diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      fail(pool, status, "failed to close '%s'", outfileName);
+      fail(pool, status, "failed to rewind '%s'", outfileName);
     }
 
-    status = apr_file_open(&outfile, outfileName, APR_READ, APR_OS_DEFAULT, pool);
-    if (status)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      fail(pool, status, "failed to open '%s'", outfileName);
-    }
+    DiffReader reader(outfile, &sink);
+    reader.readAll();
 
-    // now we can read the diff output from outfile and return that
-    error = svn_stringbuf_from_aprfile(&stringbuf, outfile, pool);
+    diffCleanup(outfile, outfileName, errfile, errfileName, pool);
+#endif
 
     if (error != NULL)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
       throw ClientException(error);
-    }
 
-    diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-    return stringbuf->data;
+    if (reader.failed)
+      throw ClientException("error while processing the diff output");
   }
 
-  std::string
-  Client::diff(const Path & tmpPath, const Path & path,
-               const Revision & pegRevision,
+  void
+  Client::diff(OutputSink & sink,
+               const Path & tmpPath, const Path & path,
                const Revision & revision1, const Revision & revision2,
                const bool recurse, const bool ignoreAncestry,
                const bool noDiffDeleted) throw(ClientException)
   {
-    Pool pool;
-    svn_error_t * error;
-    apr_status_t status;
-    apr_file_t * outfile = NULL;
-    const char * outfileName = NULL;
-    apr_file_t * errfile = NULL;
-    const char * errfileName = NULL;
-    apr_array_header_t * options;
-    svn_stringbuf_t * stringbuf;
-
-    // svn_client_diff needs an options array, even if it is empty
-    options = apr_array_make(pool, 0, 0);
+    ClientCall call(m_context, "diff");
+
+    DiffParams params;
+    params.path1 = &path;
+    params.path2 = &path;
+    params.revision1 = &revision1;
+    params.revision2 = &revision2;
+    params.recurse = recurse;
+    params.ignoreAncestry = ignoreAncestry;
+    params.noDiffDeleted = noDiffDeleted;
+
+    diffToSink(sink, tmpPath, params, *m_context);
+  }
 
-    // svn_client_diff needs a temporary file to write diff output to
-    error = svn_io_open_unique_file(&outfile, &outfileName,
-                                    tmpPath.c_str(), ".tmp",
-                                    FALSE, pool);
+  void
+  Client::diff(OutputSink & sink,
+               const Path & tmpPath, const Path & path1,
+               const Path & path2, const Revision & revision1,
+               const Revision & revision2, const bool recurse,
+               const bool ignoreAncestry, const bool noDiffDeleted)
+  throw(ClientException)
+  {
+    ClientCall call(m_context, "diff");
+
+    DiffParams params;
+    params.path1 = &path1;
+    params.path2 = &path2;
+    params.revision1 = &revision1;
+    params.revision2 = &revision2;
+    params.recurse = recurse;
+    params.ignoreAncestry = ignoreAncestry;
+    params.noDiffDeleted = noDiffDeleted;
+
+    diffToSink(sink, tmpPath, params, *m_context);
+  }
 
-    if (error != NULL)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      throw ClientException(error);
-    }
+  void
+  Client::diff(OutputSink & sink,
+               const Path & tmpPath, const Path & path,
+               const Revision & pegRevision,
+               const Revision & revision1, const Revision & revision2,
+               const bool recurse, const bool ignoreAncestry,
+               const bool noDiffDeleted) throw(ClientException)
+  {
+    ClientCall call(m_context, "diff");
+
+    DiffParams params;
+    params.path1 = &path;
+    params.pegRevision = &pegRevision;
+    params.revision1 = &revision1;
+    params.revision2 = &revision2;
+    params.recurse = recurse;
+    params.ignoreAncestry = ignoreAncestry;
+    params.noDiffDeleted = noDiffDeleted;
+
+    diffToSink(sink, tmpPath, params, *m_context);
+  }
 
-    // and another one to write errors to
-    error = svn_io_open_unique_file(&errfile, &errfileName,
-                                    tmpPath.c_str(), ".tmp",
-                                    FALSE, pool);
+  std::string
+  Client::diff(const Path & tmpPath, const Path & path,
+               const Revision & revision1, const Revision & revision2,
+               const bool recurse, const bool ignoreAncestry,
+               const bool noDiffDeleted) throw(ClientException)
+  {
+    std::string result;
+    StringOutputSink sink(result);
 
-    if (error != NULL)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      throw ClientException(error);
-    }
+    diff(sink, tmpPath, path, revision1, revision2,
+         recurse, ignoreAncestry, noDiffDeleted);
 
-    // run diff
-    error = svn_client_diff_peg(options,
-                                path.c_str(), pegRevision.revision(),
-                                revision1.revision(), revision2.revision(),
-                                recurse, ignoreAncestry, noDiffDeleted,
-                                outfile, errfile,
-                                *m_context,
-                                pool);
+    return result;
+  }
 
-    if (error != NULL)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      throw ClientException(error);
-    }
+  std::string
+  Client::diff(const Path & tmpPath, const Path & path1,
+               const Path & path2, const Revision & revision1,
+               const Revision & revision2, const bool recurse,
+               const bool ignoreAncestry, const bool noDiffDeleted)
+  throw(ClientException)
+  {
+    std::string result;
+    StringOutputSink sink(result);
 
-    // then we reopen outfile for reading
-    status = apr_file_close(outfile);
-    if (status)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      fail(pool, status, "failed to close '%s'", outfileName);
-    }
+    diff(sink, tmpPath, path1, path2, revision1, revision2,
+         recurse, ignoreAncestry, noDiffDeleted);
 
-    status = apr_file_open(&outfile, outfileName, APR_READ, APR_OS_DEFAULT, pool);
-    if (status)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      fail(pool, status, "failed to open '%s'", outfileName);
-    }
+    return result;
+  }
 
-    // now we can read the diff output from outfile and return that
-    error = svn_stringbuf_from_aprfile(&stringbuf, outfile, pool);
+  std::string
+  Client::diff(const Path & tmpPath, const Path & path,
+               const Revision & pegRevision,
+               const Revision & revision1, const Revision & revision2,
+               const bool recurse, const bool ignoreAncestry,
+               const bool noDiffDeleted) throw(ClientException)
+  {
+    std::string result;
+    StringOutputSink sink(result);
 
-    if (error != NULL)
-    {
-      diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-      throw ClientException(error);
-    }
+    diff(sink, tmpPath, path, pegRevision, revision1, revision2,
+         recurse, ignoreAncestry, noDiffDeleted);
 
-    diffCleanup(outfile, outfileName, errfile, errfileName, pool);
-    return stringbuf->data;
+    return result;
   }
-
-
 }
 
 /* -----------------------------------------------------------------
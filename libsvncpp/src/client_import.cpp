@@ -0,0 +1,359 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+// stl
+#include "svncpp/string_wrapper.hpp"
+
+// Subversion api
+#include "svn_client.h"
+#include "svn_delta.h"
+#include "svn_io.h"
+#include "svn_path.h"
+#include "svn_props.h"
+#include "svn_ra.h"
+#include "svn_subst.h"
+#include "svn_wc.h"
+
+// svncpp
+#include "svncpp/client.hpp"
+#include "svncpp/exception.hpp"
+#include "svncpp/pool.hpp"
+#include "svncpp/targets.hpp"
+#include "auto_props.hpp"
+#include "client_call.hpp"
+
+namespace svn
+{
+  /**
+   * everything needed while driving the commit editor
+   * for an import
+   */
+  struct ImportBaton
+  {
+    const svn_delta_editor_t * editor;
+    svn_client_ctx_t * ctx;
+    apr_array_header_t * ignores;
+    bool recurse;
+  };
+
+  /**
+   * receives the result of the commit
+   */
+  struct CommitBaton
+  {
+    svn_commit_info_t * info;
+    apr_pool_t * pool;
+  };
+
+  static svn_error_t *
+  commitCallback(const svn_commit_info_t * info,
+                 void * baton_,
+                 apr_pool_t * /*pool*/)
+  {
+    CommitBaton * baton = static_cast<CommitBaton *>(baton_);
+    baton->info = svn_commit_info_dup(info, baton->pool);
+
+    return SVN_NO_ERROR;
+  }
+
+  static void
+  notifyAdded(const ImportBaton & baton,
+              const char * path,
+              svn_node_kind_t kind,
+              const char * mimeType,
+              apr_pool_t * pool)
+  {
+    if (baton.ctx->notify_func2 == NULL)
+      return;
+
+    svn_wc_notify_t * notify =
+      svn_wc_create_notify(path, svn_wc_notify_commit_added, pool);
+    notify->kind = kind;
+    notify->mime_type = mimeType;
+
+    baton.ctx->notify_func2(baton.ctx->notify_baton2, notify, pool);
+  }
+
+  static svn_error_t *
+  importFile(const char * path,
+             const char * editPath,
+             void * dirBaton,
+             const ImportBaton & baton,
+             apr_pool_t * pool)
+  {
+    const svn_delta_editor_t * editor = baton.editor;
+
+    apr_hash_t * props;
+    const char * mimeType;
+    bool special;
+    SVN_ERR(getAutoProps(&props, &mimeType, &special, path,
+                         baton.ctx, pool));
+
+    notifyAdded(baton, path, svn_node_file, mimeType, pool);
+
+    void * fileBaton;
+    SVN_ERR(editor->add_file(editPath, dirBaton, NULL, SVN_INVALID_REVNUM,
+                             pool, &fileBaton));
+
+    for (apr_hash_index_t * hi = apr_hash_first(pool, props);
+         hi != NULL; hi = apr_hash_next(hi))
+    {
+      const void * name;
+      void * value;
+      apr_hash_this(hi, &name, NULL, &value);
+
+      SVN_ERR(editor->change_file_prop(
+                fileBaton, static_cast<const char *>(name),
+                static_cast<const svn_string_t *>(value), pool));
+    }
+
+    svn_txdelta_window_handler_t handler;
+    void * handlerBaton;
+    SVN_ERR(editor->apply_textdelta(fileBaton, NULL, pool,
+                                    &handler, &handlerBaton));
+
+    svn_stream_t * contents;
+    if (special)
+    {
+      // the repository keeps the target of a symlink
+      // in the form "link <target>"
+      svn_string_t * target;
+      SVN_ERR(svn_io_read_link(&target, path, pool));
+
+      svn_stringbuf_t * link = svn_stringbuf_create("link ", pool);
+      svn_stringbuf_appendbytes(link, target->data, target->len);
+      contents = svn_stream_from_stringbuf(link, pool);
+    }
+    else
+    {
+      apr_file_t * file;
+      SVN_ERR(svn_io_file_open(&file, path,
+                               APR_READ | APR_BINARY | APR_BUFFERED,
+                               APR_OS_DEFAULT, pool));
+      contents = svn_stream_from_aprfile2(file, FALSE, pool);
+    }
+
+    // the repository gets eol-style and keywords in normal form
+    const svn_string_t * eolStyle = static_cast<const svn_string_t *>(
+      apr_hash_get(props, SVN_PROP_EOL_STYLE, APR_HASH_KEY_STRING));
+    const svn_string_t * keywords = static_cast<const svn_string_t *>(
+      apr_hash_get(props, SVN_PROP_KEYWORDS, APR_HASH_KEY_STRING));
+
+    if ((eolStyle != NULL) || (keywords != NULL))
+    {
+      const char * eolStr = NULL;
+      if (eolStyle != NULL)
+      {
+        svn_subst_eol_style_t style;
+        svn_subst_eol_style_from_value(&style, &eolStr, eolStyle->data);
+
+        if (style == svn_subst_eol_style_native)
+          eolStr = "\n";
+        else if (style != svn_subst_eol_style_fixed)
+          eolStr = NULL;
+      }
+
+      apr_hash_t * keywordHash = NULL;
+      if (keywords != NULL)
+        SVN_ERR(svn_subst_build_keywords2(&keywordHash, keywords->data,
+                                          "", "", 0, "", pool));
+
+      contents = svn_subst_stream_translated(contents, eolStr, TRUE,
+                                             keywordHash, FALSE, pool);
+    }
+
+    SVN_ERR(svn_txdelta_send_stream(contents, handler, handlerBaton,
+                                    NULL, pool));
+    SVN_ERR(svn_stream_close(contents));
+
+    return editor->close_file(fileBaton, NULL, pool);
+  }
+
+  static svn_error_t *
+  importItem(const char * path,
+             const char * editPath,
+             void * dirBaton,
+             const ImportBaton & baton,
+             apr_pool_t * pool);
+
+  static svn_error_t *
+  importDir(const char * path,
+            const char * editPath,
+            void * parentBaton,
+            const ImportBaton & baton,
+            apr_pool_t * pool)
+  {
+    const svn_delta_editor_t * editor = baton.editor;
+
+    notifyAdded(baton, path, svn_node_dir, NULL, pool);
+
+    void * dirBaton;
+    SVN_ERR(editor->add_directory(editPath, parentBaton, NULL,
+                                  SVN_INVALID_REVNUM, pool, &dirBaton));
+
+    if (baton.recurse)
+    {
+      apr_hash_t * dirents;
+      SVN_ERR(svn_io_get_dirents2(&dirents, path, pool));
+
+      apr_pool_t * subpool = svn_pool_create(pool);
+      for (apr_hash_index_t * hi = apr_hash_first(pool, dirents);
+           hi != NULL; hi = apr_hash_next(hi))
+      {
+        svn_pool_clear(subpool);
+
+        if (baton.ctx->cancel_func != NULL)
+          SVN_ERR(baton.ctx->cancel_func(baton.ctx->cancel_baton));
+
+        const void * key;
+        apr_hash_this(hi, &key, NULL, NULL);
+        const char * name = static_cast<const char *>(key);
+
+        if (svn_wc_is_adm_dir(name, subpool) ||
+            svn_wc_match_ignore_list(name, baton.ignores, subpool))
+          continue;
+
+        SVN_ERR(importItem(svn_path_join(path, name, subpool),
+                           svn_path_join(editPath, name, subpool),
+                           dirBaton, baton, subpool));
+      }
+      svn_pool_destroy(subpool);
+    }
+
+    return editor->close_directory(dirBaton, pool);
+  }
+
+  static svn_error_t *
+  importItem(const char * path,
+             const char * editPath,
+             void * dirBaton,
+             const ImportBaton & baton,
+             apr_pool_t * pool)
+  {
+    // symlinks are imported as they are, not followed
+    svn_node_kind_t kind;
+    svn_boolean_t special;
+    SVN_ERR(svn_io_check_special_path(path, &kind, &special, pool));
+
+    if (kind == svn_node_dir)
+      return importDir(path, editPath, dirBaton, baton, pool);
+    else if (kind == svn_node_file)
+      return importFile(path, editPath, dirBaton, baton, pool);
+
+    return SVN_NO_ERROR;
+  }
+
+  /**
+   * adds all the @a targets to the root directory of
+   * the commit
+   */
+  static svn_error_t *
+  driveImport(const Targets & targets,
+              void * editBaton,
+              const ImportBaton & baton,
+              apr_pool_t * pool)
+  {
+    const svn_delta_editor_t * editor = baton.editor;
+
+    void * rootBaton;
+    SVN_ERR(editor->open_root(editBaton, SVN_INVALID_REVNUM,
+                              pool, &rootBaton));
+
+    apr_pool_t * subpool = svn_pool_create(pool);
+    const PathVector & paths = targets.targets();
+    PathVector::const_iterator it;
+    for (it = paths.begin(); it != paths.end(); it++)
+    {
+      svn_pool_clear(subpool);
+
+      if (baton.ctx->cancel_func != NULL)
+        SVN_ERR(baton.ctx->cancel_func(baton.ctx->cancel_baton));
+
+      const char * path = it->c_str();
+      SVN_ERR(importItem(path, svn_path_basename(path, subpool),
+                         rootBaton, baton, subpool));
+    }
+    svn_pool_destroy(subpool);
+
+    SVN_ERR(editor->close_directory(rootBaton, pool));
+    return editor->close_edit(editBaton, pool);
+  }
+
+  void
+  Client::import(const Targets & targets,
+                 const Path & url,
+                 const char * message,
+                 bool recurse) throw(ClientException)
+  {
+    ClientCall call(m_context, "import");
+
+    Pool pool;
+    m_commitInfo = CommitInfo();
+
+    svn_client_ctx_t * ctx = *m_context;
+    svn_ra_session_t * session = m_context->acquireSession(url.c_str());
+
+    ImportBaton baton;
+    baton.ctx = ctx;
+    baton.recurse = recurse;
+
+    svn_error_t * error =
+      svn_wc_get_default_ignores(&baton.ignores, ctx->config, pool);
+
+    apr_hash_t * revprops = apr_hash_make(pool);
+    apr_hash_set(revprops, SVN_PROP_REVISION_LOG, APR_HASH_KEY_STRING,
+                 svn_string_create(message, pool));
+
+    CommitBaton commitBaton;
+    commitBaton.info = NULL;
+    commitBaton.pool = pool;
+
+    void * editBaton;
+    if (error == NULL)
+      error = svn_ra_get_commit_editor3(session, &baton.editor, &editBaton,
+                                        revprops, commitCallback,
+                                        &commitBaton, NULL, FALSE, pool);
+
+    if (error == NULL)
+    {
+      error = driveImport(targets, editBaton, baton, pool);
+
+      if (error != NULL)
+        svn_error_clear(baton.editor->abort_edit(editBaton, pool));
+    }
+
+    m_context->releaseSession(session, error == NULL);
+
+    if (error != NULL)
+      throw ClientException(error);
+
+    if (commitBaton.info != NULL)
+      m_commitInfo = CommitInfo(commitBaton.info);
+  }
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
@@ -24,6 +24,7 @@
 // subversion api
 #include "svn_client.h"
 #include "svn_path.h"
+#include "svn_ra.h"
 #include "svn_sorts.h"
 //#include "svn_utf.h"
 
@@ -31,6 +32,8 @@
 #include "svncpp/client.hpp"
 #include "svncpp/dirent.hpp"
 #include "svncpp/exception.hpp"
+#include "svncpp/url.hpp"
+#include "client_call.hpp"
 
 #include "m_is_empty.hpp"
 
@@ -57,21 +60,163 @@ namespace svn
     return 0;
   }
 
+  /**
+   * list the immediate children of @a url using a pooled
+   * ra session of @a context, so browsing a repository doesnt
+   * pay for a new connection with every call.
+   *
+   * @return false if this isnt possible for @a revision or
+   *         anything went wrong. The caller should use
+   *         svn_client_list2 then, which gives the proper error
+   */
+  static bool
+  listWithSession(Context * context,
+                  const char * url,
+                  const svn_opt_revision_t * revision,
+                  apr_uint32_t direntFields,
+                  bool fetchLocks,
+                  DirEntries & entries)
+  {
+    switch (revision->kind)
+    {
+    case svn_opt_revision_unspecified:
+    case svn_opt_revision_head:
+    case svn_opt_revision_number:
+    case svn_opt_revision_date:
+      break;
+
+    default:
+      return false;
+    }
+
+    svn_ra_session_t * session;
+    try
+    {
+      session = context->acquireSession(url);
+    }
+    catch (ClientException &)
+    {
+      return false;
+    }
+
+    Pool pool;
+    svn_revnum_t revnum = SVN_INVALID_REVNUM;
+    svn_error_t * error = NULL;
+
+    if (revision->kind == svn_opt_revision_number)
+      revnum = revision->value.number;
+    else if (revision->kind == svn_opt_revision_date)
+      error = svn_ra_get_dated_revision(session, &revnum,
+                                        revision->value.date, pool);
+
+    apr_hash_t * dirents = NULL;
+    if (error == NULL)
+      error = svn_ra_get_dir2(session, &dirents, NULL, NULL, "",
+                              revnum, direntFields, pool);
+
+    const char * root = NULL;
+    if (error == NULL)
+      error = svn_ra_get_repos_root(session, &root, pool);
+
+    const char * uuid = NULL;
+    if (error == NULL)
+      error = svn_ra_get_uuid(session, &uuid, pool);
+
+    apr_hash_t * locks = NULL;
+    if (fetchLocks && (error == NULL))
+    {
+      error = svn_ra_get_locks(session, &locks, "", pool);
+
+      // old servers dont know about locks
+      if ((error != NULL) && (error->apr_err == SVN_ERR_RA_NOT_IMPLEMENTED))
+      {
+        svn_error_clear(error);
+        error = NULL;
+        locks = NULL;
+      }
+    }
+
+    if (error != NULL)
+    {
+      svn_error_clear(error);
+      context->releaseSession(session, false);
+      return false;
+    }
+
+    // locks are keyed by the path inside the repository
+    const char * relUrl = svn_path_is_child(root, url, pool);
+    const char * fsPath = "/";
+    if (relUrl != NULL)
+      fsPath = svn_path_join(fsPath, svn_path_uri_decode(relUrl, pool), pool);
+
+    apr_array_header_t * sorted =
+      svn_sort__hash(dirents, compare_items_as_paths, pool);
+
+    for (int i = 0; i < sorted->nelts; i++)
+    {
+      const svn_sort__item_t & item =
+        APR_ARRAY_IDX(sorted, i, const svn_sort__item_t);
+      const char * name = static_cast<const char *>(item.key);
+      svn_dirent_t * dirent = static_cast<svn_dirent_t *>(item.value);
+
+      const svn_lock_t * lock = NULL;
+      if (locks != NULL)
+        lock = static_cast<const svn_lock_t *>(
+                 apr_hash_get(locks, svn_path_join(fsPath, name, pool),
+                              APR_HASH_KEY_STRING));
+
+      entries.push_back(DirEntry(name, dirent, lock));
+    }
+
+    context->releaseSession(session);
+
+    // remember the repository, the urls of the entries
+    // are derived from the listed url
+    RepositoryInfo info;
+    info.url = url;
+    info.root = root;
+    info.uuid = uuid;
+    context->cacheRepositoryInfo(url, info, true);
+
+    return true;
+  }
+
   DirEntries
   Client::list(const char * pathOrUrl,
                svn_opt_revision_t * revision,
                bool recurse) throw(ClientException)
   {
+    return list(pathOrUrl, revision, recurse, SVN_DIRENT_ALL, true);
+  }
+
+  DirEntries
+  Client::list(const char * pathOrUrl,
+               svn_opt_revision_t * revision,
+               bool recurse,
+               apr_uint32_t direntFields,
+               bool fetchLocks) throw(ClientException)
+  {
+    ClientCall call(m_context, "list");
+
     Pool pool;
 
     DirEntries entries;
+    if (!recurse && (m_context != 0) && Url::isValid(pathOrUrl))
+    {
+      if (listWithSession(m_context, pathOrUrl, revision,
+                          direntFields, fetchLocks, entries))
+        return entries;
+
+      entries.clear();
+    }
+
     svn_error_t * error =
       svn_client_list2(pathOrUrl,
                        revision,
                        revision,
                        recurse ? svn_depth_infinity : svn_depth_immediates,
-                       SVN_DIRENT_ALL,
-                       true,
+                       direntFields,
+                       fetchLocks,
                        listEntriesFunc,
                        &entries,
                        *m_context,
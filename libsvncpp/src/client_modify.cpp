@@ -21,14 +21,27 @@
  * history and logs, available at http://rapidsvn.tigris.org/.
  * ====================================================================
  */
+// stl
+#include <cstring>
+#include "svncpp/map_wrapper.hpp"
+#include "svncpp/string_wrapper.hpp"
+#include "svncpp/vector_wrapper.hpp"
+
 // subversion api
 #include "svn_client.h"
+#include "svn_io.h"
+#include "svn_path.h"
+#include "svn_props.h"
+#include "svn_wc.h"
 
 // svncpp
 #include "svncpp/client.hpp"
 #include "svncpp/exception.hpp"
 #include "svncpp/pool.hpp"
 #include "svncpp/targets.hpp"
+#include "auto_props.hpp"
+#include "client_call.hpp"
+#include "m_check.hpp"
 
 namespace svn
 {
@@ -40,10 +53,15 @@ namespace svn
                    bool ignore_externals,
                    const Revision & peg_revision) throw(ClientException)
   {
+    ClientCall call(m_context, "checkout");
+
     Pool subPool;
     apr_pool_t * apr_pool = subPool.pool();
     svn_revnum_t revnum = 0;
 
+    // the urls of paths below destPath are going to change
+    m_context->clearRepositoryInfo();
+
     svn_error_t * error =
       svn_client_checkout2(&revnum,
                            url,
@@ -65,6 +83,8 @@ namespace svn
   Client::remove(const Path & path,
                  bool force) throw(ClientException)
   {
+    ClientCall call(m_context, "remove");
+
     Pool pool;
     Targets targets(path.c_str());
     svn_client_commit_info_t *commit_info = NULL;
@@ -83,6 +103,8 @@ namespace svn
   Client::remove(const Targets & targets,
                  bool force) throw(ClientException)
   {
+    ClientCall call(m_context, "remove");
+
     Pool pool;
     svn_client_commit_info_t *commit_info = NULL;
 
@@ -100,6 +122,8 @@ namespace svn
   Client::lock(const Targets & targets, bool force,
                const char * comment) throw(ClientException)
   {
+    ClientCall call(m_context, "lock");
+
     Pool pool;
 
     svn_error_t * error =
@@ -115,6 +139,8 @@ namespace svn
   void
   Client::unlock(const Targets & targets, bool force) throw(ClientException)
   {
+    ClientCall call(m_context, "unlock");
+
     Pool pool;
 
     svn_error_t * error =
@@ -130,6 +156,8 @@ namespace svn
   Client::revert(const Targets & targets,
                  bool recurse) throw(ClientException)
   {
+    ClientCall call(m_context, "revert");
+
     Pool pool;
 
     svn_error_t * error =
@@ -146,6 +174,8 @@ namespace svn
   Client::add(const Path & path,
               bool recurse) throw(ClientException)
   {
+    ClientCall call(m_context, "add");
+
     Pool pool;
 
     // we do not need the newer version of this
@@ -162,15 +192,215 @@ namespace svn
       throw ClientException(error);
   }
 
+  /**
+   * add the file (or symlink) @a path together with the
+   * properties svn_client_add would set on it
+   */
+  static svn_error_t *
+  addFile(const char * path,
+          svn_wc_adm_access_t * adm,
+          svn_client_ctx_t * ctx,
+          apr_pool_t * pool)
+  {
+    apr_hash_t * properties;
+    const char * mimetype;
+    bool special;
+    SVN_ERR(getAutoProps(&properties, &mimetype, &special, path, ctx, pool));
+
+    // the notification is sent below, along with the mime-type
+    SVN_ERR(svn_wc_add2(path, adm, NULL, SVN_INVALID_REVNUM,
+                        ctx->cancel_func, ctx->cancel_baton,
+                        NULL, NULL, pool));
+
+    for (apr_hash_index_t * hi = apr_hash_first(pool, properties);
+         hi != NULL; hi = apr_hash_next(hi))
+    {
+      const void * name;
+      void * value;
+      apr_hash_this(hi, &name, NULL, &value);
+
+      SVN_ERR(svn_wc_prop_set2(static_cast<const char *>(name),
+                               static_cast<const svn_string_t *>(value),
+                               path, adm, FALSE, pool));
+    }
+
+    if (ctx->notify_func2 != NULL)
+    {
+      svn_wc_notify_t * notify =
+        svn_wc_create_notify(path, svn_wc_notify_add, pool);
+      notify->kind = svn_node_file;
+      notify->mime_type = mimetype;
+      ctx->notify_func2(ctx->notify_baton2, notify, pool);
+    }
+
+    return SVN_NO_ERROR;
+  }
+
+  /**
+   * add @a path and, with @a recurse, everything below it
+   * that isn't ignored. This does the same as svn_client_add,
+   * including the auto-props, just with the parent directory
+   * locked by the caller already.
+   */
+  static svn_error_t *
+  addPath(const char * path,
+          svn_wc_adm_access_t * adm,
+          bool recurse,
+          apr_array_header_t * ignores,
+          svn_client_ctx_t * ctx,
+          apr_pool_t * pool)
+  {
+    svn_node_kind_t kind;
+    SVN_ERR(svn_io_check_path(path, &kind, pool));
+
+    if (kind == svn_node_file)
+      return addFile(path, adm, ctx, pool);
+
+    SVN_ERR(svn_wc_add2(path, adm, NULL, SVN_INVALID_REVNUM,
+                        ctx->cancel_func, ctx->cancel_baton,
+                        ctx->notify_func2, ctx->notify_baton2,
+                        pool));
+
+    if (!recurse || (kind != svn_node_dir))
+      return SVN_NO_ERROR;
+
+    // the new directory has been locked by svn_wc_add2
+    svn_wc_adm_access_t * dirAdm;
+    SVN_ERR(svn_wc_adm_retrieve(&dirAdm, adm, path, pool));
+
+    apr_dir_t * dir;
+    SVN_ERR(svn_io_dir_open(&dir, path, pool));
+
+    apr_pool_t * subpool = svn_pool_create(pool);
+    apr_finfo_t finfo;
+
+    for (;;)
+    {
+      svn_pool_clear(subpool);
+
+      if (ctx->cancel_func != NULL)
+        SVN_ERR(ctx->cancel_func(ctx->cancel_baton));
+
+      svn_error_t * error =
+        svn_io_dir_read(&finfo, APR_FINFO_TYPE | APR_FINFO_NAME,
+                        dir, subpool);
+      if (error != NULL)
+      {
+        if (!APR_STATUS_IS_ENOENT(error->apr_err))
+          return error;
+
+        // no more entries
+        svn_error_clear(error);
+        break;
+      }
+
+      if ((0 == strcmp(finfo.name, ".")) || (0 == strcmp(finfo.name, "..")))
+        continue;
+
+      if (svn_wc_is_adm_dir(finfo.name, subpool) ||
+          svn_wc_match_ignore_list(finfo.name, ignores, subpool))
+        continue;
+
+      const char * child = svn_path_join(path, finfo.name, subpool);
+      SVN_ERR(addPath(child, dirAdm, true, ignores, ctx, subpool));
+    }
+
+    svn_pool_destroy(subpool);
+    return svn_io_dir_close(dir);
+  }
+
+  void
+  Client::add(const Targets & targets,
+              bool recurse) throw(ClientException)
+  {
+    ClientCall call(m_context, "add");
+
+    Pool pool;
+    typedef std::map<std::string, std::vector<std::string> > ParentMap;
+
+    // with recurse, targets below another target are added
+    // along with it
+    std::map<std::string, bool> requested;
+    const PathVector & paths = targets.targets();
+    PathVector::const_iterator it;
+    for (it = paths.begin(); it != paths.end(); it++)
+      requested[it->path()] = true;
+
+    // group the targets by their parent directory, so every
+    // directory has to be locked only once. Parents sort
+    // before their children
+    ParentMap parents;
+    for (it = paths.begin(); it != paths.end(); it++)
+    {
+      const char * parent = svn_path_dirname(it->c_str(), pool);
+
+      if (recurse)
+      {
+        bool below = false;
+        for (const char * dir = parent; !below && !svn_path_is_empty(dir);
+             dir = svn_path_dirname(dir, pool))
+        {
+          below = requested.find(dir) != requested.end();
+          if (0 == strcmp(dir, "/"))
+            break;
+        }
+
+        if (below)
+          continue;
+      }
+
+      parents[parent].push_back(it->path());
+    }
+
+    svn_client_ctx_t * ctx = *m_context;
+    apr_array_header_t * ignores;
+    svn_error_t * error =
+      svn_wc_get_default_ignores(&ignores, ctx->config, pool);
+
+    Pool subPool;
+    ParentMap::const_iterator parent;
+    for (parent = parents.begin();
+         (error == NULL) && (parent != parents.end()); parent++)
+    {
+      subPool.renew();
+
+      svn_wc_adm_access_t * adm;
+      error = svn_wc_adm_open3(&adm, NULL, parent->first.c_str(),
+                               TRUE, 0, ctx->cancel_func,
+                               ctx->cancel_baton, subPool);
+      if (error != NULL)
+        break;
+
+      std::vector<std::string>::const_iterator path;
+      for (path = parent->second.begin();
+           (error == NULL) && (path != parent->second.end()); path++)
+        error = addPath(path->c_str(), adm, recurse, ignores, ctx, subPool);
+
+      svn_error_t * closeError = svn_wc_adm_close(adm);
+      if (error == NULL)
+        error = closeError;
+      else
+        svn_error_clear(closeError);
+    }
+
+    if (error != NULL)
+      throw ClientException(error);
+  }
+
   std::vector<svn_revnum_t>
   Client::update(const Targets & targets,
                  const Revision & revision,
                  bool recurse,
                  bool ignore_externals) throw(ClientException)
   {
+    ClientCall call(m_context, "update");
+
     Pool pool;
     apr_array_header_t * result_revs;
 
+    // changed externals definitions change urls
+    m_context->clearRepositoryInfo();
+
     svn_error_t * error =
       svn_client_update2(&result_revs,
                          const_cast<apr_array_header_t*>(targets.array(pool)),
@@ -211,6 +441,8 @@ namespace svn
                  bool recurse,
                  bool keep_locks) throw(ClientException)
   {
+    ClientCall call(m_context, "commit");
+
     Pool pool;
 
     m_context->setLogMessage(message);
@@ -247,6 +479,8 @@ namespace svn
                const Revision & srcRevision,
                const Path & destPath) throw(ClientException)
   {
+    ClientCall call(m_context, "copy");
+
     Pool pool;
     svn_client_commit_info_t *commit_info = NULL;
     svn_error_t * error =
@@ -267,6 +501,8 @@ namespace svn
                const Path & destPath,
                bool force) throw(ClientException)
   {
+    ClientCall call(m_context, "move");
+
     Pool pool;
     svn_client_commit_info_t *commit_info = NULL;
 
@@ -282,9 +518,85 @@ namespace svn
       throw ClientException(error);
   }
 
+  void
+  Client::copy(const Targets & srcPaths,
+               const Revision & srcRevision,
+               const Path & destPath) throw(ClientException)
+  {
+    ClientCall call(m_context, "copy");
+
+    Pool pool;
+    m_commitInfo = CommitInfo();
+
+    const PathVector & paths = srcPaths.targets();
+    apr_array_header_t * sources =
+      apr_array_make(pool, paths.size(), sizeof(svn_client_copy_source_t *));
+
+    PathVector::const_iterator it;
+    for (it = paths.begin(); it != paths.end(); it++)
+    {
+      svn_client_copy_source_t * source =
+        static_cast<svn_client_copy_source_t *>(
+          apr_palloc(pool, sizeof(svn_client_copy_source_t)));
+      source->path = it->c_str();
+      source->revision = srcRevision.revision();
+      source->peg_revision = srcRevision.revision();
+
+      APR_ARRAY_PUSH(sources, svn_client_copy_source_t *) = source;
+    }
+
+    svn_commit_info_t * commit_info = NULL;
+    svn_error_t * error =
+      svn_client_copy4(&commit_info,
+                       sources,
+                       destPath.c_str(),
+                       true,  // copy_as_child
+                       false, // make_parents
+                       NULL,  // revprop_table
+                       *m_context,
+                       pool);
+
+    if (error != NULL)
+      throw ClientException(error);
+
+    if (commit_info)
+      m_commitInfo = CommitInfo(commit_info);
+  }
+
+  void
+  Client::move(const Targets & srcPaths,
+               const Path & destPath,
+               bool force) throw(ClientException)
+  {
+    ClientCall call(m_context, "move");
+
+    Pool pool;
+    m_commitInfo = CommitInfo();
+
+    svn_commit_info_t * commit_info = NULL;
+    svn_error_t * error =
+      svn_client_move5(&commit_info,
+                       const_cast<apr_array_header_t *>(srcPaths.array(pool)),
+                       destPath.c_str(),
+                       force,
+                       true,  // move_as_child
+                       false, // make_parents
+                       NULL,  // revprop_table
+                       *m_context,
+                       pool);
+
+    if (error != NULL)
+      throw ClientException(error);
+
+    if (commit_info)
+      m_commitInfo = CommitInfo(commit_info);
+  }
+
   void
   Client::mkdir(const Path & path) throw(ClientException)
   {
+    ClientCall call(m_context, "mkdir");
+
     Pool pool;
     Targets targets(path.c_str());
 
@@ -302,6 +614,8 @@ namespace svn
   void
   Client::mkdir(const Targets & targets) throw(ClientException)
   {
+    ClientCall call(m_context, "mkdir");
+
     Pool pool;
 
     svn_client_commit_info_t *commit_info = NULL;
@@ -318,6 +632,8 @@ namespace svn
   void
   Client::cleanup(const Path & path) throw(ClientException)
   {
+    ClientCall call(m_context, "cleanup");
+
     Pool subPool;
     apr_pool_t * apr_pool = subPool.pool();
 
@@ -332,6 +648,8 @@ namespace svn
   Client::resolved(const Path & path,
                    bool recurse) throw(ClientException)
   {
+    ClientCall call(m_context, "resolved");
+
     Pool pool;
     svn_error_t * error =
       svn_client_resolved(path.c_str(),
@@ -343,6 +661,112 @@ namespace svn
       throw ClientException(error);
   }
 
+  static svn_error_t *
+  resolvePath(const char * path,
+              svn_wc_adm_access_t * adm,
+              svn_depth_t depth,
+              svn_client_ctx_t * ctx,
+              apr_pool_t * pool)
+  {
+#if CHECK_SVN_VERSION(1,6)
+    return svn_wc_resolved_conflict4(path, adm, TRUE, TRUE, TRUE, depth,
+                                     svn_wc_conflict_choose_merged,
+                                     ctx->notify_func2, ctx->notify_baton2,
+                                     ctx->cancel_func, ctx->cancel_baton,
+                                     pool);
+#else
+    return svn_wc_resolved_conflict3(path, adm, TRUE, TRUE, depth,
+                                     svn_wc_conflict_choose_merged,
+                                     ctx->notify_func2, ctx->notify_baton2,
+                                     ctx->cancel_func, ctx->cancel_baton,
+                                     pool);
+#endif
+  }
+
+  void
+  Client::resolved(const Targets & targets,
+                   bool recurse) throw(ClientException)
+  {
+    ClientCall call(m_context, "resolved");
+
+    Pool pool;
+    typedef std::map<std::string, std::vector<std::string> > ParentMap;
+
+    // files are grouped by their parent directory, so every
+    // directory has to be locked only once. Directories
+    // get a lock of their own covering their tree
+    ParentMap parents;
+    std::vector<std::string> dirs;
+    svn_error_t * error = NULL;
+    const PathVector & paths = targets.targets();
+    PathVector::const_iterator it;
+    for (it = paths.begin(); (error == NULL) && (it != paths.end()); it++)
+    {
+      svn_node_kind_t kind = svn_node_none;
+      error = svn_io_check_path(it->c_str(), &kind, pool);
+
+      if (kind == svn_node_dir)
+        dirs.push_back(it->path());
+      else
+        parents[svn_path_dirname(it->c_str(), pool)].push_back(it->path());
+    }
+
+    svn_client_ctx_t * ctx = *m_context;
+    Pool subPool;
+    ParentMap::const_iterator parent;
+    for (parent = parents.begin();
+         (error == NULL) && (parent != parents.end()); parent++)
+    {
+      subPool.renew();
+
+      svn_wc_adm_access_t * adm;
+      error = svn_wc_adm_open3(&adm, NULL, parent->first.c_str(), TRUE, 0,
+                               ctx->cancel_func, ctx->cancel_baton,
+                               subPool);
+      if (error != NULL)
+        break;
+
+      std::vector<std::string>::const_iterator path;
+      for (path = parent->second.begin();
+           (error == NULL) && (path != parent->second.end()); path++)
+        error = resolvePath(path->c_str(), adm, svn_depth_empty,
+                            ctx, subPool);
+
+      svn_error_t * closeError = svn_wc_adm_close(adm);
+      if (error == NULL)
+        error = closeError;
+      else
+        svn_error_clear(closeError);
+    }
+
+    std::vector<std::string>::const_iterator dir;
+    for (dir = dirs.begin(); (error == NULL) && (dir != dirs.end()); dir++)
+    {
+      subPool.renew();
+
+      svn_wc_adm_access_t * adm;
+      error = svn_wc_adm_open3(&adm, NULL, dir->c_str(), TRUE,
+                               recurse ? -1 : 0,
+                               ctx->cancel_func, ctx->cancel_baton,
+                               subPool);
+      if (error != NULL)
+        break;
+
+      error = resolvePath(dir->c_str(), adm,
+                          recurse ? svn_depth_infinity : svn_depth_empty,
+                          ctx, subPool);
+
+      svn_error_t * closeError = svn_wc_adm_close(adm);
+      if (error == NULL)
+        error = closeError;
+      else
+        svn_error_clear(closeError);
+    }
+
+    if (error != NULL)
+      throw ClientException(error);
+  }
+
   void
   Client::doExport(const Path & from_path,
                    const Path & to_path,
@@ -353,6 +777,8 @@ namespace svn
                    bool recurse,
                    const char * native_eol) throw(ClientException)
   {
+    ClientCall call(m_context, "doExport");
+
     Pool pool;
     svn_revnum_t revnum = 0;
 
@@ -379,8 +805,11 @@ namespace svn
                    const Revision & revision,
                    bool recurse) throw(ClientException)
   {
+    ClientCall call(m_context, "doSwitch");
+
     Pool pool;
     svn_revnum_t revnum = 0;
+    m_context->clearRepositoryInfo();
     svn_error_t * error =
       svn_client_switch(&revnum,
                         path.c_str(),
@@ -401,6 +830,8 @@ namespace svn
                  const char * message,
                  bool recurse) throw(ClientException)
   {
+    ClientCall call(m_context, "import");
+
     Pool pool;
     svn_client_commit_info_t *commit_info = NULL;
 
@@ -435,6 +866,8 @@ namespace svn
                 bool notice_ancestry,
                 bool dry_run) throw(ClientException)
   {
+    ClientCall call(m_context, "merge");
+
     Pool pool;
     svn_error_t * error =
       svn_client_merge(path1.c_str(),
@@ -459,7 +892,10 @@ namespace svn
                    const char * to_url,
                    bool recurse) throw(ClientException)
   {
+    ClientCall call(m_context, "relocate");
+
     Pool pool;
+    m_context->clearRepositoryInfo();
     svn_error_t * error =
       svn_client_relocate(path.c_str(),
                           from_url,
@@ -475,6 +911,8 @@ namespace svn
   void
   Client::ignore(const Path & path) throw(ClientException)
   {
+    ClientCall call(m_context, "ignore");
+
     static const char s_svnIgnore[] = "svn:ignore";
     Pool pool;
 
@@ -30,6 +30,7 @@
 #include "svncpp/exception.hpp"
 #include "svncpp/pool.hpp"
 #include "svncpp/revision.hpp"
+#include "client_call.hpp"
 
 namespace svn
 {
@@ -47,6 +48,8 @@ namespace svn
                    const Revision & revision,
                    bool recurse)
   {
+    ClientCall call(m_context, "proplist");
+
     Pool pool;
     apr_array_header_t * props;
 
@@ -105,6 +108,8 @@ namespace svn
                   const Revision &revision,
                   bool recurse)
   {
+    ClientCall call(m_context, "propget");
+
     Pool pool;
 
     apr_hash_t *props;
@@ -162,6 +167,8 @@ namespace svn
                   bool recurse,
                   bool skip_checks)
   {
+    ClientCall call(m_context, "propset");
+
     Pool pool;
 
     const svn_string_t * propval =
@@ -196,6 +203,8 @@ namespace svn
                   const Revision & /*revision*/,
                   bool recurse)
   {
+    ClientCall call(m_context, "propdel");
+
     Pool pool;
 
     svn_error_t * error =
@@ -226,6 +235,8 @@ namespace svn
   Client::revproplist(const Path &path,
                       const Revision &revision)
   {
+    ClientCall call(m_context, "revproplist");
+
     Pool pool;
 
     apr_hash_t * props;
@@ -275,6 +286,8 @@ namespace svn
                      const Path &path,
                      const Revision &revision)
   {
+    ClientCall call(m_context, "revpropget");
+
     Pool pool;
 
     svn_string_t *propval;
@@ -318,6 +331,8 @@ namespace svn
                      const Revision &revision,
                      bool force)
   {
+    ClientCall call(m_context, "revpropset");
+
     Pool pool;
 
     const svn_string_t * propval
@@ -357,6 +372,8 @@ namespace svn
                      const Revision &revision,
                      bool force)
   {
+    ClientCall call(m_context, "revpropdel");
+
     Pool pool;
 
     svn_revnum_t revnum;
@@ -24,6 +24,10 @@
 // Stdlib (for strcmp)
 #include "string.h"
 
+// stl
+#include "svncpp/string_wrapper.hpp"
+#include "svncpp/vector_wrapper.hpp"
+
 // Subversion api
 #include "svn_client.h"
 #include "svn_sorts.h"
@@ -38,7 +42,9 @@
 #include "svncpp/status.hpp"
 #include "svncpp/targets.hpp"
 #include "svncpp/url.hpp"
+#include "client_call.hpp"
 
+#include "m_check.hpp"
 #include "m_is_empty.hpp"
 
 namespace svn
@@ -80,14 +86,87 @@ namespace svn
     return NULL;
   }
 
+  /**
+   * remember the repository information of versioned
+   * directories, of the status target itself and of every
+   * item whose url cannot be derived from its parent's.
+   * This way the repository root of any path in the
+   * working copy can be looked up later without calling info.
+   *
+   * @param context context to remember the information in
+   * @param target the path status has been called for
+   * @param path the path reported by the status crawl
+   * @param status the status of @a path
+   * @param descend whether the crawl is recursive
+   */
+  static void
+  rememberRepositoryInfo(Context * context,
+                         const char * target,
+                         const char * path,
+                         const svn_wc_status2_t * status,
+                         bool descend)
+  {
+    if ((context == 0) || (status == 0))
+      return;
+
+    if (svn_wc_status_external == status->text_status)
+    {
+      // belongs to a different repository location
+      context->cacheRepositoryInfo(path, RepositoryInfo());
+      return;
+    }
+
+    const svn_wc_entry_t * entry = status->entry;
+    if ((entry == 0) || isEmpty(entry->repos) || isEmpty(entry->url))
+      return;
+
+    bool isTarget = 0 == strcmp(path, target);
+    bool isDir = svn_node_dir == entry->kind;
+    bool isSpecial = status->switched != 0;
+#if CHECK_SVN_VERSION(1,6)
+    isSpecial = isSpecial || (status->file_external != 0);
+#endif
+
+    if (!isDir && !isSpecial && !isTarget)
+      return;
+
+    RepositoryInfo info;
+    info.url = entry->url;
+    info.root = entry->repos;
+    if (entry->uuid != 0)
+      info.uuid = entry->uuid;
+
+    context->cacheRepositoryInfo(path, info,
+                                 isDir && (descend || isTarget));
+  }
+
+  struct EntriesBaton
+  {
+public:
+    StatusEntries & entries;
+    Context * context;
+    const char * target;
+    bool descend;
+
+    EntriesBaton(StatusEntries & entries_, Context * context_,
+                 const char * target_, bool descend_)
+        : entries(entries_), context(context_),
+        target(target_), descend(descend_)
+    {
+    }
+  };
+
   static void
-  statusEntriesFunc(void *baton,
+  statusEntriesFunc(void *baton_,
                     const char *path,
                     svn_wc_status2_t *status)
   {
-    StatusEntries * entries = static_cast<StatusEntries *>(baton);
+    EntriesBaton * baton = static_cast<EntriesBaton *>(baton_);
+
+    rememberRepositoryInfo(baton->context, baton->target,
+                           path, status, baton->descend);
 
-    entries->push_back(Status(path, status));
+    baton->entries.push_back(Status(path, status));
   }
 
   static StatusEntries
@@ -104,13 +183,14 @@ namespace svn
     svn_revnum_t revnum;
     Revision rev(Revision::HEAD);
     Pool pool;
+    EntriesBaton baton(entries, context, path, descend);
 
     error = svn_client_status2(
               &revnum,    // revnum
               path,       // path
               rev,        // revision
               statusEntriesFunc, // status func
-              &entries,   // status baton
+              &baton,     // status baton
               descend,    // recurse
               get_all,
               update,     // need 'update' to be true to get repository lock info
@@ -179,10 +259,13 @@ namespace svn
                const char * path,
                const bool descend,
                StatusEntries & entries,
-               Context * /*context*/)
+               Context * /*context*/,
+               apr_uint32_t direntFields = SVN_DIRENT_ALL,
+               bool fetchLocks = true)
   {
     Revision rev(Revision::HEAD);
-    DirEntries dirEntries = client->list(path, rev, descend);
+    DirEntries dirEntries =
+      client->list(path, rev, descend, direntFields, fetchLocks);
     DirEntries::const_iterator it;
     svn_revnum_t revnum = 0;
 
@@ -208,6 +291,8 @@ namespace svn
                  const bool no_ignore,
                  const bool ignore_externals) throw(ClientException)
   {
+    ClientCall call(m_context, "status");
+
     if (Url::isValid(path))
     {
       StatusEntries entries;
@@ -219,6 +304,42 @@ namespace svn
                          no_ignore, m_context, ignore_externals);
   }
 
+  /**
+   * decides whether an entry with the given text and property
+   * status passes @a filter
+   */
+  static bool
+  matchesFilter(const StatusFilter & filter,
+                bool isVersioned,
+                svn_wc_status_kind textStatus,
+                svn_wc_status_kind propStatus)
+  {
+    if (!isVersioned)
+    {
+      if (svn_wc_status_ignored == textStatus)
+        return filter.showUnversioned && filter.showIgnored;
+
+      return filter.showUnversioned;
+    }
+
+    // entries without properties have no property status
+    bool isUnmodified =
+      (svn_wc_status_normal == textStatus) &&
+      ((svn_wc_status_normal == propStatus) ||
+       (svn_wc_status_none == propStatus));
+
+    if (isUnmodified)
+      return filter.showUnmodified;
+
+    // so here we know its modified.
+    // what are we interested in?
+    if (filter.showModified)
+      return true;
+
+    return filter.showConflicted &&
+           (svn_wc_status_conflicted == textStatus);
+  }
+
   struct StatusFilter;
 
   struct StatusBaton
@@ -226,9 +347,14 @@ namespace svn
 public:
     const StatusFilter & filter;
     StatusEntries & entries;
-
-    StatusBaton(const StatusFilter & filter_, StatusEntries & entries_)
-        : filter(filter_), entries(entries_)
+    Context * context;
+    const char * target;
+    bool descend;
+
+    StatusBaton(const StatusFilter & filter_, StatusEntries & entries_,
+                Context * context_, const char * target_, bool descend_)
+        : filter(filter_), entries(entries_), context(context_),
+        target(target_), descend(descend_)
     {
     }
   };
@@ -245,38 +371,12 @@ public:
     if (0 == status)
       return;
 
-    bool useStatus = false;
-
-    bool isUnversioned = 0 == status->entry;
-    if (isUnversioned)
-    { // unversioned
-      if (baton->filter.showUnversioned)
-        useStatus = true;
-    }
-    else
-    {
-      bool isUnmodified =
-        ((svn_wc_status_normal == status->text_status) &&
-         (svn_wc_status_normal == status->prop_status));
+    rememberRepositoryInfo(baton->context, baton->target,
+                           path, status, baton->descend);
 
-      if (isUnmodified)
-      {
-        if (baton->filter.showUnmodified)
-          useStatus = true;
-      }
-      else
-      {
-        // so here we know its modified.
-        // what are we interested in?
-        if (baton->filter.showModified)
-          useStatus = true;
-        else if (baton->filter.showConflicted)
-        {
-          if (svn_wc_status_conflicted == status->text_status)
-            useStatus = true;
-        }
-      }
-    }
+    bool useStatus =
+      matchesFilter(baton->filter, 0 != status->entry,
+                    status->text_status, status->prop_status);
 
     if (useStatus)
       baton->entries.push_back(Status(path, status));
@@ -294,7 +394,7 @@ public:
     svn_revnum_t revnum;
     Revision rev(Revision::HEAD);
     Pool pool;
-    StatusBaton baton(filter, entries);
+    StatusBaton baton(filter, entries, context, path, descend);
 
     error = svn_client_status2(
               &revnum,    // revnum
@@ -324,6 +424,8 @@ public:
                  const bool update,
                  StatusEntries & entries) throw(ClientException)
   {
+    ClientCall call(m_context, "status");
+
     entries.clear();
 
     if (Url::isValid(path))
@@ -341,11 +443,91 @@ public:
 
 
 
+  /**
+   * @return true if @a path is @a root or below it
+   */
+  static bool
+  isBelow(const std::string & path, const std::string & root)
+  {
+    if (path.compare(0, root.length(), root) != 0)
+      return false;
+
+    return (path.length() == root.length()) ||
+           (path[root.length()] == '/');
+  }
+
+  StatusEntries
+  Client::listStatus(const char * url,
+                     const bool descend,
+                     apr_uint32_t direntFields,
+                     bool fetchLocks) throw(ClientException)
+  {
+    ClientCall call(m_context, "listStatus");
+
+    StatusEntries entries;
+    remoteStatus(this, url, descend, entries, m_context,
+                 direntFields, fetchLocks);
+    return entries;
+  }
+
+  void
+  Client::filterStatus(const StatusFilter & filter,
+                       const StatusEntries & all,
+                       StatusPointers & entries)
+  {
+    entries.clear();
+
+    // without externals, svn reports the directories with
+    // the external definitions but doesnt descend into them
+    std::vector<std::string> externals;
+    StatusEntries::const_iterator it;
+    if (!filter.showExternals)
+    {
+      for (it = all.begin(); it != all.end(); it++)
+        if (svn_wc_status_external == it->textStatus())
+          externals.push_back(it->path());
+    }
+
+    for (it = all.begin(); it != all.end(); it++)
+    {
+      const Status & status = *it;
+
+      // like the svn crawl, decide by the presence of an entry
+      // (Status::isVersioned treats ignored and externals
+      // as versioned)
+      svn_wc_status_kind textStatus = status.textStatus();
+      bool isVersioned =
+        (svn_wc_status_none != textStatus) &&
+        (svn_wc_status_unversioned != textStatus) &&
+        (svn_wc_status_ignored != textStatus) &&
+        (svn_wc_status_external != textStatus);
+
+      if (!matchesFilter(filter, isVersioned,
+                         textStatus, status.propStatus()))
+        continue;
+
+      bool external = false;
+      if (svn_wc_status_external != status.textStatus())
+      {
+        std::vector<std::string>::const_iterator root;
+        for (root = externals.begin();
+             !external && (root != externals.end()); root++)
+          external = isBelow(status.path(), *root);
+      }
+
+      if (!external)
+        entries.push_back(&status);
+    }
+  }
+
+
   const LogEntries *
   Client::log(const char * path, const Revision & revisionStart,
               const Revision & revisionEnd, bool discoverChangedPaths,
               bool strictNodeHistory) throw(ClientException)
   {
+    ClientCall call(m_context, "log");
+
     Pool pool;
     Targets target(path);
     LogEntries * entries = new LogEntries();
@@ -379,14 +561,41 @@ public:
    * called for every entry svn_client_info wants to
    * return
    */
+  struct InfoBaton
+  {
+public:
+    InfoVector & infoVector;
+    Context * context;
+    bool isUrl;
+
+    InfoBaton(InfoVector & infoVector_, Context * context_, bool isUrl_)
+        : infoVector(infoVector_), context(context_), isUrl(isUrl_)
+    {
+    }
+  };
+
   static svn_error_t *
-  infoReceiverFunc(void * baton, const char * path,
+  infoReceiverFunc(void * baton_, const char * path,
                    const svn_info_t * info,
                    apr_pool_t * /*pool*/)
   {
-    InfoVector * infoVector = static_cast<InfoVector *>(baton);
+    InfoBaton * baton = static_cast<InfoBaton *>(baton_);
+
+    baton->infoVector.push_back(Info(path, info));
 
-    infoVector->push_back(Info(path, info));
+    if ((baton->context != 0) && !isEmpty(info->repos_root_URL) &&
+        !isEmpty(info->URL))
+    {
+      RepositoryInfo reposInfo;
+      reposInfo.url = info->URL;
+      reposInfo.root = info->repos_root_URL;
+      if (info->repos_UUID != 0)
+        reposInfo.uuid = info->repos_UUID;
+
+      // for urls svn passes only the name of the entry
+      baton->context->cacheRepositoryInfo(
+        baton->isUrl ? info->URL : path, reposInfo);
+    }
 
     return 0;
   }
@@ -398,15 +607,18 @@ public:
                const Revision & revision,
                const Revision & pegRevision) throw(ClientException)
   {
+    ClientCall call(m_context, "info");
+
     Pool pool;
     InfoVector infoVector;
+    InfoBaton baton(infoVector, m_context, pathOrUrl.isUrl());
 
     svn_error_t * error =
       svn_client_info(pathOrUrl.c_str(),
                       pegRevision.revision(),
                       revision.revision(),
                       infoReceiverFunc,
-                      &infoVector,
+                      &baton,
                       recurse,
                       *m_context,
                       pool);
@@ -417,6 +629,32 @@ public:
     return infoVector;
   }
 
+
+  RepositoryInfo
+  Client::repositoryInfo(const Path & pathOrUrl) throw(ClientException)
+  {
+    ClientCall call(m_context, "repositoryInfo");
+
+    RepositoryInfo reposInfo;
+
+    if ((m_context != 0) &&
+        m_context->findRepositoryInfo(pathOrUrl.c_str(), reposInfo) &&
+        !reposInfo.url.empty())
+      return reposInfo;
+
+    // not known yet: info will remember it for the next time
+    InfoVector infoVector(info(pathOrUrl));
+    if (infoVector.empty())
+      return RepositoryInfo();
+
+    const Info & first = infoVector[0];
+    reposInfo.url = first.url() ? first.url() : "";
+    reposInfo.root = first.repos() ? first.repos() : "";
+    reposInfo.uuid = first.uuid() ? first.uuid() : "";
+
+    return reposInfo;
+  }
+
 }
 
 /* -----------------------------------------------------------------
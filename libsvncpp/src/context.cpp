@@ -37,12 +37,23 @@
  */
 
 
+// stl
+#include <algorithm>
+#include <list>
+#include "svncpp/map_wrapper.hpp"
+#include "svncpp/vector_wrapper.hpp"
+
 // Apache Portable Runtime
+#include "apr_file_info.h"
+#include "apr_hash.h"
+#include "apr_thread_mutex.h"
+#include "apr_time.h"
 #include "apr_xlate.h"
 
 // Subversion api
 #include "svn_auth.h"
 #include "svn_config.h"
+#include "svn_ra.h"
 #include "svn_subst.h"
 //#include "svn_utf.h"
 
@@ -50,9 +61,333 @@
 #include "svncpp/apr.hpp"
 #include "svncpp/context.hpp"
 #include "svncpp/context_listener.hpp"
+#include "svncpp/url.hpp"
 
 namespace svn
 {
+  /**
+   * upper limit for the number of paths remembered by
+   * Context::cacheRepositoryInfo. If it is reached the least
+   * recently used quarter of the paths is dropped (the known
+   * repository roots are kept).
+   */
+  static const size_t MAX_REPOSITORY_INFOS = 10000;
+
+  /** default number of idle ra sessions kept by a context */
+  static const size_t DEFAULT_MAX_SESSIONS = 4;
+
+  /** default time after which idle ra sessions are closed */
+  static const int DEFAULT_SESSION_IDLE_SECONDS = 120;
+
+  /**
+   * locks an apr mutex for the lifetime of the object
+   */
+  struct MutexLock
+  {
+#if APR_HAS_THREADS
+    apr_thread_mutex_t * mutex;
+
+    MutexLock(apr_thread_mutex_t * mutex_) : mutex(mutex_)
+    {
+      apr_thread_mutex_lock(mutex);
+    }
+
+    ~MutexLock()
+    {
+      apr_thread_mutex_unlock(mutex);
+    }
+#endif
+  };
+
+  /**
+   * The parsed subversion configuration of a configuration
+   * directory. Reading and parsing the files is expensive,
+   * so all the contexts for the same directory share one
+   * reference-counted snapshot. A new snapshot is loaded
+   * only if the configuration files change on disk.
+   *
+   * svn_config_get expands values lazily and allocates the
+   * result in the pool of the configuration. So every option
+   * is expanded once while loading; later reads from other
+   * threads only find the expanded values then.
+   */
+  class ConfigSnapshot
+  {
+  public:
+    /**
+     * get the current snapshot for @a configDir, loading
+     * it if necessary. Give it back with release.
+     */
+    static ConfigSnapshot *
+    acquire(const std::string & configDir);
+
+    /**
+     * give back a snapshot retrieved by acquire
+     */
+    void
+    release();
+
+    /**
+     * @return hash with the configuration, as expected in
+     *         svn_client_ctx_t::config
+     */
+    apr_hash_t *
+    config() const
+    {
+      return m_config;
+    }
+
+    struct Registry;
+    static Registry & registry();
+
+  private:
+    /** keeps apr alive as long as the pool exists */
+    Apr m_apr;
+    Pool m_pool;
+    apr_hash_t * m_config;
+    apr_time_t m_stamp;
+
+    /** number of users, the registry counts as one */
+    int m_refs;
+
+    ConfigSnapshot(const std::string & configDir, apr_time_t stamp);
+
+    /**
+     * expands every option of every configuration
+     * category in @a m_config
+     */
+    void
+    expand();
+
+    static svn_boolean_t
+    expandSection(const char * name, void * baton, apr_pool_t * pool);
+
+    static svn_boolean_t
+    expandOption(const char * name, const char * value,
+                 void * baton, apr_pool_t * pool);
+
+    /**
+     * @return the newest modification time of the user
+     *         configuration files in @a configDir
+     */
+    static apr_time_t
+    stamp(const char * configDir, apr_pool_t * pool);
+  };
+
+  /**
+   * the current snapshot of every configuration directory
+   */
+  struct ConfigSnapshot::Registry
+  {
+    typedef std::map<std::string, ConfigSnapshot *> SnapshotMap;
+
+    Apr apr;
+    Pool pool;
+    SnapshotMap current;
+#if APR_HAS_THREADS
+    apr_thread_mutex_t * mutex;
+#endif
+
+    Registry()
+    {
+#if APR_HAS_THREADS
+      apr_thread_mutex_create(&mutex, APR_THREAD_MUTEX_DEFAULT, pool);
+#endif
+    }
+
+    ~Registry()
+    {
+      SnapshotMap::iterator it;
+      for (it = current.begin(); it != current.end(); it++)
+      {
+        // contexts still using it keep it alive
+        if (--it->second->m_refs == 0)
+          delete it->second;
+      }
+    }
+  };
+
+  ConfigSnapshot::Registry &
+  ConfigSnapshot::registry()
+  {
+    // created along with the first context, before
+    // the application starts any worker thread
+    static Registry registry;
+
+    return registry;
+  }
+
+  ConfigSnapshot::ConfigSnapshot(const std::string & configDir,
+                                 apr_time_t stamp)
+      : m_config(0), m_stamp(stamp), m_refs(0)
+  {
+    const char * c_configDir = 0;
+    if (configDir.length() > 0)
+      c_configDir = configDir.c_str();
+
+    // make sure the configuration directory exists
+    svn_error_clear(svn_config_ensure(c_configDir, m_pool));
+
+    svn_error_clear(svn_config_get_config(&m_config, c_configDir, m_pool));
+
+    expand();
+  }
+
+  /**
+   * baton for ConfigSnapshot::expandSection and
+   * ConfigSnapshot::expandOption
+   */
+  struct ExpandBaton
+  {
+    svn_config_t * cfg;
+    const char * section;
+  };
+
+  void
+  ConfigSnapshot::expand()
+  {
+    if (m_config == 0)
+      return;
+
+    Pool scratchPool;
+    apr_hash_index_t * hi;
+    for (hi = apr_hash_first(scratchPool, m_config); hi; hi = apr_hash_next(hi))
+    {
+      void * val;
+      apr_hash_this(hi, NULL, NULL, &val);
+
+      ExpandBaton baton;
+      baton.cfg = static_cast<svn_config_t *>(val);
+      baton.section = 0;
+
+      svn_config_enumerate_sections2(baton.cfg, expandSection,
+                                     &baton, scratchPool);
+    }
+  }
+
+  svn_boolean_t
+  ConfigSnapshot::expandSection(const char * name, void * baton,
+                                apr_pool_t * pool)
+  {
+    ExpandBaton * expandBaton = static_cast<ExpandBaton *>(baton);
+    expandBaton->section = name;
+
+    svn_config_enumerate2(expandBaton->cfg, name, expandOption,
+                          baton, pool);
+
+    return TRUE;
+  }
+
+  svn_boolean_t
+  ConfigSnapshot::expandOption(const char * name, const char * /*value*/,
+                               void * baton, apr_pool_t * /*pool*/)
+  {
+    ExpandBaton * expandBaton = static_cast<ExpandBaton *>(baton);
+
+    // svn_config_enumerate2 expands into its own pool,
+    // svn_config_get stores the expanded value
+    const char * value = 0;
+    svn_config_get(expandBaton->cfg, &value,
+                   expandBaton->section, name, NULL);
+
+    return TRUE;
+  }
+
+  apr_time_t
+  ConfigSnapshot::stamp(const char * configDir, apr_pool_t * pool)
+  {
+    static const char * files [] =
+    {
+      SVN_CONFIG_CATEGORY_CONFIG,
+      SVN_CONFIG_CATEGORY_SERVERS
+    };
+    apr_time_t result = 0;
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++)
+    {
+      const char * path = NULL;
+      svn_error_t * error =
+        svn_config_get_user_config_path(&path, configDir, files[i], pool);
+      if (error != NULL)
+      {
+        svn_error_clear(error);
+        continue;
+      }
+
+      apr_finfo_t finfo;
+      if ((path != NULL) &&
+          (apr_stat(&finfo, path, APR_FINFO_MTIME, pool) == APR_SUCCESS) &&
+          (finfo.mtime > result))
+        result = finfo.mtime;
+    }
+
+    return result;
+  }
+
+  ConfigSnapshot *
+  ConfigSnapshot::acquire(const std::string & configDir)
+  {
+    const char * c_configDir = 0;
+    if (configDir.length() > 0)
+      c_configDir = configDir.c_str();
+
+    Registry & reg = registry();
+    Pool pool;
+    apr_time_t newStamp = stamp(c_configDir, pool);
+
+    {
+#if APR_HAS_THREADS
+      MutexLock lock(reg.mutex);
+#endif
+
+      Registry::SnapshotMap::iterator it = reg.current.find(configDir);
+      if ((it != reg.current.end()) && (it->second->m_stamp == newStamp))
+      {
+        it->second->m_refs++;
+        return it->second;
+      }
+    }
+
+    // parse without holding the lock, this might take a while
+    ConfigSnapshot * loaded = new ConfigSnapshot(configDir, newStamp);
+
+#if APR_HAS_THREADS
+    MutexLock lock(reg.mutex);
+#endif
+
+    ConfigSnapshot *& current = reg.current[configDir];
+    if ((current != 0) && (current->m_stamp == newStamp))
+    {
+      // another context loaded the same files meanwhile
+      delete loaded;
+    }
+    else
+    {
+      // changed on disk, contexts still using the
+      // old snapshot keep it alive
+      if ((current != 0) && (--current->m_refs == 0))
+        delete current;
+
+      current = loaded;
+      current->m_refs = 1;
+    }
+
+    current->m_refs++;
+    return current;
+  }
+
+  void
+  ConfigSnapshot::release()
+  {
+    Registry & reg = registry();
+#if APR_HAS_THREADS
+    MutexLock lock(reg.mutex);
+#endif
+
+    if (--m_refs == 0)
+      delete this;
+  }
+
   struct Context::Data
   {
 public:
@@ -71,6 +406,109 @@ public:
     std::string logMessage;
     std::string configDir;
 
+    /** remembered repository information of a single path */
+    struct RepositoryInfoEntry
+    {
+      RepositoryInfo info;
+      bool childrenKnown;
+
+      /** value of reposUseCount when last used */
+      size_t lastUse;
+    };
+
+    typedef std::map<std::string, RepositoryInfoEntry> RepositoryInfoMap;
+    typedef std::map<std::string, std::string> RepositoryRootMap;
+
+    /** path or url -> repository information */
+    RepositoryInfoMap reposInfos;
+
+    /** repository root -> uuid */
+    RepositoryRootMap reposRoots;
+
+    /** counts the uses of reposInfos, for the eviction */
+    size_t reposUseCount;
+
+#if APR_HAS_THREADS
+    /**
+     * the repository information is filled in by the worker
+     * thread and read by the gui, so it needs protection
+     */
+    apr_thread_mutex_t * reposMutex;
+#endif
+
+    /** an open ra session together with the pool it lives in */
+    struct PooledSession
+    {
+      svn_ra_session_t * session;
+      Pool * pool;
+      std::string root;
+      apr_time_t lastUsed;
+      bool inUse;
+
+      /** closed on release, see flushSessions */
+      bool flushed;
+    };
+
+    typedef std::list<PooledSession> PooledSessionList;
+
+    /** open ra sessions, see Context::acquireSession */
+    PooledSessionList sessions;
+    size_t maxSessions;
+    int sessionIdleSeconds;
+    size_t sessionHits;
+    size_t sessionMisses;
+
+#if APR_HAS_THREADS
+    apr_thread_mutex_t * sessionMutex;
+#endif
+
+    /** see Context::getStatistics */
+    ContextStatistics statistics;
+
+    /**
+     * the last value passed to onProgress. The progress is
+     * counted per ra session, so a value smaller than this
+     * belongs to a new session
+     */
+    apr_off_t lastProgress;
+
+#if APR_HAS_THREADS
+    apr_thread_mutex_t * statisticsMutex;
+#endif
+
+    /** locks the repository information */
+    struct ReposLock : public MutexLock
+    {
+#if APR_HAS_THREADS
+      ReposLock(Data & data) : MutexLock(data.reposMutex) {}
+#else
+      ReposLock(Data &) {}
+#endif
+    };
+
+    /** locks the session pool */
+    struct SessionLock : public MutexLock
+    {
+#if APR_HAS_THREADS
+      SessionLock(Data & data) : MutexLock(data.sessionMutex) {}
+#else
+      SessionLock(Data &) {}
+#endif
+    };
+
+    /** locks the statistics */
+    struct StatisticsLock : public MutexLock
+    {
+#if APR_HAS_THREADS
+      StatisticsLock(Data & data) : MutexLock(data.statisticsMutex) {}
+#else
+      StatisticsLock(Data &) {}
+#endif
+    };
+
+    /** the configuration of this context, see ConfigSnapshot */
+    ConfigSnapshot * config;
+
     /**
      * the @a baton is interpreted as Data *
      * Several checks are performed on the baton:
@@ -102,14 +540,16 @@ public:
 
     Data(const std::string & configDir_)
         : listener(0), logIsSet(false),
-        promptCounter(0), configDir(configDir_)
+        promptCounter(0), configDir(configDir_), reposUseCount(0),
+        maxSessions(DEFAULT_MAX_SESSIONS),
+        sessionIdleSeconds(DEFAULT_SESSION_IDLE_SECONDS),
+        sessionHits(0), sessionMisses(0), lastProgress(0)
     {
       const char * c_configDir = 0;
       if (configDir.length() > 0)
         c_configDir = configDir.c_str();
 
-      // make sure the configuration directory exists
-      svn_config_ensure(c_configDir, pool);
+      config = ConfigSnapshot::acquire(configDir);
 
 
       // intialize authentication providers
@@ -182,8 +622,8 @@ public:
       // initialize ctx structure
       svn_client_create_context(&ctx, pool);
 
-      // get the config based on the configDir passed in
-      svn_config_get_config(&ctx->config, c_configDir, pool);
+      // use the config based on the configDir passed in
+      ctx->config = config->config();
 
       // tell the auth functions where the config is
       svn_auth_set_parameter(ab, SVN_AUTH_PARAM_CONFIG_DIR,
@@ -196,10 +636,215 @@ public:
       ctx->notify_baton2 = this;
       ctx->cancel_func = onCancel;
       ctx->cancel_baton = this;
+      ctx->progress_func = onProgress;
+      ctx->progress_baton = this;
+
+#if APR_HAS_THREADS
+      apr_thread_mutex_create(&reposMutex, APR_THREAD_MUTEX_DEFAULT, pool);
+      apr_thread_mutex_create(&sessionMutex, APR_THREAD_MUTEX_DEFAULT, pool);
+      apr_thread_mutex_create(&statisticsMutex, APR_THREAD_MUTEX_DEFAULT,
+                              pool);
+#endif
+    }
+
+    ~Data()
+    {
+      PooledSessionList::iterator it;
+      for (it = sessions.begin(); it != sessions.end(); it++)
+        delete it->pool;
+
+      config->release();
+    }
+
+    /**
+     * close idle sessions that are too old and, if there
+     * are still too many, the least recently used ones.
+     * The session lock has to be held.
+     */
+    void
+    trimSessions()
+    {
+      apr_time_t now = apr_time_now();
+      apr_time_t maxIdle = apr_time_from_sec(sessionIdleSeconds);
+      size_t idle = 0;
+
+      PooledSessionList::iterator it = sessions.begin();
+      while (it != sessions.end())
+      {
+        if (!it->inUse && ((now - it->lastUsed) > maxIdle))
+        {
+          delete it->pool;
+          it = sessions.erase(it);
+        }
+        else
+        {
+          if (!it->inUse)
+            idle++;
+          it++;
+        }
+      }
+
+      // sessions are appended when released, so the
+      // least recently used come first
+      it = sessions.begin();
+      while ((idle > maxSessions) && (it != sessions.end()))
+      {
+        if (!it->inUse)
+        {
+          delete it->pool;
+          it = sessions.erase(it);
+          idle--;
+        }
+        else
+          it++;
+      }
+    }
+
+    /** @see Context::acquireSession */
+    svn_ra_session_t *
+    acquireSession(const char * url)
+    {
+      RepositoryInfo info;
+      findRepositoryInfo(url, info);
+
+      {
+        SessionLock lock(*this);
+        trimSessions();
+
+        PooledSessionList::iterator it = sessions.begin();
+        while (!info.root.empty() && (it != sessions.end()))
+        {
+          if (it->inUse || (it->root != info.root))
+          {
+            it++;
+            continue;
+          }
+
+          // the session pool lives as long as the session,
+          // dont let it grow with every reuse
+          Pool scratchPool;
+          svn_error_t * error =
+            svn_ra_reparent(it->session, url, scratchPool);
+          if (error != NULL)
+          {
+            // dont try this one again
+            svn_error_clear(error);
+            delete it->pool;
+            it = sessions.erase(it);
+            continue;
+          }
+
+          it->inUse = true;
+          sessionHits++;
+          return it->session;
+        }
+
+        sessionMisses++;
+      }
+
+      // open the new session without holding the lock,
+      // this might take a while
+      Pool * sessionPool = new Pool();
+      svn_ra_session_t * session = NULL;
+      const char * root = NULL;
+      const char * uuid = NULL;
+
+      svn_error_t * error =
+        svn_client_open_ra_session(&session, url, ctx, *sessionPool);
+      if (error == NULL)
+        error = svn_ra_get_repos_root(session, &root, *sessionPool);
+      if (error == NULL)
+        error = svn_ra_get_uuid(session, &uuid, *sessionPool);
+
+      if (error != NULL)
+      {
+        delete sessionPool;
+        throw ClientException(error);
+      }
+
+      PooledSession pooled;
+      pooled.session = session;
+      pooled.pool = sessionPool;
+      pooled.root = root;
+      pooled.lastUsed = apr_time_now();
+      pooled.inUse = true;
+      pooled.flushed = false;
+
+      {
+        SessionLock lock(*this);
+        sessions.push_back(pooled);
+      }
+
+      info.url = url;
+      info.root = root;
+      info.uuid = uuid;
+      cacheRepositoryInfo(url, info, false);
+
+      return session;
+    }
+
+    /** @see Context::releaseSession */
+    void
+    releaseSession(svn_ra_session_t * session, bool reuse)
+    {
+      SessionLock lock(*this);
+
+      PooledSessionList::iterator it;
+      for (it = sessions.begin(); it != sessions.end(); it++)
+      {
+        if (it->session != session)
+          continue;
+
+        if (reuse && !it->flushed)
+        {
+          PooledSession pooled = *it;
+          pooled.inUse = false;
+          pooled.lastUsed = apr_time_now();
+          sessions.erase(it);
+          sessions.push_back(pooled);
+        }
+        else
+        {
+          delete it->pool;
+          sessions.erase(it);
+        }
+        break;
+      }
+
+      trimSessions();
+    }
+
+    /**
+     * close the idle sessions and make sure the ones in use
+     * are closed when they are given back. Has to be called
+     * whenever the authentication changes, the sessions
+     * keep the credentials they were opened with.
+     */
+    void
+    flushSessions()
+    {
+      SessionLock lock(*this);
+
+      PooledSessionList::iterator it = sessions.begin();
+      while (it != sessions.end())
+      {
+        if (it->inUse)
+        {
+          it->flushed = true;
+          it++;
+        }
+        else
+        {
+          delete it->pool;
+          it = sessions.erase(it);
+        }
+      }
     }
 
     void setAuthCache(bool value)
     {
+      flushSessions();
+
       void *param = 0;
       if (!value)
         param = (void *)"1";
@@ -212,6 +857,8 @@ public:
     /** @see Context::setLogin */
     void setLogin(const char * usr, const char * pwd)
     {
+      flushSessions();
+
       username = usr;
       password = pwd;
 
@@ -223,6 +870,159 @@ public:
 
     }
 
+    /** @see Context::cacheRepositoryInfo */
+    void
+    cacheRepositoryInfo(const std::string & key,
+                        const RepositoryInfo & info,
+                        bool childrenKnown)
+    {
+      ReposLock lock(*this);
+
+      RepositoryInfoMap::iterator it = reposInfos.find(key);
+      if ((it == reposInfos.end()) &&
+          (reposInfos.size() >= MAX_REPOSITORY_INFOS))
+        evictRepositoryInfos();
+
+      if (info.root.empty())
+      {
+        // only mark the path as unknown if we dont know better
+        if (it == reposInfos.end())
+        {
+          RepositoryInfoEntry entry;
+          entry.childrenKnown = false;
+          entry.lastUse = ++reposUseCount;
+          reposInfos.insert(RepositoryInfoMap::value_type(key, entry));
+        }
+        return;
+      }
+
+      if (it == reposInfos.end())
+      {
+        RepositoryInfoEntry entry;
+        entry.info = info;
+        entry.childrenKnown = childrenKnown;
+        entry.lastUse = ++reposUseCount;
+        reposInfos.insert(RepositoryInfoMap::value_type(key, entry));
+      }
+      else
+      {
+        it->second.lastUse = ++reposUseCount;
+        // a plain info call doesnt make the children unknown
+        // as long as the url stays the same
+        it->second.childrenKnown = childrenKnown ||
+                                   (it->second.childrenKnown &&
+                                    it->second.info.url == info.url);
+        it->second.info = info;
+      }
+
+      std::string & uuid = reposRoots[info.root];
+      if (!info.uuid.empty())
+        uuid = info.uuid;
+    }
+
+    /**
+     * drop the least recently used quarter of the remembered
+     * paths. The repository lock has to be held.
+     */
+    void
+    evictRepositoryInfos()
+    {
+      std::vector<size_t> uses;
+      uses.reserve(reposInfos.size());
+
+      RepositoryInfoMap::iterator it;
+      for (it = reposInfos.begin(); it != reposInfos.end(); it++)
+        uses.push_back(it->second.lastUse);
+
+      std::vector<size_t>::iterator limit = uses.begin() + uses.size() / 4;
+      std::nth_element(uses.begin(), limit, uses.end());
+
+      it = reposInfos.begin();
+      while (it != reposInfos.end())
+      {
+        if (it->second.lastUse <= *limit)
+          reposInfos.erase(it++);
+        else
+          it++;
+      }
+    }
+
+    /** @see Context::findRepositoryInfo */
+    bool
+    findRepositoryInfo(const std::string & key, RepositoryInfo & info)
+    {
+      ReposLock lock(*this);
+
+      RepositoryInfoMap::iterator it = reposInfos.find(key);
+      if (it != reposInfos.end())
+      {
+        it->second.lastUse = ++reposUseCount;
+        info = it->second.info;
+        return !info.root.empty();
+      }
+
+      if (Url::isValid(key.c_str()))
+      {
+        // every url below a known root belongs to this repository
+        RepositoryRootMap::const_iterator root;
+        for (root = reposRoots.begin(); root != reposRoots.end(); root++)
+        {
+          const std::string & rootUrl = root->first;
+          size_t len = rootUrl.length();
+
+          if ((key.compare(0, len, rootUrl) == 0) &&
+              ((key.length() == len) || (key[len] == '/')))
+          {
+            info.url = key;
+            info.root = rootUrl;
+            info.uuid = root->second;
+            return true;
+          }
+        }
+        return false;
+      }
+
+      // working copy paths share the repository with their
+      // parent directory
+      std::string::size_type pos = key.rfind('/');
+      if ((pos == std::string::npos) || (pos == 0))
+        return false;
+
+      it = reposInfos.find(key.substr(0, pos));
+      if (it == reposInfos.end())
+        return false;
+
+      RepositoryInfoEntry & parent = it->second;
+      if (parent.info.root.empty())
+        return false;
+
+      parent.lastUse = ++reposUseCount;
+
+      info.root = parent.info.root;
+      info.uuid = parent.info.uuid;
+
+      // the url can only be derived if we know the child
+      // hasnt been switched
+      if (parent.childrenKnown && !parent.info.url.empty())
+      {
+        info.url = parent.info.url + "/" +
+                   Url::escape(key.substr(pos + 1).c_str());
+      }
+      else
+        info.url = "";
+
+      return true;
+    }
+
+    /** @see Context::clearRepositoryInfo */
+    void
+    clearRepositoryInfo()
+    {
+      ReposLock lock(*this);
+
+      reposInfos.clear();
+    }
+
     /** @see Context::setLogMessage */
     void setLogMessage(const char * msg)
     {
@@ -289,6 +1089,41 @@ public:
     }
 
 
+    /**
+     * this is the callback function for the repository
+     * access layer to signal the bytes transferred so far
+     *
+     * @since subversion 1.3
+     */
+    static void
+    onProgress(apr_off_t progress, apr_off_t total,
+               void * baton, apr_pool_t *)
+    {
+      Data * data = static_cast <Data *>(baton);
+      apr_off_t transferred;
+
+      {
+        StatisticsLock lock(*data);
+
+        if (progress >= data->lastProgress)
+          data->statistics.bytesTransferred += progress - data->lastProgress;
+        else
+          data->statistics.bytesTransferred += progress;
+
+        data->lastProgress = progress;
+        transferred = data->statistics.bytesTransferred;
+      }
+
+      if (data->listener != 0)
+      {
+        apr_off_t remaining = -1;
+        if (total >= progress)
+          remaining = total - progress;
+
+        data->listener->contextProgress(transferred, remaining);
+      }
+    }
+
     /**
      * this is the callback function for the subversion
      * api functions to signal the progress of an action
@@ -407,6 +1242,8 @@ public:
       if (!data->listener->contextSslClientCertPrompt(certFile))
         return svn_error_create(SVN_ERR_CANCELLED, NULL, "");
 
+      data->promptCounter++;
+
       svn_auth_cred_ssl_client_cert_t *cred_ =
         (svn_auth_cred_ssl_client_cert_t*)
         apr_palloc(pool, sizeof(svn_auth_cred_ssl_client_cert_t));
@@ -441,6 +1278,8 @@ public:
       if (!data->listener->contextSslClientCertPwPrompt(password, realm, may_save))
         return svn_error_create(SVN_ERR_CANCELLED, NULL, "");
 
+      data->promptCounter++;
+
       svn_auth_cred_ssl_client_cert_pw_t *cred_ =
         (svn_auth_cred_ssl_client_cert_pw_t *)
         apr_palloc(pool, sizeof(svn_auth_cred_ssl_client_cert_pw_t));
@@ -531,6 +1370,8 @@ public:
         username = username_;
 
       ok = listener->contextGetLogin(realm, username, password, may_save);
+      if (ok)
+        promptCounter++;
 
       return ok;
     }
@@ -550,6 +1391,11 @@ public:
     {
       if (listener != 0)
       {
+        {
+          StatisticsLock lock(*this);
+          statistics.notifications++;
+        }
+
         listener->contextNotify(path, action, kind, mime_type,
                                 content_state, prop_state, revision);
       }
@@ -649,12 +1495,101 @@ public:
     return m->listener;
   }
 
+  void
+  Context::cacheRepositoryInfo(const char * pathOrUrl,
+                               const RepositoryInfo & info,
+                               bool childrenKnown)
+  {
+    m->cacheRepositoryInfo(pathOrUrl, info, childrenKnown);
+  }
+
+  bool
+  Context::findRepositoryInfo(const char * pathOrUrl,
+                              RepositoryInfo & info) const
+  {
+    return m->findRepositoryInfo(pathOrUrl, info);
+  }
+
+  void
+  Context::clearRepositoryInfo()
+  {
+    m->clearRepositoryInfo();
+  }
+
+  svn_ra_session_t *
+  Context::acquireSession(const char * url) throw(ClientException)
+  {
+    return m->acquireSession(url);
+  }
+
+  void
+  Context::releaseSession(svn_ra_session_t * session, bool reuse)
+  {
+    m->releaseSession(session, reuse);
+  }
+
+  void
+  Context::setSessionPoolLimits(size_t maxSessions, int idleSeconds)
+  {
+    Data::SessionLock lock(*m);
+
+    m->maxSessions = maxSessions;
+    m->sessionIdleSeconds = idleSeconds;
+    m->trimSessions();
+  }
+
+  size_t
+  Context::getSessionPoolHits() const
+  {
+    Data::SessionLock lock(*m);
+
+    return m->sessionHits;
+  }
+
+  size_t
+  Context::getSessionPoolMisses() const
+  {
+    Data::SessionLock lock(*m);
+
+    return m->sessionMisses;
+  }
+
   void
   Context::reset()
   {
+    // the pooled sessions might use other credentials
+    // than the ones entered in the last action
+    if (m->promptCounter > 0)
+      m->flushSessions();
+
     m->promptCounter = 0;
     m->logIsSet = false;
   }
+
+  void
+  Context::countCall(const char * name)
+  {
+    Data::StatisticsLock lock(*m);
+
+    m->statistics.calls[name]++;
+  }
+
+  ContextStatistics
+  Context::getStatistics() const
+  {
+    Data::StatisticsLock lock(*m);
+
+    return m->statistics;
+  }
+
+  void
+  Context::resetStatistics()
+  {
+    Data::StatisticsLock lock(*m);
+
+    m->statistics = ContextStatistics();
+    m->lastProgress = 0;
+  }
 }
 
 /* -----------------------------------------------------------------
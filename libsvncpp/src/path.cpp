@@ -48,28 +48,103 @@ namespace svn
   }
 
   Path::Path(const Path & path)
+      : m_path(path.m_path), m_pathIsUrl(path.m_pathIsUrl)
   {
-    init(path.c_str());
+  }
+
+  /**
+   * checks whether @a path is in canonical internal style
+   * already, so svn_path_internal_style would return it
+   * unchanged. The check is conservative: anything unusual
+   * is left to subversion.
+   *
+   * @param path
+   * @param isUrl is @a path an url?
+   */
+  static bool
+  isCanonical(const char * path, bool isUrl)
+  {
+    const unsigned char * p = reinterpret_cast<const unsigned char *>(path);
+    size_t start = 0;
+
+    if (isUrl)
+    {
+      // scheme and host have to be lower case, and
+      // we only deal with ascii urls
+      const unsigned char * c = p;
+      for (; (*c != 0) && (*c != ':'); c++)
+      {
+        if ((*c >= 'A') && (*c <= 'Z'))
+          return false;
+      }
+
+      // skip "://"
+      start = (c - p) + 3;
+      for (c = p + start; (*c != 0) && (*c != '/'); c++)
+      {
+        if (((*c >= 'A') && (*c <= 'Z')) || (*c >= 0x80))
+          return false;
+      }
+    }
+
+    size_t i = start;
+    for (; p[i] != 0; i++)
+    {
+      unsigned char c = p[i];
+
+      if ((SVN_PATH_LOCAL_SEPARATOR != '/') &&
+          (c == SVN_PATH_LOCAL_SEPARATOR))
+        return false;
+
+      if (isUrl && (c >= 0x80))
+        return false;
+
+      bool segmentStart = (i == start) || (p[i - 1] == '/');
+      if (c == '/')
+      {
+        // no empty segments
+        if ((i > start) && (p[i - 1] == '/'))
+          return false;
+      }
+      else if ((c == '.') && segmentStart &&
+               ((p[i + 1] == '/') || (p[i + 1] == 0)))
+      {
+        // no "." segments
+        return false;
+      }
+    }
+
+    // no trailing separator, except for the root itself
+    if ((i > start) && (p[i - 1] == '/') && (isUrl || (i > 1)))
+      return false;
+
+    return true;
   }
 
   void
   Path::init(const char * path)
   {
-    Pool pool;
-
     m_pathIsUrl = false;
 
     if (path == 0)
       m_path = "";
     else
     {
+      m_pathIsUrl = Url::isValid(path);
+
+      // most paths we get are canonical already
+      if (isCanonical(path, m_pathIsUrl))
+      {
+        m_path = path;
+        return;
+      }
+
+      Pool pool;
       const char * int_path =
         svn_path_internal_style(path, pool.pool());
 
       m_path = int_path;
-
-      if (svn::Url::isValid(int_path))
-        m_pathIsUrl = true;
+      m_pathIsUrl = Url::isValid(int_path);
     }
   }
 
@@ -91,7 +166,8 @@ namespace svn
     if (this == &path)
       return *this;
 
-    init(path.c_str());
+    m_path = path.m_path;
+    m_pathIsUrl = path.m_pathIsUrl;
 
     return *this;
   }
@@ -22,6 +22,24 @@
  * ====================================================================
  */
 
+// stl
+#include "svncpp/vector_wrapper.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+// Apache Portable Runtime
+#include "apr_allocator.h"
+#include "apr_thread_mutex.h"
+#include "apr_thread_proc.h"
+
 // svncpp
 #include "svncpp/pool.hpp"
 
@@ -31,19 +49,266 @@
  */
 namespace svn
 {
+  /** number of cleared pools every thread keeps for reuse */
+  static const size_t MAX_FREE_POOLS = 16;
+
+  /** memory an allocator keeps for reuse, in bytes */
+  static const apr_size_t MAX_FREE_MEMORY = 2 * 1024 * 1024;
+
+  /** key of the ThreadPools in the user data of its root */
+  static const char * THREAD_POOLS_KEY = "svncpp:thread-pools";
+
+  /**
+   * The top level pools of a thread. They are created as
+   * children of @a root, which has an allocator of its own,
+   * so threads don't compete for the global allocator.
+   * Instead of destroying them they are cleared and kept in
+   * @a freePools for the next Pool of the same thread.
+   *
+   * Pools can be handed to other threads (think of Status
+   * entries passed to the gui), so the allocator has a mutex
+   * anyhow, it is just hardly ever contended. For the same
+   * reason @a root can't be destroyed when the thread ends:
+   * @a refs counts the thread itself and every pool handed
+   * out, whoever drops the last reference destroys it.
+   */
+  struct ThreadPools
+  {
+    apr_allocator_t * allocator;
+    apr_pool_t * root;
+    std::vector<apr_pool_t *> freePools;
+
+    /** protected by the mutex of @a allocator */
+    size_t refs;
+
+    ThreadPools() : refs(1)
+    {
+      apr_allocator_create(&allocator);
+      apr_allocator_max_free_set(allocator, MAX_FREE_MEMORY);
+      apr_pool_create_ex(&root, NULL, NULL, allocator);
+
+      // destroying the root destroys the allocator as well
+      apr_allocator_owner_set(allocator, root);
+      apr_pool_userdata_setn(this, THREAD_POOLS_KEY, NULL, root);
+
+#if APR_HAS_THREADS
+      apr_thread_mutex_t * mutex;
+      apr_thread_mutex_create(&mutex, APR_THREAD_MUTEX_DEFAULT, root);
+      apr_allocator_mutex_set(allocator, mutex);
+#endif
+    }
+
+    ~ThreadPools()
+    {
+      apr_pool_destroy(root);
+    }
+
+    /**
+     * @return the ThreadPools @a pool was taken from,
+     *         0 if it is no top level pool
+     */
+    static ThreadPools *
+    owner(apr_pool_t * pool)
+    {
+      apr_pool_t * parent = apr_pool_parent_get(pool);
+      if (parent == 0)
+        return 0;
+
+      void * data = 0;
+      apr_pool_userdata_get(&data, THREAD_POOLS_KEY, parent);
+      return static_cast<ThreadPools *>(data);
+    }
+
+    void
+    addRef()
+    {
+      lock();
+      refs++;
+      unlock();
+    }
+
+    /**
+     * drops a reference, the last one deletes this
+     */
+    void
+    release()
+    {
+      lock();
+      bool last = --refs == 0;
+      unlock();
+
+      if (last)
+        delete this;
+    }
+
+    void
+    lock()
+    {
+#if APR_HAS_THREADS
+      apr_thread_mutex_lock(apr_allocator_mutex_get(allocator));
+#endif
+    }
+
+    void
+    unlock()
+    {
+#if APR_HAS_THREADS
+      apr_thread_mutex_unlock(apr_allocator_mutex_get(allocator));
+#endif
+    }
+
+    /**
+     * called when the thread is done with the pools:
+     * the free pools go away, the pools still in use
+     * keep the rest alive
+     */
+    void
+    threadDone()
+    {
+      std::vector<apr_pool_t *>::iterator it;
+      for (it = freePools.begin(); it != freePools.end(); it++)
+        apr_pool_destroy(*it);
+      freePools.clear();
+
+      release();
+    }
+  };
+
   static bool m_initialized = false;
 
+  /**
+   * pool statistics. These are only used for measurements,
+   * so they are not locked: with several threads creating
+   * pools at once the numbers are approximate.
+   */
+  static volatile size_t m_createdCount = 0;
+  static volatile size_t m_reusedCount = 0;
+
+#if APR_HAS_THREADS
+  static apr_threadkey_t * m_threadKey = 0;
+
+  /**
+   * called when a thread ends without Pool::threadExit.
+   * APR doesn't do this on every platform (not on Win32)
+   */
+  static void
+  threadPoolsDone(void * data)
+  {
+    if (data != 0)
+      static_cast<ThreadPools *>(data)->threadDone();
+  }
+#endif
+
+  static void
+  initialize()
+  {
+    if (m_initialized)
+      return;
+
+    m_initialized = true;
+    apr_pool_initialize();
+
+#if APR_HAS_THREADS
+    apr_pool_t * pool = svn_pool_create(NULL);
+    apr_threadkey_private_create(&m_threadKey, threadPoolsDone, pool);
+#endif
+  }
+
+  /**
+   * Initializes the pools during static initialization,
+   * when there is only a single thread. This way no locking
+   * is needed for the check in pool_create.
+   */
+  static struct PoolInitializer
+  {
+    PoolInitializer()
+    {
+      initialize();
+    }
+  } m_poolInitializer;
+
+  /**
+   * @return the pools of the calling thread, if @a create
+   *         is false they might be 0
+   */
+  static ThreadPools *
+  currentThreadPools(bool create = true)
+  {
+#if APR_HAS_THREADS
+    void * data = 0;
+    apr_threadkey_private_get(&data, m_threadKey);
+
+    ThreadPools * pools = static_cast<ThreadPools *>(data);
+    if ((pools == 0) && create)
+    {
+      pools = new ThreadPools();
+      apr_threadkey_private_set(pools, m_threadKey);
+    }
+
+    return pools;
+#else
+    static ThreadPools * pools = 0;
+
+    if ((pools == 0) && create)
+      pools = new ThreadPools();
+
+    return pools;
+#endif
+  }
+
   inline static apr_pool_t *
   pool_create(apr_pool_t * parent)
   {
-    // CAUTION: this is not thread-safe!!!
-    if (!m_initialized)
+    // only needed if a pool is created during static
+    // initialization before m_poolInitializer
+    initialize();
+
+    if (parent != 0)
+    {
+      m_createdCount++;
+      return svn_pool_create(parent);
+    }
+
+    ThreadPools * pools = currentThreadPools();
+    pools->addRef();
+
+    if (pools->freePools.empty())
+    {
+      m_createdCount++;
+      return svn_pool_create(pools->root);
+    }
+
+    m_reusedCount++;
+    apr_pool_t * pool = pools->freePools.back();
+    pools->freePools.pop_back();
+    return pool;
+  }
+
+  inline static void
+  pool_destroy(apr_pool_t * parent, apr_pool_t * pool)
+  {
+    if (parent != 0)
+    {
+      svn_pool_destroy(pool);
+      return;
+    }
+
+    ThreadPools * owner = ThreadPools::owner(pool);
+
+    // only the thread that created the pool keeps it
+    if ((owner != 0) && (owner == currentThreadPools(false)) &&
+        (owner->freePools.size() < MAX_FREE_POOLS))
     {
-      m_initialized = true;
-      apr_pool_initialize();
+      svn_pool_clear(pool);
+      owner->freePools.push_back(pool);
+      owner->release();
+      return;
     }
 
-    return svn_pool_create(parent);
+    svn_pool_destroy(pool);
+
+    if (owner != 0)
+      owner->release();
   }
 
   Pool::Pool(apr_pool_t * parent)
@@ -55,7 +320,7 @@ namespace svn
   {
     if (m_pool)
     {
-      svn_pool_destroy(m_pool);
+      pool_destroy(m_parent, m_pool);
     }
   }
 
@@ -70,11 +335,59 @@ namespace svn
   {
     if (m_pool)
     {
-      svn_pool_destroy(m_pool);
+      pool_destroy(m_parent, m_pool);
     }
     m_pool = pool_create(m_parent);
   }
 
+  void
+  Pool::threadExit()
+  {
+#if APR_HAS_THREADS
+    ThreadPools * pools = currentThreadPools(false);
+    if (pools == 0)
+      return;
+
+    apr_threadkey_private_set(0, m_threadKey);
+    pools->threadDone();
+#endif
+  }
+
+  size_t
+  Pool::createdCount()
+  {
+    return m_createdCount;
+  }
+
+  size_t
+  Pool::reusedCount()
+  {
+    return m_reusedCount;
+  }
+
+  long
+  Pool::peakMemoryKb()
+  {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+      return 0;
+
+    return (long)(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+
+#ifdef __APPLE__
+    // darwin reports bytes instead of kilobytes
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+  }
+
 //TODO
 //   apr_pool_t *
 //   Pool::operator=(const Pool & pool)
@@ -0,0 +1,281 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// stl
+#include "svncpp/vector_wrapper.hpp"
+
+// Apache Portable Runtime
+#include "apr_pools.h"
+#include "apr_portable.h"
+#include "apr_strings.h"
+#include "apr_thread_mutex.h"
+
+// svncpp
+#include "svncpp/trace.hpp"
+
+
+namespace svn
+{
+  /** maximum number of spans kept, the rest is dropped */
+  static const size_t MAX_EVENTS = 1000000;
+
+  struct TraceEvent
+  {
+    const char * category;
+    std::string name;
+    apr_time_t start;
+    apr_time_t duration;
+    size_t thread;
+  };
+
+  /**
+   * Everything collected. Created by the first call of
+   * Trace::start and kept until the program ends, so
+   * spans ending in other threads never see it vanish.
+   */
+  struct TraceData
+  {
+    apr_pool_t * pool;
+#if APR_HAS_THREADS
+    apr_thread_mutex_t * mutex;
+#endif
+    apr_time_t start;
+    std::vector<TraceEvent> events;
+
+    /** the threads seen so far, the index is the thread id of the trace */
+    std::vector<apr_os_thread_t> threads;
+
+    TraceData()
+      : start(0)
+    {
+      apr_pool_create(&pool, NULL);
+#if APR_HAS_THREADS
+      apr_thread_mutex_create(&mutex, APR_THREAD_MUTEX_DEFAULT, pool);
+#endif
+    }
+
+    void
+    lock()
+    {
+#if APR_HAS_THREADS
+      apr_thread_mutex_lock(mutex);
+#endif
+    }
+
+    void
+    unlock()
+    {
+#if APR_HAS_THREADS
+      apr_thread_mutex_unlock(mutex);
+#endif
+    }
+
+    /**
+     * @return the number of the calling thread
+     */
+    size_t
+    threadIndex()
+    {
+      apr_os_thread_t current = apr_os_thread_current();
+
+      for (size_t i = 0; i < threads.size(); i++)
+      {
+        if (apr_os_thread_equal(threads[i], current))
+          return i;
+      }
+
+      threads.push_back(current);
+      return threads.size() - 1;
+    }
+  };
+
+  static TraceData * m_trace = 0;
+  static volatile bool m_traceEnabled = false;
+
+  static void
+  appendJsonString(std::string & json, const std::string & value)
+  {
+    static const char HEX[] = "0123456789abcdef";
+
+    json += '"';
+    for (size_t i = 0; i < value.length(); i++)
+    {
+      unsigned char c = (unsigned char)value[i];
+      if ((c == '"') || (c == '\\'))
+      {
+        json += '\\';
+        json += c;
+      }
+      else if (c < 0x20)
+      {
+        json += "\\u00";
+        json += HEX[c >> 4];
+        json += HEX[c & 0xf];
+      }
+      else
+        json += c;
+    }
+    json += '"';
+  }
+
+  void
+  Trace::start()
+  {
+    if (m_trace == 0)
+      m_trace = new TraceData();
+
+    m_trace->lock();
+    m_trace->events.clear();
+    m_trace->threads.clear();
+    m_trace->start = apr_time_now();
+    m_traceEnabled = true;
+    m_trace->unlock();
+  }
+
+  void
+  Trace::stop()
+  {
+    if (m_trace == 0)
+      return;
+
+    m_trace->lock();
+    m_traceEnabled = false;
+    m_trace->unlock();
+  }
+
+  bool
+  Trace::isEnabled()
+  {
+    return m_traceEnabled;
+  }
+
+  void
+  Trace::add(const char * category, const std::string & name,
+             apr_time_t start, apr_time_t end)
+  {
+    if (!m_traceEnabled)
+      return;
+
+    m_trace->lock();
+
+    // tracing might have been stopped in the meantime
+    if (m_traceEnabled && (m_trace->events.size() < MAX_EVENTS))
+    {
+      TraceEvent event;
+      event.category = category;
+      event.name = name;
+      event.start = start;
+      event.duration = end - start;
+      event.thread = m_trace->threadIndex();
+
+      m_trace->events.push_back(event);
+    }
+
+    m_trace->unlock();
+  }
+
+  size_t
+  Trace::count()
+  {
+    if (m_trace == 0)
+      return 0;
+
+    m_trace->lock();
+    size_t result = m_trace->events.size();
+    m_trace->unlock();
+
+    return result;
+  }
+
+  std::string
+  Trace::toJson()
+  {
+    std::string json("{\"traceEvents\":[");
+
+    if (m_trace != 0)
+    {
+      m_trace->lock();
+
+      char buffer[128];
+      std::vector<TraceEvent>::const_iterator it;
+      for (it = m_trace->events.begin(); it != m_trace->events.end(); ++it)
+      {
+        if (it != m_trace->events.begin())
+          json += ',';
+
+        json += "\n{\"name\":";
+        appendJsonString(json, it->name);
+        json += ",\"cat\":";
+        appendJsonString(json, it->category);
+
+        // the timestamps are in microseconds, just like apr_time_t
+        apr_snprintf(buffer, sizeof(buffer),
+                     ",\"ph\":\"X\",\"ts\":%" APR_INT64_T_FMT
+                     ",\"dur\":%" APR_INT64_T_FMT ",\"pid\":1,\"tid\":%lu}",
+                     (apr_int64_t)(it->start - m_trace->start),
+                     (apr_int64_t)it->duration,
+                     (unsigned long)it->thread);
+        json += buffer;
+      }
+
+      m_trace->unlock();
+    }
+
+    json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return json;
+  }
+
+  TraceSpan::TraceSpan(const char * category, const char * name)
+    : m_category(category), m_start(0)
+  {
+    if (m_traceEnabled)
+    {
+      m_name = name;
+      m_start = apr_time_now();
+    }
+  }
+
+  TraceSpan::TraceSpan(const char * category, const std::string & name)
+    : m_category(category), m_start(0)
+  {
+    if (m_traceEnabled)
+    {
+      m_name = name;
+      m_start = apr_time_now();
+    }
+  }
+
+  TraceSpan::~TraceSpan()
+  {
+    if (m_start != 0)
+      Trace::add(m_category, m_name, m_start, apr_time_now());
+  }
+}
+
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
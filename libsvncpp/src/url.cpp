@@ -21,38 +21,57 @@
  * history and logs, available at http://rapidsvn.tigris.org/.
  * ====================================================================
  */
+// stl
+#include <cstring>
+
 // subversion api
 #include "svn_path.h"
 
 // svncpp
-#include "svncpp/pool.hpp"
 #include "svncpp/url.hpp"
 
-static void findAndReplace(std::string & source, const std::string & find, const std::string & replace)
+/**
+ * characters that have to be escaped in an url: the ones
+ * svn_path_uri_autoescape takes care of (control characters,
+ * space, "<>\\^`{|} and anything outside ascii) plus the
+ * ones with a special meaning in urls: %#;?[]
+ */
+static const char NEEDS_ESCAPE [256] =
 {
-  // start seaching from the beginning
-  size_t pos = 0;
-  size_t findLength = find.length();
-  size_t replaceLength = replace.length();
-
-  do
-  {
-    // search for the next occurrenc
-    pos = source.find(find, pos);
-    
-    // found?
-    if (pos != std::string::npos)
-    {
-      // yes, place
-      source.replace(pos, findLength, replace);
+  /* 0x00 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  /* 0x10 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  /* 0x20 */ 1, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 0x30 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 1,
+  /* 0x40 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 0x50 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0,
+  /* 0x60 */ 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 0x70 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 1,
+  /* 0x80 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  /* 0x90 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  /* 0xA0 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  /* 0xB0 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  /* 0xC0 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  /* 0xD0 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  /* 0xE0 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  /* 0xF0 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+static inline bool
+needsEscape(unsigned char c)
+{
+  return NEEDS_ESCAPE[c] != 0;
+}
 
-      // Make sure we dont search from the beginning
-      // othwise replacing % with %25 would result 
-      // in an endless loop
-      pos = pos + replaceLength;
-    }
-  }
-  while (pos != std::string::npos);
+static int
+hexValue(char c)
+{
+  if ((c >= '0') && (c <= '9'))
+    return c - '0';
+  if ((c >= 'a') && (c <= 'f'))
+    return c - 'a' + 10;
+  if ((c >= 'A') && (c <= 'F'))
+    return c - 'A' + 10;
+  return -1;
 }
 
 namespace svn
@@ -71,32 +90,73 @@ namespace svn
   std::string
   Url::escape(const char * url)
   {
-    Pool pool;
+    static const char hexDigits [] = "0123456789ABCDEF";
+    const unsigned char * p = reinterpret_cast<const unsigned char *>(url);
 
-    // First make sure % gets escaped
-    std::string partlyEscaped(url);
-    findAndReplace(partlyEscaped, "%", "%25");
+    // fast path: nothing to escape
+    const unsigned char * c = p;
+    while ((*c != 0) && !needsEscape(*c))
+      c++;
+    if (*c == 0)
+      return std::string(url);
 
-    // Let svn do the first part of the work
-    partlyEscaped=svn_path_uri_autoescape(partlyEscaped.c_str(), pool);
+    std::string escaped(url, c - p);
+    escaped.reserve((c - p) + 3 * strlen(reinterpret_cast<const char *>(c)));
 
-    // Then worry about the rest
-    findAndReplace(partlyEscaped, "#", "%23");
-    findAndReplace(partlyEscaped, ";", "%3B");
-    findAndReplace(partlyEscaped, "?", "%3F");
-    findAndReplace(partlyEscaped, "[", "%5B");
-    findAndReplace(partlyEscaped, "]", "%5D");
+    for (; *c != 0; c++)
+    {
+      if (needsEscape(*c))
+      {
+        escaped += '%';
+        escaped += hexDigits[*c >> 4];
+        escaped += hexDigits[*c & 0x0F];
+      }
+      else
+        escaped += static_cast<char>(*c);
+    }
 
-    return partlyEscaped;
+    return escaped;
   }
 
 
   std::string
   Url::unescape(const char * url)
   {
-    Pool pool;
+    // same as svn_path_uri_decode, including the handling
+    // of '+' in the query part
+    const char * c = url;
+    while ((*c != 0) && (*c != '%') && (*c != '?'))
+      c++;
+    if (*c == 0)
+      return std::string(url);
+
+    std::string unescaped(url, c - url);
+    bool query = false;
+
+    for (; *c != 0; c++)
+    {
+      char ch = *c;
+
+      if (ch == '?')
+        query = true;
+      else if ((ch == '+') && query)
+        ch = ' ';
+      else if (ch == '%')
+      {
+        int high = hexValue(c[1]);
+        int low = (high < 0) ? -1 : hexValue(c[2]);
+
+        if (low >= 0)
+        {
+          ch = static_cast<char>((high << 4) | low);
+          c += 2;
+        }
+      }
+
+      unescaped += ch;
+    }
 
-    return svn_path_uri_decode(url, pool);
+    return unescaped;
   }
 
   /**
@@ -22,7 +22,14 @@
  * ====================================================================
  */
 
+// stl
+#include <cstring>
+
+// Apache Portable Runtime
+#include "apr_strings.h"
+
 // subversion api
+#include "svn_props.h"
 #include "svn_wc.h"
 
 // svncpp
@@ -97,6 +104,154 @@ namespace svn
     return 0 != svn_wc_is_adm_dir(name, pool);
   }
 
+  /**
+   * open the administrative area that contains @a path
+   * (read-only, no locks)
+   */
+  static svn_wc_adm_access_t *
+  openAdm(const Path & path, Pool & pool)
+  {
+    svn_wc_adm_access_t * adm_access = NULL;
+    svn_error_t * error =
+      svn_wc_adm_probe_open3(&adm_access, NULL, path.c_str(),
+                             FALSE, 0, NULL, NULL, pool);
+
+    if (error != NULL)
+      throw ClientException(error);
+
+    return adm_access;
+  }
+
+  std::string
+  Wc::getPristineChecksum(const Path & path)
+  {
+    Pool pool;
+    svn_wc_adm_access_t * adm_access = openAdm(path, pool);
+
+    const svn_wc_entry_t * entry = NULL;
+    svn_error_t * error =
+      svn_wc_entry(&entry, path.c_str(), adm_access, FALSE, pool);
+
+    svn_wc_adm_close(adm_access);
+
+    if (error != NULL)
+      throw ClientException(error);
+
+    if ((entry == NULL) || (entry->checksum == NULL))
+      return "";
+
+    return entry->checksum;
+  }
+
+  /**
+   * append the value of the property @a name of @a path
+   * to @a key (empty if the property is not set)
+   *
+   * @return true if the property is set
+   */
+  static bool
+  appendProp(std::string & key, const char * name,
+             const Path & path, svn_wc_adm_access_t * adm_access,
+             Pool & pool)
+  {
+    const svn_string_t * value = NULL;
+    svn_error_t * error =
+      svn_wc_prop_get(&value, name, path.c_str(), adm_access, pool);
+
+    if (error != NULL)
+    {
+      svn_wc_adm_close(adm_access);
+      throw ClientException(error);
+    }
+
+    key += '\n';
+    if (value == NULL)
+      return false;
+
+    key.append(value->data, value->len);
+    return true;
+  }
+
+  std::string
+  Wc::getTranslationKey(const Path & path)
+  {
+    Pool pool;
+    svn_wc_adm_access_t * adm_access = openAdm(path, pool);
+
+    std::string key;
+    appendProp(key, SVN_PROP_EOL_STYLE, path, adm_access, pool);
+    appendProp(key, SVN_PROP_SPECIAL, path, adm_access, pool);
+    bool hasKeywords =
+      appendProp(key, SVN_PROP_KEYWORDS, path, adm_access, pool);
+
+    // expanded keywords depend on the last commit and the url
+    // as well, none of which changes the checksum
+    if (hasKeywords)
+    {
+      const svn_wc_entry_t * entry = NULL;
+      svn_error_t * error =
+        svn_wc_entry(&entry, path.c_str(), adm_access, FALSE, pool);
+
+      if (error != NULL)
+      {
+        svn_wc_adm_close(adm_access);
+        throw ClientException(error);
+      }
+
+      if (entry != NULL)
+      {
+        key += apr_psprintf(pool, "\n%ld\n%" APR_INT64_T_FMT "\n",
+                            entry->cmt_rev, (apr_int64_t)entry->cmt_date);
+        if (entry->cmt_author != NULL)
+          key += entry->cmt_author;
+        key += '\n';
+        if (entry->url != NULL)
+          key += entry->url;
+      }
+    }
+
+    svn_wc_adm_close(adm_access);
+
+    return key;
+  }
+
+  bool
+  Wc::getPristineFile(Path & dstPath, const Path & path)
+  {
+    Pool pool;
+    const char * pristinePath = NULL;
+
+    svn_error_t * error =
+      svn_wc_get_pristine_copy_path(path.c_str(), &pristinePath, pool);
+
+    if (error != NULL)
+      throw ClientException(error);
+
+    svn_wc_adm_access_t * adm_access = openAdm(path, pool);
+
+    // translate from normal form into working copy form. If
+    // there is nothing to translate (no svn:keywords, svn:eol-style
+    // or svn:special) we get back @a pristinePath itself
+    const char * xlatedPath = NULL;
+    error = svn_wc_translated_file2(&xlatedPath,
+                                    pristinePath,
+                                    path.c_str(),
+                                    adm_access,
+                                    SVN_WC_TRANSLATE_FROM_NF |
+                                    SVN_WC_TRANSLATE_USE_GLOBAL_TMP |
+                                    SVN_WC_TRANSLATE_NO_OUTPUT_CLEANUP,
+                                    pool);
+
+    svn_wc_adm_close(adm_access);
+
+    if (error != NULL)
+      throw ClientException(error);
+
+    dstPath = xlatedPath;
+
+    return strcmp(xlatedPath, pristinePath) != 0;
+  }
+
 }
 
 /* -----------------------------------------------------------------
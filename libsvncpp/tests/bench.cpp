@@ -0,0 +1,406 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+/**
+ * @file bench.cpp
+ *
+ * Measures the time svncpp needs for the operations rapidsvn
+ * uses most, on a generated repository and working copy.
+ *
+ * Usage: libsvncpp_bench [options]
+ *
+ *   --dir=DIR                  where to create the directory with
+ *                              the repository and the working copy
+ *   --files-per-dir=N          files in every directory
+ *   --dirs-per-dir=N           subdirectories in every directory
+ *   --depth=N                  levels of subdirectories
+ *   --history=N                revisions after the initial import
+ *   --changes-per-revision=N   files changed in every revision
+ *   --file-size=N              size of the files in bytes
+ *   --modified=PERCENT         files modified in the working copy
+ *   --unversioned=PERCENT      unversioned files in the working copy
+ *   --seed=N                   seed of the generated contents
+ *   --iterations=N             runs of every benchmark
+ *   --format=json|csv          json: one object per line (default)
+ *   --keep                     don't remove the repository afterwards
+ *
+ * Every benchmark prints one record with the number of items
+ * (entries, lines or bytes) it processed, the best and the mean
+ * time of the runs, the throughput of the best run, the peak
+ * resident set size of the process and the number of apr pools
+ * svncpp created and reused per run.
+ */
+
+// ansi c lib
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Subversion api
+#include "svn_io.h"
+
+// svncpp
+#include "svncpp/apr.hpp"
+#include "svncpp/client.hpp"
+#include "svncpp/context.hpp"
+#include "svncpp/info.hpp"
+#include "svncpp/log_entry.hpp"
+#include "svncpp/output_sink.hpp"
+#include "svncpp/path.hpp"
+#include "svncpp/pool.hpp"
+#include "svncpp/status.hpp"
+#include "svncpp/url.hpp"
+
+// app
+#include "bench_report.hpp"
+#include "bench_repos.hpp"
+
+/** maximum number of files the cat benchmark reads */
+static const size_t CAT_FILES = 100;
+
+/** conversions done by the path and url benchmarks */
+static const long CONVERSIONS = 200000;
+
+/**
+ * sink that only counts the bytes it receives
+ */
+class CountingSink : public svn::OutputSink
+{
+public:
+  CountingSink() : bytes(0)
+  {
+  }
+
+  virtual bool
+  write(const char *, size_t len)
+  {
+    bytes += len;
+    return true;
+  }
+
+  size_t bytes;
+};
+
+/**
+ * what a benchmark needs to run
+ */
+struct BenchEnv
+{
+  svn::Client & client;
+  const BenchRepository & repos;
+
+  BenchEnv(svn::Client & client_, const BenchRepository & repos_)
+    : client(client_), repos(repos_)
+  {
+  }
+};
+
+/** a benchmark returns the number of items it processed */
+typedef long (*BenchFunc)(BenchEnv & env);
+
+static long
+benchStatus(BenchEnv & env)
+{
+  svn::StatusEntries entries =
+    env.client.status(env.repos.wcPath().c_str(), true, true,
+                      false, false, false);
+  return (long)entries.size();
+}
+
+static long
+benchStatusFiltered(BenchEnv & env)
+{
+  svn::StatusFilter filter;
+  filter.showModified = true;
+  filter.showConflicted = true;
+  filter.showUnversioned = true;
+
+  svn::StatusEntries entries;
+  env.client.status(env.repos.wcPath().c_str(), filter, true, false, entries);
+  return (long)entries.size();
+}
+
+static long
+benchList(BenchEnv & env)
+{
+  svn::Revision head(svn::Revision::HEAD);
+  svn::DirEntries entries =
+    env.client.list(env.repos.url().c_str(), head, true);
+  return (long)entries.size();
+}
+
+static long
+benchLog(BenchEnv & env)
+{
+  const svn::LogEntries * entries =
+    env.client.log(env.repos.url().c_str(), svn::Revision::HEAD,
+                   svn::Revision::START, true, false);
+  long count = (long)entries->size();
+  delete entries;
+  return count;
+}
+
+static long
+benchInfo(BenchEnv & env)
+{
+  svn::InfoVector infos = env.client.info(env.repos.wcPath(), true);
+  return (long)infos.size();
+}
+
+static long
+benchCat(BenchEnv & env)
+{
+  const std::vector<std::string> & files = env.repos.files();
+  CountingSink sink;
+
+  for (size_t i = 0; i < files.size() && i < CAT_FILES; i++)
+  {
+    svn::Path url(env.repos.url() + "/" + files[i]);
+    env.client.cat(sink, url, svn::Revision::HEAD);
+  }
+  return (long)sink.bytes;
+}
+
+static long
+benchAnnotate(BenchEnv & env)
+{
+  svn::Path url(env.repos.url() + "/" + env.repos.busiestFile());
+  svn::AnnotatedFile * lines =
+    env.client.annotate(url, svn::Revision::START, svn::Revision::HEAD);
+  long count = (long)lines->size();
+  delete lines;
+  return count;
+}
+
+static long
+benchDiff(BenchEnv & env)
+{
+  CountingSink sink;
+  svn::Path tmpPath(svn::Path::getTempDir());
+  tmpPath.addComponent("svncpp_bench");
+
+  env.client.diff(sink, tmpPath, env.repos.wcPath(), svn::Revision::BASE,
+                  svn::Revision::WORKING, true, false, false);
+  return (long)sink.bytes;
+}
+
+static long
+benchPath(BenchEnv &)
+{
+  const char * canonical = "/home/user/work/project/src/module/file.cpp";
+  size_t length = 0;
+
+  for (long i = 0; i < CONVERSIONS; i++)
+  {
+    svn::Path path(canonical);
+    svn::Path copy(path);
+    length += copy.length();
+  }
+
+  // use the result, so the loop isn't optimized away
+  return (length > 0) ? CONVERSIONS : 0;
+}
+
+static long
+benchUrl(BenchEnv &)
+{
+  const char * plain = "http://svn.example.org/repos/project/trunk/src/file.cpp";
+  const char * special = "http://svn.example.org/repos/my project/#1/file [old].cpp";
+  size_t length = 0;
+
+  for (long i = 0; i < CONVERSIONS; i++)
+  {
+    length += svn::Url::escape(plain).length();
+    length += svn::Url::unescape(svn::Url::escape(special).c_str()).length();
+  }
+
+  return (length > 0) ? CONVERSIONS : 0;
+}
+
+struct Benchmark
+{
+  const char * name;
+  const char * unit;
+  BenchFunc func;
+};
+
+static const Benchmark BENCHMARKS [] =
+{
+  {"status", "entries", benchStatus},
+  {"status_filtered", "entries", benchStatusFiltered},
+  {"list", "entries", benchList},
+  {"log", "revisions", benchLog},
+  {"info", "entries", benchInfo},
+  {"cat", "bytes", benchCat},
+  {"annotate", "lines", benchAnnotate},
+  {"diff", "bytes", benchDiff},
+  {"path", "conversions", benchPath},
+  {"url", "conversions", benchUrl},
+  {0, 0, 0}
+};
+
+static BenchResult
+runBenchmark(const Benchmark & benchmark, BenchEnv & env, int iterations)
+{
+  BenchTimer timer;
+  long items = 0;
+
+  for (int i = 0; i < iterations; i++)
+  {
+    timer.start();
+    items = benchmark.func(env);
+    timer.stop();
+  }
+
+  return timer.result(benchmark.name, benchmark.unit, items);
+}
+
+/**
+ * @return true if @a arg is "--name=value". The value
+ *         is stored in @a value
+ */
+static bool
+option(const char * arg, const char * name, const char ** value)
+{
+  size_t len = strlen(name);
+  if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, len) != 0 ||
+      arg[len + 2] != '=')
+    return false;
+
+  *value = arg + len + 3;
+  return true;
+}
+
+static void
+removeDir(const std::string & path)
+{
+  svn::Pool pool;
+  svn_error_t * error =
+    svn_io_remove_dir2(path.c_str(), TRUE, NULL, NULL, pool);
+  if (error != 0)
+    svn_error_clear(error);
+}
+
+int
+main(int argc, char **argv)
+{
+  svn::Apr apr;
+  BenchShape shape;
+  int iterations = 5;
+  bool keep = false;
+  bool csv = false;
+
+  svn::Path dir(svn::Path::getTempDir());
+
+  for (int i = 1; i < argc; i++)
+  {
+    const char * value;
+    if (option(argv[i], "dir", &value))
+      dir = value;
+    else if (option(argv[i], "files-per-dir", &value))
+      shape.filesPerDir = atoi(value);
+    else if (option(argv[i], "dirs-per-dir", &value))
+      shape.dirsPerDir = atoi(value);
+    else if (option(argv[i], "depth", &value))
+      shape.depth = atoi(value);
+    else if (option(argv[i], "history", &value))
+      shape.history = atoi(value);
+    else if (option(argv[i], "changes-per-revision", &value))
+      shape.changesPerRevision = atoi(value);
+    else if (option(argv[i], "file-size", &value))
+      shape.fileSize = atoi(value);
+    else if (option(argv[i], "modified", &value))
+      shape.modifiedPercent = atoi(value);
+    else if (option(argv[i], "unversioned", &value))
+      shape.unversionedPercent = atoi(value);
+    else if (option(argv[i], "seed", &value))
+      shape.seed = strtoul(value, 0, 10);
+    else if (option(argv[i], "iterations", &value))
+      iterations = atoi(value);
+    else if (option(argv[i], "format", &value))
+      csv = strcmp(value, "csv") == 0;
+    else if (strcmp(argv[i], "--keep") == 0)
+      keep = true;
+    else
+    {
+      fprintf(stderr, "unknown option: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  if (iterations < 1)
+    iterations = 1;
+
+  // work in a directory of our own, whatever is in
+  // the directory given by --dir stays untouched
+  std::string workDir;
+  try
+  {
+    workDir = createBenchDir(dir.path(), "svncpp_bench");
+  }
+  catch (svn::ClientException & e)
+  {
+    fprintf(stderr, "error: %s\n", e.message());
+    return 1;
+  }
+
+  BenchRepository repos(workDir, shape);
+
+  int result = 0;
+  try
+  {
+    svn::Context context;
+    svn::Client client(&context);
+
+    apr_time_t start = apr_time_now();
+    repos.create(&context);
+    BenchReport report(csv);
+    report.printSetup(shape, repos, (apr_time_now() - start) / 1000.0);
+
+    BenchEnv env(client, repos);
+    for (const Benchmark * benchmark = BENCHMARKS;
+         benchmark->name != 0; benchmark++)
+    {
+      report.printResult(runBenchmark(*benchmark, env, iterations));
+    }
+  }
+  catch (svn::ClientException & e)
+  {
+    fprintf(stderr, "error: %s\n", e.message());
+    result = 1;
+  }
+
+  if (keep)
+    fprintf(stderr, "repository kept in %s\n", workDir.c_str());
+  else
+    removeDir(workDir);
+
+  return result;
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
@@ -0,0 +1,146 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// ansi c lib
+#include <cstdio>
+
+// svncpp
+#include "svncpp/pool.hpp"
+
+// app
+#include "bench_report.hpp"
+#include "bench_repos.hpp"
+
+
+BenchTimer::BenchTimer()
+  : m_start(0), m_runs(0), m_bestMs(0), m_totalMs(0),
+    m_poolsCreated(svn::Pool::createdCount()),
+    m_poolsReused(svn::Pool::reusedCount())
+{
+}
+
+void
+BenchTimer::start()
+{
+  m_start = apr_time_now();
+}
+
+void
+BenchTimer::stop()
+{
+  double ms = (apr_time_now() - m_start) / 1000.0;
+
+  if (m_runs == 0 || ms < m_bestMs)
+    m_bestMs = ms;
+
+  m_totalMs += ms;
+  m_runs++;
+}
+
+BenchResult
+BenchTimer::result(const char * name, const char * unit, long items) const
+{
+  int runs = m_runs > 0 ? m_runs : 1;
+
+  BenchResult result;
+  result.name = name;
+  result.unit = unit;
+  result.items = items;
+  result.iterations = m_runs;
+  result.bestMs = m_bestMs;
+  result.meanMs = m_totalMs / runs;
+  result.peakRssKb = svn::Pool::peakMemoryKb();
+  result.poolsCreated =
+    double(svn::Pool::createdCount() - m_poolsCreated) / runs;
+  result.poolsReused =
+    double(svn::Pool::reusedCount() - m_poolsReused) / runs;
+  return result;
+}
+
+
+BenchReport::BenchReport(bool csv)
+  : m_csv(csv)
+{
+}
+
+void
+BenchReport::printSetup(const BenchShape & shape,
+                        const BenchRepository & repos, double setupMs)
+{
+  if (m_csv)
+  {
+    printf("benchmark,unit,items,iterations,best_ms,mean_ms,"
+           "items_per_second,peak_rss_kb,pools_created,pools_reused\n");
+    printf("setup,files,%ld,1,%.3f,%.3f,%.1f,%ld,,\n",
+           shape.fileCount(), setupMs, setupMs,
+           setupMs > 0 ? shape.fileCount() * 1000.0 / setupMs : 0.0,
+           svn::Pool::peakMemoryKb());
+  }
+  else
+  {
+    printf("{\"benchmark\": \"setup\", \"files\": %ld, \"dirs\": %ld, "
+           "\"files_per_dir\": %d, \"dirs_per_dir\": %d, \"depth\": %d, "
+           "\"history\": %d, \"changes_per_revision\": %d, "
+           "\"file_size\": %d, \"modified\": %ld, \"unversioned\": %ld, "
+           "\"seed\": %lu, \"setup_ms\": %.3f, \"peak_rss_kb\": %ld}\n",
+           shape.fileCount(), shape.dirCount(), shape.filesPerDir,
+           shape.dirsPerDir, shape.depth, shape.history,
+           shape.changesPerRevision, shape.fileSize,
+           repos.modifiedCount(), repos.unversionedCount(),
+           shape.seed, setupMs, svn::Pool::peakMemoryKb());
+  }
+  fflush(stdout);
+}
+
+void
+BenchReport::printResult(const BenchResult & result)
+{
+  double perSecond =
+    result.bestMs > 0 ? result.items * 1000.0 / result.bestMs : 0.0;
+
+  if (m_csv)
+  {
+    printf("%s,%s,%ld,%d,%.3f,%.3f,%.1f,%ld,%.1f,%.1f\n",
+           result.name, result.unit, result.items, result.iterations,
+           result.bestMs, result.meanMs, perSecond, result.peakRssKb,
+           result.poolsCreated, result.poolsReused);
+  }
+  else
+  {
+    printf("{\"benchmark\": \"%s\", \"unit\": \"%s\", \"items\": %ld, "
+           "\"iterations\": %d, \"best_ms\": %.3f, \"mean_ms\": %.3f, "
+           "\"items_per_second\": %.1f, \"peak_rss_kb\": %ld, "
+           "\"pools_created\": %.1f, \"pools_reused\": %.1f}\n",
+           result.name, result.unit, result.items, result.iterations,
+           result.bestMs, result.meanMs, perSecond, result.peakRssKb,
+           result.poolsCreated, result.poolsReused);
+  }
+  fflush(stdout);
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
@@ -0,0 +1,134 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _SVNCPP_BENCH_REPORT_HPP_
+#define _SVNCPP_BENCH_REPORT_HPP_
+
+// ansi c lib
+#include <cstddef>
+
+// Apache Portable Runtime
+#include "apr_time.h"
+
+class BenchRepository;
+struct BenchShape;
+
+/**
+ * the measurements of one benchmark
+ */
+struct BenchResult
+{
+  const char * name;
+
+  /** what @a items counts, like "entries" or "bytes" */
+  const char * unit;
+
+  /** items processed by a single run */
+  long items;
+
+  int iterations;
+  double bestMs;
+  double meanMs;
+
+  /** peak resident set size of the process after the runs */
+  long peakRssKb;
+
+  /** svn::Pool statistics per run */
+  double poolsCreated;
+  double poolsReused;
+};
+
+
+/**
+ * Measures the runs of a benchmark. Call @ref start and
+ * @ref stop around every run, the pool statistics are
+ * counted from the construction on.
+ */
+class BenchTimer
+{
+public:
+  BenchTimer();
+
+  void
+  start();
+
+  void
+  stop();
+
+  /**
+   * @param name name of the benchmark
+   * @param unit what @a items counts
+   * @param items items processed by a single run
+   * @return the measurements of the runs so far
+   */
+  BenchResult
+  result(const char * name, const char * unit, long items) const;
+
+private:
+  apr_time_t m_start;
+  int m_runs;
+  double m_bestMs;
+  double m_totalMs;
+  size_t m_poolsCreated;
+  size_t m_poolsReused;
+};
+
+
+/**
+ * Prints benchmark results in a machine readable format:
+ * either one json object per line or csv with a header.
+ * Both contain the same fields, so results of different
+ * builds can be compared with simple scripts.
+ */
+class BenchReport
+{
+public:
+  /**
+   * @param csv true for csv, false for json
+   */
+  BenchReport(bool csv);
+
+  /**
+   * prints the shape of the generated repository and
+   * the time it took to create it. This has to be the
+   * first record.
+   */
+  void
+  printSetup(const BenchShape & shape, const BenchRepository & repos,
+             double setupMs);
+
+  void
+  printResult(const BenchResult & result);
+
+private:
+  bool m_csv;
+};
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
@@ -0,0 +1,431 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// ansi c lib
+#include <cstdio>
+
+// stl
+#include "svncpp/map_wrapper.hpp"
+
+// Subversion api
+#include "svn_fs.h"
+#include "svn_path.h"
+#include "svn_repos.h"
+
+// Apache Portable Runtime
+#include "apr_file_io.h"
+#include "apr_time.h"
+
+// svncpp
+#include "svncpp/client.hpp"
+#include "svncpp/path.hpp"
+#include "svncpp/pool.hpp"
+
+// app
+#include "bench_repos.hpp"
+
+/** approximate length of a line in the generated files */
+static const int LINE_LENGTH = 64;
+
+/** author of the generated revisions */
+static const char * AUTHOR = "bench";
+
+/**
+ * revisions that changed the lines of a file. Only
+ * files that are changed in the history get an entry
+ */
+typedef std::map<long, std::vector<int> > LineRevisions;
+
+/**
+ * mixes @a a and @a b into a pseudo random number. The same
+ * values give the same number on every platform.
+ */
+static unsigned long
+mix(unsigned long a, unsigned long b)
+{
+  unsigned long x = (a * 2654435761UL + b * 40503UL + 12345UL) & 0xffffffffUL;
+  x ^= x >> 15;
+  x = (x * 2246822519UL) & 0xffffffffUL;
+  x ^= x >> 13;
+  return x;
+}
+
+static void
+throwOnError(svn_error_t * error) throw(svn::ClientException)
+{
+  if (error != 0)
+    throw svn::ClientException(error);
+}
+
+static int
+lineCount(const BenchShape & shape)
+{
+  int count = shape.fileSize / LINE_LENGTH;
+  return count < 1 ? 1 : count;
+}
+
+/**
+ * appends line @a line of file number @a file, as
+ * it was last changed in @a revision, to @a contents
+ */
+static void
+appendLine(std::string & contents, const BenchShape & shape,
+           long file, int line, int revision)
+{
+  char buffer[LINE_LENGTH + 1];
+  int len = sprintf(buffer, "%06ld:%04d r%-5d ", file, line, revision);
+
+  unsigned long random = mix(mix(shape.seed, file), line * 65536UL + revision);
+  while (len < LINE_LENGTH - 1)
+  {
+    random = mix(random, len);
+    buffer[len++] = (random % 7) == 0 ? ' ' : char('a' + random % 26);
+  }
+  buffer[len++] = '\n';
+
+  contents.append(buffer, len);
+}
+
+static std::string
+fileContents(const BenchShape & shape, long file,
+             const std::vector<int> * revisions)
+{
+  std::string contents;
+  int count = lineCount(shape);
+  contents.reserve(count * LINE_LENGTH);
+
+  for (int line = 0; line < count; line++)
+    appendLine(contents, shape, file, line,
+               revisions == 0 ? 1 : (*revisions)[line]);
+
+  return contents;
+}
+
+static void
+writeFsFile(svn_fs_root_t * root, const std::string & path,
+            const std::string & contents, apr_pool_t * pool)
+  throw(svn::ClientException)
+{
+  svn_stream_t * stream;
+  throwOnError(svn_fs_apply_text(&stream, root, path.c_str(), NULL, pool));
+
+  apr_size_t len = contents.length();
+  throwOnError(svn_stream_write(stream, contents.data(), &len));
+  throwOnError(svn_stream_close(stream));
+}
+
+static void
+writeLocalFile(const std::string & path, const std::string & contents,
+               const char * mode) throw(svn::ClientException)
+{
+  svn::Path native(path);
+  FILE * file = fopen(native.native().c_str(), mode);
+  if (file == 0)
+    throw svn::ClientException("Could not write a file of the working copy");
+
+  fwrite(contents.data(), 1, contents.length(), file);
+  fclose(file);
+}
+
+static std::string
+fileUrl(const char * path, apr_pool_t * pool) throw(svn::ClientException)
+{
+  const char * absolute;
+  throwOnError(svn_path_get_absolute(&absolute, path, pool));
+
+  std::string url("file://");
+  if (absolute[0] != '/')
+    url += "/";
+  url += svn_path_uri_encode(absolute, pool);
+  return url;
+}
+
+
+std::string
+createBenchDir(const std::string & parent,
+               const char * prefix) throw(svn::ClientException)
+{
+  svn::Pool pool;
+  apr_status_t status =
+    apr_dir_make_recursive(parent.c_str(), APR_OS_DEFAULT, pool);
+  if (status != APR_SUCCESS)
+    throw svn::ClientException(status);
+
+  for (int i = 0; i < 1000; i++)
+  {
+    char name[64];
+    sprintf(name, "%s-%" APR_TIME_T_FMT "-%d", prefix, apr_time_now(), i);
+
+    svn::Path dir(parent);
+    dir.addComponent(name);
+
+    // fails if the directory exists already
+    status = apr_dir_make(dir.c_str(), APR_OS_DEFAULT, pool);
+    if (status == APR_SUCCESS)
+      return dir.path();
+
+    if (!APR_STATUS_IS_EEXIST(status))
+      throw svn::ClientException(status);
+  }
+
+  throw svn::ClientException("Could not create a directory for the benchmark");
+}
+
+long
+BenchShape::fileCount() const
+{
+  return dirCount() * filesPerDir;
+}
+
+long
+BenchShape::dirCount() const
+{
+  long count = 1;
+  long level = 1;
+  for (int i = 0; i < depth; i++)
+  {
+    level *= dirsPerDir;
+    count += level;
+  }
+  return count;
+}
+
+
+BenchRepository::BenchRepository(const std::string & dir,
+                                 const BenchShape & shape)
+  : m_dir(dir), m_shape(shape), m_modifiedCount(0), m_unversionedCount(0)
+{
+  svn::Path reposPath(dir);
+  reposPath.addComponent("repos");
+  m_reposPath = reposPath.path();
+
+  svn::Path wcPath(dir);
+  wcPath.addComponent("wc");
+  m_wcPath = wcPath.path();
+
+  collectPaths("", 0);
+}
+
+void
+BenchRepository::collectPaths(const std::string & dir, int level)
+{
+  if (!dir.empty())
+    m_dirs.push_back(dir);
+
+  std::string prefix(dir.empty() ? dir : dir + "/");
+  char name[32];
+
+  for (int i = 0; i < m_shape.filesPerDir; i++)
+  {
+    sprintf(name, "file%03d.txt", i);
+    m_files.push_back(prefix + name);
+  }
+
+  if (level >= m_shape.depth)
+    return;
+
+  for (int i = 0; i < m_shape.dirsPerDir; i++)
+  {
+    sprintf(name, "dir%02d", i);
+    collectPaths(prefix + name, level + 1);
+  }
+}
+
+void
+BenchRepository::create(svn::Context * context) throw(svn::ClientException)
+{
+  svn::Pool pool;
+  apr_status_t status =
+    apr_dir_make_recursive(m_dir.c_str(), APR_OS_DEFAULT, pool);
+  if (status != APR_SUCCESS)
+    throw svn::ClientException(status);
+
+  m_url = fileUrl(m_reposPath.c_str(), pool);
+
+  createRepository();
+
+  svn::Client client(context);
+  client.checkout(m_url.c_str(), m_wcPath, svn::Revision::HEAD, true);
+
+  changeWorkingCopy();
+}
+
+void
+BenchRepository::createRepository() throw(svn::ClientException)
+{
+  svn::Pool pool;
+
+  apr_hash_t * fsConfig = apr_hash_make(pool);
+  apr_hash_set(fsConfig, SVN_FS_CONFIG_FS_TYPE,
+               APR_HASH_KEY_STRING, SVN_FS_TYPE_FSFS);
+
+  svn_repos_t * repos;
+  throwOnError(svn_repos_create(&repos, m_reposPath.c_str(), NULL, NULL,
+                                NULL, fsConfig, pool));
+  svn_fs_t * fs = svn_repos_fs(repos);
+
+  LineRevisions lineRevisions;
+  int lines = lineCount(m_shape);
+  long files = (long)m_files.size();
+
+  for (int revision = 1; revision <= m_shape.history + 1; revision++)
+  {
+    svn::Pool subPool(pool);
+
+    svn_revnum_t youngest;
+    throwOnError(svn_fs_youngest_rev(&youngest, fs, subPool));
+
+    svn_fs_txn_t * txn;
+    throwOnError(svn_repos_fs_begin_txn_for_commit(
+                   &txn, repos, youngest, AUTHOR,
+                   revision == 1 ? "Initial import" : "Change files",
+                   subPool));
+
+    svn_fs_root_t * root;
+    throwOnError(svn_fs_txn_root(&root, txn, subPool));
+
+    if (revision == 1)
+    {
+      std::vector<std::string>::const_iterator it;
+      for (it = m_dirs.begin(); it != m_dirs.end(); it++)
+        throwOnError(svn_fs_make_dir(root, ("/" + *it).c_str(), subPool));
+
+      for (long file = 0; file < files; file++)
+      {
+        std::string path("/" + m_files[file]);
+        throwOnError(svn_fs_make_file(root, path.c_str(), subPool));
+        writeFsFile(root, path, fileContents(m_shape, file, 0), subPool);
+      }
+    }
+    else
+    {
+      // the first file is changed in every revision, so
+      // there is at least one file with a long history
+      int changes = m_shape.changesPerRevision;
+      if (changes > files)
+        changes = (int)files;
+
+      for (int change = 0; change < changes; change++)
+      {
+        long file = change == 0 ? 0 :
+          (long)(mix(m_shape.seed + revision, change) % files);
+
+        std::vector<int> & revisions = lineRevisions[file];
+        if (revisions.empty())
+          revisions.resize(lines, 1);
+
+        revisions[mix(revision, file) % lines] = revision;
+
+        writeFsFile(root, "/" + m_files[file],
+                    fileContents(m_shape, file, &revisions), subPool);
+      }
+    }
+
+    const char * conflict;
+    svn_revnum_t newRevision;
+    throwOnError(svn_repos_fs_commit_txn(&conflict, repos, &newRevision,
+                                         txn, subPool));
+  }
+
+  if (!m_files.empty())
+    m_busiestFile = m_files[0];
+}
+
+void
+BenchRepository::changeWorkingCopy() throw(svn::ClientException)
+{
+  long files = (long)m_files.size();
+  std::string line;
+
+  for (long file = 0; file < files; file++)
+  {
+    if (long(mix(m_shape.seed, file + 1000003L) % 100) >= m_shape.modifiedPercent)
+      continue;
+
+    line.erase();
+    appendLine(line, m_shape, file, lineCount(m_shape), 0);
+    writeLocalFile(m_wcPath + "/" + m_files[file], line, "ab");
+    m_modifiedCount++;
+  }
+
+  long unversioned = files * m_shape.unversionedPercent / 100;
+  size_t dirs = m_dirs.size() + 1;
+  char name[32];
+
+  for (long i = 0; i < unversioned; i++)
+  {
+    size_t dir = i % dirs;
+    std::string path(m_wcPath);
+    if (dir > 0)
+      path += "/" + m_dirs[dir - 1];
+
+    sprintf(name, "/unversioned%05ld.tmp", i);
+    line.erase();
+    appendLine(line, m_shape, files + i, 0, 0);
+    writeLocalFile(path + name, line, "wb");
+    m_unversionedCount++;
+  }
+}
+
+const std::string &
+BenchRepository::url() const
+{
+  return m_url;
+}
+
+const std::string &
+BenchRepository::wcPath() const
+{
+  return m_wcPath;
+}
+
+const std::vector<std::string> &
+BenchRepository::files() const
+{
+  return m_files;
+}
+
+const std::string &
+BenchRepository::busiestFile() const
+{
+  return m_busiestFile;
+}
+
+long
+BenchRepository::modifiedCount() const
+{
+  return m_modifiedCount;
+}
+
+long
+BenchRepository::unversionedCount() const
+{
+  return m_unversionedCount;
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
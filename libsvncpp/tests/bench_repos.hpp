@@ -0,0 +1,188 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef _SVNCPP_BENCH_REPOS_HPP_
+#define _SVNCPP_BENCH_REPOS_HPP_
+
+// stl
+#include "svncpp/string_wrapper.hpp"
+#include "svncpp/vector_wrapper.hpp"
+
+// svncpp
+#include "svncpp/exception.hpp"
+
+namespace svn
+{
+  class Context;
+}
+
+/**
+ * Describes the repository and working copy built by
+ * @ref BenchRepository. The same shape and seed always
+ * result in the same tree, history and contents, so
+ * measurements of different builds can be compared.
+ */
+struct BenchShape
+{
+  /** files in every directory */
+  int filesPerDir;
+
+  /** subdirectories in every directory above @a depth */
+  int dirsPerDir;
+
+  /** levels of subdirectories below the root */
+  int depth;
+
+  /** revisions after the initial import */
+  int history;
+
+  /** files changed in every one of these revisions */
+  int changesPerRevision;
+
+  /** size of every file in bytes */
+  int fileSize;
+
+  /** percentage of files that get modified in the working copy */
+  int modifiedPercent;
+
+  /** unversioned files per hundred versioned files */
+  int unversionedPercent;
+
+  /** seed for the contents and the choice of the files */
+  unsigned long seed;
+
+  BenchShape()
+    : filesPerDir(20), dirsPerDir(3), depth(3), history(50),
+      changesPerRevision(10), fileSize(4096), modifiedPercent(5),
+      unversionedPercent(5), seed(1)
+  {
+  }
+
+  /**
+   * @return number of versioned files of this shape
+   */
+  long
+  fileCount() const;
+
+  /**
+   * @return number of versioned directories of this shape,
+   *         the root included
+   */
+  long
+  dirCount() const;
+};
+
+
+/**
+ * creates a new, empty directory below @a parent for the
+ * repository and the working copy of a benchmark, so
+ * nothing that is there already is ever touched. The
+ * benchmark removes only this directory afterwards.
+ *
+ * @param parent directory to create it in (created if needed)
+ * @param prefix start of the name of the new directory
+ * @return path of the new directory
+ */
+std::string
+createBenchDir(const std::string & parent,
+               const char * prefix) throw(svn::ClientException);
+
+
+/**
+ * Generates a file:// repository and a working copy
+ * of a given @ref BenchShape for the benchmarks.
+ */
+class BenchRepository
+{
+public:
+  /**
+   * @param dir directory that receives the repository
+   *            ("repos") and the working copy ("wc").
+   *            Both must not exist yet.
+   * @param shape shape of the tree to create
+   */
+  BenchRepository(const std::string & dir, const BenchShape & shape);
+
+  /**
+   * creates the repository with its history, checks out
+   * the working copy and applies the local changes
+   *
+   * @param context context used for the checkout
+   */
+  void
+  create(svn::Context * context) throw(svn::ClientException);
+
+  /** @return the file:// url of the repository root */
+  const std::string &
+  url() const;
+
+  /** @return path of the working copy */
+  const std::string &
+  wcPath() const;
+
+  /** @return paths of the versioned files, relative to the root */
+  const std::vector<std::string> &
+  files() const;
+
+  /** @return relative path of the file with the most changes */
+  const std::string &
+  busiestFile() const;
+
+  /** @return number of files modified in the working copy */
+  long
+  modifiedCount() const;
+
+  /** @return number of unversioned files in the working copy */
+  long
+  unversionedCount() const;
+
+private:
+  std::string m_dir;
+  std::string m_reposPath;
+  std::string m_url;
+  std::string m_wcPath;
+  BenchShape m_shape;
+  std::vector<std::string> m_dirs;
+  std::vector<std::string> m_files;
+  std::string m_busiestFile;
+  long m_modifiedCount;
+  long m_unversionedCount;
+
+  void
+  collectPaths(const std::string & dir, int level);
+
+  void
+  createRepository() throw(svn::ClientException);
+
+  void
+  changeWorkingCopy() throw(svn::ClientException);
+};
+
+#endif
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
@@ -0,0 +1,228 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+
+// app
+#include "client_add_test.hpp"
+
+// ansi c lib
+#include <cstdio>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Apache Portable Runtime
+#include "apr_file_io.h"
+#include "apr_hash.h"
+#include "apr_time.h"
+
+// subversion api
+#include "svn_fs.h"
+#include "svn_io.h"
+#include "svn_path.h"
+#include "svn_repos.h"
+
+//svncpp
+#include "svncpp/client.hpp"
+#include "svncpp/context.hpp"
+#include "svncpp/exception.hpp"
+#include "svncpp/path.hpp"
+#include "svncpp/pool.hpp"
+#include "svncpp/revision.hpp"
+#include "svncpp/targets.hpp"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ClientAddTestCase);
+
+/** the configuration used by the tests: auto-props for *.sh */
+static const char CONFIG [] =
+  "[miscellany]\n"
+  "enable-auto-props = yes\n"
+  "[auto-props]\n"
+  "*.sh = svn:eol-style=native; svn:keywords = Id\n";
+
+static void
+throwOnError(svn_error_t * error)
+{
+  if (error != 0)
+    throw svn::ClientException(error);
+}
+
+static void
+writeFile(const std::string & path, const char * contents, size_t length)
+{
+  svn::Path native(path);
+  FILE * file = fopen(native.native().c_str(), "wb");
+  CPPUNIT_ASSERT(file != 0);
+
+  fwrite(contents, 1, length, file);
+  fclose(file);
+}
+
+static void
+makeDir(const std::string & path)
+{
+  svn::Pool pool;
+  CPPUNIT_ASSERT(apr_dir_make_recursive(path.c_str(), APR_OS_DEFAULT,
+                                        pool) == APR_SUCCESS);
+}
+
+void
+ClientAddTestCase::setUp()
+{
+  svn::Pool pool;
+
+  // a directory of our own, nothing else is ever removed
+  char name[64];
+  sprintf(name, "svncpp_add_test_%" APR_TIME_T_FMT, apr_time_now());
+  svn::Path dir(svn::Path::getTempDir());
+  dir.addComponent(name);
+
+  m_dir = dir.path();
+  m_configDir = m_dir + "/config";
+  m_wcPath = m_dir + "/wc";
+  std::string reposPath(m_dir + "/repos");
+
+  makeDir(m_configDir);
+  writeFile(m_configDir + "/config", CONFIG, sizeof(CONFIG) - 1);
+
+  apr_hash_t * fsConfig = apr_hash_make(pool);
+  apr_hash_set(fsConfig, SVN_FS_CONFIG_FS_TYPE,
+               APR_HASH_KEY_STRING, SVN_FS_TYPE_FSFS);
+
+  svn_repos_t * repos;
+  throwOnError(svn_repos_create(&repos, reposPath.c_str(), NULL, NULL,
+                                NULL, fsConfig, pool));
+
+  const char * absolute;
+  throwOnError(svn_path_get_absolute(&absolute, reposPath.c_str(), pool));
+
+  std::string url("file://");
+  if (absolute[0] != '/')
+    url += "/";
+  url += svn_path_uri_encode(absolute, pool);
+
+  svn::Context context(m_configDir);
+  svn::Client client(&context);
+  client.checkout(url.c_str(), m_wcPath, svn::Revision::HEAD, true);
+}
+
+void
+ClientAddTestCase::tearDown()
+{
+  svn::Pool pool;
+  svn_error_clear(svn_io_remove_dir2(m_dir.c_str(), TRUE, NULL, NULL, pool));
+}
+
+std::string
+ClientAddTestCase::propget(const char * name, const std::string & path)
+{
+  svn::Context context(m_configDir);
+  svn::Client client(&context);
+
+  svn::PathPropertiesMapList props =
+    client.propget(name, path, svn::Revision::WORKING);
+
+  if (props.empty())
+    return "";
+
+  return props[0].second[name];
+}
+
+void
+ClientAddTestCase::testAddExecutable()
+{
+  svn::Pool pool;
+  std::string path(m_wcPath + "/script.sh");
+  writeFile(path, "#!/bin/sh\n", 10);
+  throwOnError(svn_io_set_file_executable(path.c_str(), TRUE, FALSE, pool));
+
+  svn::Context context(m_configDir);
+  svn::Client client(&context);
+  client.add(svn::Targets(path.c_str()), false);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("native"), propget("svn:eol-style", path));
+  CPPUNIT_ASSERT_EQUAL(std::string("Id"), propget("svn:keywords", path));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), propget("svn:mime-type", path));
+#ifndef _WIN32
+  CPPUNIT_ASSERT_EQUAL(std::string("*"), propget("svn:executable", path));
+#endif
+}
+
+void
+ClientAddTestCase::testAddBinary()
+{
+  std::string path(m_wcPath + "/data.bin");
+  writeFile(path, "\0\1\2\3\377binary\0", 12);
+
+  svn::Context context(m_configDir);
+  svn::Client client(&context);
+  client.add(svn::Targets(path.c_str()), false);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("application/octet-stream"),
+                       propget("svn:mime-type", path));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), propget("svn:eol-style", path));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), propget("svn:executable", path));
+}
+
+void
+ClientAddTestCase::testAddRecursive()
+{
+  std::string dir(m_wcPath + "/sub/deeper");
+  makeDir(dir);
+  writeFile(dir + "/run.sh", "echo\n", 5);
+  writeFile(dir + "/image.bin", "\0\1\2\3", 4);
+
+  svn::Context context(m_configDir);
+  svn::Client client(&context);
+  client.add(svn::Targets((m_wcPath + "/sub").c_str()), true);
+
+  CPPUNIT_ASSERT_EQUAL(std::string("native"),
+                       propget("svn:eol-style", dir + "/run.sh"));
+  CPPUNIT_ASSERT_EQUAL(std::string("application/octet-stream"),
+                       propget("svn:mime-type", dir + "/image.bin"));
+}
+
+void
+ClientAddTestCase::testAddSymlink()
+{
+#ifndef _WIN32
+  std::string path(m_wcPath + "/link.sh");
+  writeFile(m_wcPath + "/target.txt", "text\n", 5);
+  CPPUNIT_ASSERT(symlink("target.txt", path.c_str()) == 0);
+
+  svn::Context context(m_configDir);
+  svn::Client client(&context);
+  client.add(svn::Targets(path.c_str()), false);
+
+  // symlinks get no auto-props
+  CPPUNIT_ASSERT_EQUAL(std::string("*"), propget("svn:special", path));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), propget("svn:eol-style", path));
+#endif
+}
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
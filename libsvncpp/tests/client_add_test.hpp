@@ -0,0 +1,67 @@
+/*
+ * ====================================================================
+ * Copyright (c) 2002-2012 The RapidSVN Group.  All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program (in the file GPL.txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://rapidsvn.tigris.org/.
+ * ====================================================================
+ */
+#include "cppunit/TestCase.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+// stl
+#include "svncpp/string_wrapper.hpp"
+
+/**
+ * Checks that svn::Client::add sets the same properties
+ * as svn_client_add: auto-props, svn:mime-type,
+ * svn:executable and svn:special
+ */
+class ClientAddTestCase : public CppUnit::TestCase
+{
+  CPPUNIT_TEST_SUITE(ClientAddTestCase);
+  CPPUNIT_TEST(testAddExecutable);
+  CPPUNIT_TEST(testAddBinary);
+  CPPUNIT_TEST(testAddRecursive);
+  CPPUNIT_TEST(testAddSymlink);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+protected:
+  void testAddExecutable();
+  void testAddBinary();
+  void testAddRecursive();
+  void testAddSymlink();
+
+private:
+  std::string m_dir;
+  std::string m_configDir;
+  std::string m_wcPath;
+
+  std::string
+  propget(const char * name, const std::string & path);
+};
+
+/* -----------------------------------------------------------------
+ * local variables:
+ * eval: (load-file "../../rapidsvn-dev.el")
+ * end:
+ */
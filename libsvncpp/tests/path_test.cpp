@@ -29,12 +29,38 @@
 #include <cstring>
 #include <stdio.h>
 
+// subversion api
+#include "svn_path.h"
 
 //svncpp
 #include "svncpp/path.hpp"
+#include "svncpp/pool.hpp"
+#include "svncpp/url.hpp"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PathTestCase);
 
+/**
+ * paths for testPathMatchesSvn
+ */
+static const char * PATHS [] =
+{
+  "",
+  "/",
+  "/some/path/to/repository",
+  "relative/path/file.txt",
+  ".hidden/..dots/file.",
+  "/trailing/slash/",
+  "/double//slash",
+  "./dot/./segments/.",
+  "//server/share",
+  "http://this.is/a/url",
+  "http://this.is/a/url/",
+  "HTTP://This.Is/a/url",
+  "file:///this.is/a/url",
+  "svn+ssh://host/repos/trunk//dir",
+  0
+};
+
 void
 PathTestCase::setUp()
 {
@@ -231,6 +257,24 @@ PathTestCase::testGetTempDir()
   fclose(f);
 }
 
+void
+PathTestCase::testPathMatchesSvn()
+{
+  svn::Pool pool;
+
+  for (const char ** path = PATHS; *path != 0; path++)
+  {
+    svn::Path p(*path);
+    CPPUNIT_ASSERT_EQUAL(std::string(svn_path_internal_style(*path, pool)),
+                         p.path());
+    CPPUNIT_ASSERT(p.isUrl() == svn::Url::isValid(p.c_str()));
+
+    svn::Path copy(p);
+    CPPUNIT_ASSERT_EQUAL(p.path(), copy.path());
+    CPPUNIT_ASSERT(p.isUrl() == copy.isUrl());
+  }
+}
+
 
 /* -----------------------------------------------------------------
  * local variables:
@@ -39,6 +39,7 @@ class PathTestCase : public CppUnit::TestCase
   CPPUNIT_TEST(testUnescape);
   CPPUNIT_TEST(testLength);
   CPPUNIT_TEST(testGetTempDir);
+  CPPUNIT_TEST(testPathMatchesSvn);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -54,6 +55,7 @@ protected:
   void testUnescape();
   void testLength();
   void testGetTempDir();
+  void testPathMatchesSvn();
 };
 
 /* -----------------------------------------------------------------
@@ -26,11 +26,65 @@
 #include "url_test.hpp"
 #include "svncpp/string_wrapper.hpp"
 
+// subversion api
+#include "svn_path.h"
+
 //svncpp
+#include "svncpp/pool.hpp"
 #include "svncpp/url.hpp"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(UrlTestCase);
 
+/**
+ * urls for testEscapeMatchesSvn and testUnescapeMatchesSvn
+ */
+static const char * URLS [] =
+{
+  "",
+  "http://tigris.org/xyz.php",
+  "http://tigris.org/x y z.html",
+  "http://foo/\"#%;<>?[\\]^`{|} ",
+  "file:///local/file/%41lready%20escaped",
+  "http://host/\x01\x7f\xc3\xa4\xff",
+  "http://host/query?a=b+c&d=%2B",
+  "http://host/broken/%4/%zz/%",
+  0
+};
+
+/**
+ * the implementation of svn::Url::escape before it got
+ * its own table
+ */
+static std::string
+svnEscape(const char * url, apr_pool_t * pool)
+{
+  std::string result;
+  for (const char * c = url; *c != 0; c++)
+  {
+    if (*c == '%')
+      result += "%25";
+    else
+      result += *c;
+  }
+
+  result = svn_path_uri_autoescape(result.c_str(), pool);
+
+  std::string escaped;
+  for (size_t i = 0; i < result.length(); i++)
+  {
+    switch (result[i])
+    {
+    case '#': escaped += "%23"; break;
+    case ';': escaped += "%3B"; break;
+    case '?': escaped += "%3F"; break;
+    case '[': escaped += "%5B"; break;
+    case ']': escaped += "%5D"; break;
+    default: escaped += result[i];
+    }
+  }
+  return escaped;
+}
+
 void
 UrlTestCase::setUp()
 {
@@ -107,6 +161,35 @@ UrlTestCase::testUnescape()
   CPPUNIT_ASSERT("http://foo/%22%23%25%3B%3C%3E%3F%5B%5C%5D%5E%60%7B%7C%7D%20" == svn::Url::escape("http://foo/\"#%;<>?[\\]^`{|} "));
 }
 
+void
+UrlTestCase::testEscapeMatchesSvn()
+{
+  svn::Pool pool;
+
+  for (const char ** url = URLS; *url != 0; url++)
+    CPPUNIT_ASSERT_EQUAL(svnEscape(*url, pool), svn::Url::escape(*url));
+}
+
+void
+UrlTestCase::testUnescapeMatchesSvn()
+{
+  svn::Pool pool;
+
+  for (const char ** url = URLS; *url != 0; url++)
+  {
+    CPPUNIT_ASSERT_EQUAL(std::string(svn_path_uri_decode(*url, pool)),
+                         svn::Url::unescape(*url));
+
+    std::string escaped(svn::Url::escape(*url));
+    CPPUNIT_ASSERT_EQUAL(std::string(svn_path_uri_decode(escaped.c_str(), pool)),
+                         svn::Url::unescape(escaped.c_str()));
+  }
+
+  const char * special = "http://svn.example.org/repos/my project/#1/file [old].cpp";
+  CPPUNIT_ASSERT_EQUAL(std::string(special),
+                       svn::Url::unescape(svn::Url::escape(special).c_str()));
+}
+
 
 /* -----------------------------------------------------------------
  * local variables:
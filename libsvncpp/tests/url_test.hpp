@@ -33,6 +33,8 @@ class UrlTestCase : public CppUnit::TestCase
   CPPUNIT_TEST(testIsValid);
   CPPUNIT_TEST(testEscape);
   CPPUNIT_TEST(testUnescape);
+  CPPUNIT_TEST(testEscapeMatchesSvn);
+  CPPUNIT_TEST(testUnescapeMatchesSvn);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -42,6 +44,8 @@ protected:
   void testIsValid();
   void testEscape();
   void testUnescape();
+  void testEscapeMatchesSvn();
+  void testUnescapeMatchesSvn();
 };
 
 /* -----------------------------------------------------------------
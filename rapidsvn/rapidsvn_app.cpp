@@ -25,6 +25,7 @@
 // wxWidgets
 #include "wx/wx.h"
 #include "wx/confbase.h"
+#include "wx/filename.h"
 #include "wx/stdpaths.h"
 #include "wx/sysopt.h"
 #include <wx/fs_zip.h> // ZIP filesystem support
@@ -33,6 +34,8 @@
 #include <wx/image.h>
 
 // svncpp
+#include "svncpp/trace.hpp"
+#include "svncpp/url.hpp"
 #include "svncpp/wc.hpp"
 
 //app
@@ -41,6 +44,9 @@
 #include "main_frame.hpp"
 #include "preferences.hpp"
 #include "rapidsvn_app.hpp"
+#include "single_instance.hpp"
+#include "stall_watchdog.hpp"
+#include "utils.hpp"
 #include "version.hpp"
 
 static const wxChar HELP_FILE[] =  wxT("/Resources/HelpFile");
@@ -53,6 +59,11 @@ static const wxChar TIPS_LAST_INDEX[] = wxT("/Main/TipsLastIndex");
 
 IMPLEMENT_APP(RapidSvnApp)
 
+RapidSvnApp::RapidSvnApp()
+    : m_singleInstance(0)
+{
+}
+
 bool RapidSvnApp::OnInit()
 {
   // application and vendor name are used by wxConfig to construct the name
@@ -62,6 +73,21 @@ bool RapidSvnApp::OnInit()
   SetVendorName(APPLICATION_NAME);
   SetAppName(APPLICATION_NAME);
 
+  // if RapidSVN is running already, hand the path over
+  // and exit before doing any expensive initialization
+  wxString path = GetPathArgument();
+  if (Preferences().singleInstance)
+  {
+    m_singleInstance = new SingleInstance();
+    if (m_singleInstance->Forward(path))
+    {
+      delete m_singleInstance;
+      m_singleInstance = 0;
+      delete wxConfigBase::Set((wxConfigBase *) NULL);
+      return FALSE;
+    }
+  }
+
   m_locale.Init();
   m_locale.AddCatalogLookupPathPrefix(wxT("locale"));
 #ifdef __WXMAC__
@@ -109,6 +135,12 @@ bool RapidSvnApp::OnInit()
   frame->Show(TRUE);
   SetTopWindow(frame);
 
+  if (!path.IsEmpty())
+    frame->OpenPath(path);
+
+  if (m_singleInstance)
+    m_singleInstance->Listen();
+
   // Show tips if configured
 #ifdef USE_STARTUP_TIPS
   wxTipProvider* tipProvider = MakeTipProvider();
@@ -128,6 +160,9 @@ RapidSvnApp::OnExit()
 {
   OptionallyPurgeTempFiles();
 
+  delete m_singleInstance;
+  m_singleInstance = 0;
+
   TheHistoryManager.Cleanup();
 
   // destroy application configuration object
@@ -142,6 +177,53 @@ RapidSvnApp::OnExit()
   return 0;
 }
 
+#if wxUSE_EXCEPTIONS
+void
+RapidSvnApp::HandleEvent(wxEvtHandler * handler,
+                         wxEventFunction func,
+                         wxEvent & event) const
+{
+  StallWatchdog::Scope scope(handler, event);
+
+  if (!svn::Trace::isEnabled())
+  {
+    wxApp::HandleEvent(handler, func, event);
+    return;
+  }
+
+  wxString name;
+  name.Printf(wxT("%s: event %d, id %d"),
+              handler->GetClassInfo()->GetClassName(),
+              (int)event.GetEventType(), event.GetId());
+
+  svn::TraceSpan span("gui", LocalToUtf8(name));
+  wxApp::HandleEvent(handler, func, event);
+}
+#endif
+
+wxString
+RapidSvnApp::GetPathArgument() const
+{
+  if (argc < 2)
+    return wxEmptyString;
+
+  wxString path(argv[1]);
+  if (svn::Url::isValid(LocalToUtf8(path).c_str()))
+    return path;
+
+  wxFileName fileName;
+  if (wxDirExists(path))
+    fileName.AssignDir(path);
+  else
+    fileName.Assign(path);
+  fileName.MakeAbsolute();
+
+  if (fileName.IsDir())
+    return fileName.GetPath();
+
+  return fileName.GetFullPath();
+}
+
 void
 RapidSvnApp::OptionallyRegisterTempFile(const wxString & filename)
 {